@@ -0,0 +1,31 @@
+from pathlib import Path
+from typing import Optional
+
+
+class ApduTrace:
+    """
+    Recorder of the APDUs sent to the app, to be replayed on the host (see tests/bench)
+
+    The trace is saved in the text format of the benchmark corpus: one hex-encoded APDU per line,
+    header included, and lines starting with '#' as comments.
+    """
+    # Recorder used by the clients created without an explicit one
+    active: Optional["ApduTrace"] = None
+
+    def __init__(self, comment: Optional[str] = None) -> None:
+        self.comment = comment
+        self.apdus: list[bytes] = []
+
+    def record(self, apdu: bytes) -> None:
+        self.apdus.append(bytes(apdu))
+
+    def clear(self) -> None:
+        self.apdus.clear()
+
+    def save(self, path: Path) -> None:
+        path.parent.mkdir(parents=True, exist_ok=True)
+        with open(path, "w", encoding="utf-8") as out:
+            if self.comment:
+                print(f"# {self.comment}", file=out)
+            for apdu in self.apdus:
+                print(apdu.hex(), file=out)
@@ -7,10 +7,11 @@ from eth_utils import keccak
 from ragger.backend import BackendInterface
 from ragger.utils import RAPDU
 
+from .apdu_trace import ApduTrace
 from .command_builder import CommandBuilder
 from .eip712 import EIP712FieldType
 from .keychain import sign_data, Key
-from .response_parser import pk_addr
+from .response_parser import pk_addr, syscall_stats, syscall_sites, phase_events
 from .tx_simu import TxSimu
 from .tx_auth_7702 import TxAuth7702
 from .status_word import StatusWord
@@ -18,7 +19,7 @@ from .ledger_pki import PKIClient, PKIPubKeyUsage
 from .dynamic_networks import DynamicNetwork
 from .safe import SafeAccount, AccountType
 from .gating import Gating
-from .trusted_name import TrustedName, TrustedNameSource
+from .trusted_name import TrustedName, TrustedNames, TrustedNameSource
 
 
 class EIP712CalldataParamPresence(IntEnum):
@@ -34,16 +35,21 @@ class SignMode(IntEnum):
 
 
 class EthAppClient:
-    def __init__(self, backend: BackendInterface):
+    def __init__(self, backend: BackendInterface, trace: Optional[ApduTrace] = None):
         self._backend = backend
         self.device = backend.device
         self._cmd_builder = CommandBuilder()
-        self.pki_client = PKIClient(self._backend)
+        self._trace = trace if trace is not None else ApduTrace.active
+        self.pki_client = PKIClient(self._backend, self._trace)
 
     def _exchange_async(self, payload: bytes):
+        if self._trace is not None:
+            self._trace.record(payload)
         return self._backend.exchange_async_raw(payload)
 
     def _exchange(self, payload: bytes) -> RAPDU:
+        if self._trace is not None:
+            self._trace.record(payload)
         return self._backend.exchange_raw(payload)
 
     def response(self) -> Optional[RAPDU]:
@@ -73,6 +79,9 @@ class EthAppClient:
     def eip712_send_struct_def_struct_name(self, name: str):
         return self._exchange_async(self._cmd_builder.eip712_send_struct_def_struct_name(name))
 
+    def eip712_send_struct_def_cached_schema(self, schema_hash: bytes):
+        return self._exchange(self._cmd_builder.eip712_send_struct_def_cached_schema(schema_hash))
+
     def eip712_send_struct_def_struct_field(self,
                                             field_type: EIP712FieldType,
                                             type_name: str,
@@ -260,7 +269,7 @@ class EthAppClient:
                                                                           bip32_path,
                                                                           pubkey))
 
-    def provide_trusted_name(self, trusted_name: TrustedName) -> RAPDU:
+    def provide_trusted_name(self, trusted_name: TrustedName | TrustedNames) -> RAPDU:
         self.pki_client.send_certificate(PKIPubKeyUsage.PUBKEY_USAGE_TRUSTED_NAME,
                                          trusted_name.tn_source == TrustedNameSource.CAL)
 
@@ -408,6 +417,9 @@ class EthAppClient:
         response = self._exchange(chunks[-1])
         assert response.status == StatusWord.OK
 
+    def clear_network_registry(self, chain_id: Optional[int] = None) -> RAPDU:
+        return self._exchange(self._cmd_builder.clear_network_registry(chain_id))
+
     def provide_enum_value(self, payload: bytes) -> RAPDU:
         # Send ledgerPKI certificate
         self.pki_client.send_certificate(PKIPubKeyUsage.PUBKEY_USAGE_CALLDATA)
@@ -432,6 +444,12 @@ class EthAppClient:
             self._exchange(chunk)
         return self._exchange(chunks[-1])
 
+    def provide_transaction_fields_desc_batch(self, payload: bytes) -> RAPDU:
+        chunks = self._cmd_builder.provide_transaction_fields_desc_batch(payload)
+        for chunk in chunks[:-1]:
+            self._exchange(chunk)
+        return self._exchange(chunks[-1])
+
     def opt_in_tx_simulation(self):
         return self._exchange_async(self._cmd_builder.opt_in_tx_simulation())
 
@@ -485,3 +503,46 @@ class EthAppClient:
         for chunk in chunks[:-1]:
             self._exchange(chunk)
         return self._exchange(chunks[-1])
+
+    def get_syscall_stats(self) -> dict:
+        """
+        Get the syscalls counted during the last flow, only on SYSCALL_STATS debug builds
+
+        Returns {"totals": [(calls, bytes), ...], "sites": [(kind, file, line, calls, bytes), ...]}
+        with one total per kind of syscall, in the order of src/syscall_stats.h
+        """
+        response = self._exchange(self._cmd_builder.get_debug_stats(0x00, 0x00))
+        assert response.status == StatusWord.OK
+        totals, sites_count = syscall_stats(response.data)
+        sites: list = []
+        while len(sites) < sites_count:
+            response = self._exchange(self._cmd_builder.get_debug_stats(0x00, len(sites) + 1))
+            assert response.status == StatusWord.OK
+            sites += syscall_sites(response.data)
+        return {"totals": totals, "sites": sites}
+
+    def get_phase_trace(self) -> list[tuple[int, int, int, int]]:
+        """
+        Get the kept phase events, only on PHASE_TRACE debug builds
+
+        Returns [(tick_us, phase, edge, arg), ...] from the oldest event, with the phases in the
+        order of src/phase_trace.h
+        """
+        events: list = []
+        while True:
+            response = self._exchange(self._cmd_builder.get_debug_stats(0x01, len(events)))
+            assert response.status == StatusWord.OK
+            chunk = phase_events(response.data)
+            if len(chunk) == 0:
+                break
+            events += chunk
+        return events
+
+    def clear_phase_trace(self) -> RAPDU:
+        return self._exchange(self._cmd_builder.get_debug_stats(0x02, 0x00))
+
+    def set_arena_cap(self, cap: int) -> RAPDU:
+        """
+        Cap the usable size of the app memory buffer (0 to remove it), only on ARENA_CAP debug builds
+        """
+        return self._exchange(self._cmd_builder.get_debug_stats(0x03, 0x00, cap.to_bytes(2, "big")))
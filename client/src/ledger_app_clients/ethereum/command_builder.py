@@ -36,6 +36,7 @@ class InsType(IntEnum):
     SIGN_EIP7702_AUTHORIZATION = 0x34
     PROVIDE_SAFE_ACCOUNT = 0x36
     PROVIDE_GATING = 0x38
+    DEBUG_STATS = 0x3a
 
 
 class P1Type(IntEnum):
@@ -50,6 +51,7 @@ class P1Type(IntEnum):
 
 class P2Type(IntEnum):
     STRUCT_NAME = 0x00
+    STRUCT_CACHED_SCHEMA = 0x0f
     STRUCT_FIELD = 0xff
     ARRAY = 0x0f
     LEGACY_IMPLEM = 0x00
@@ -71,9 +73,12 @@ class P2Type(IntEnum):
     FILTERING_RAW = 0xff
     NETWORK_CONFIG = 0x00
     NETWORK_ICON = 0x01
+    NETWORK_CLEAR_REGISTRY = 0x03
     SIGN_PROCESS_START = 0x00
     SIGN_STORE = 0x01
     SIGN_START = 0x02
+    FIELD_SINGLE = 0x00
+    FIELD_BATCH = 0x01
 
 
 class CommandBuilder:
@@ -104,6 +109,12 @@ class CommandBuilder:
                                P2Type.STRUCT_NAME,
                                name.encode())
 
+    def eip712_send_struct_def_cached_schema(self, schema_hash: bytes) -> bytes:
+        return self._serialize(InsType.EIP712_SEND_STRUCT_DEF,
+                               P1Type.COMPLETE_SEND,
+                               P2Type.STRUCT_CACHED_SCHEMA,
+                               schema_hash)
+
     def get_app_configuration(self) -> bytes:
         return self._serialize(InsType.GET_APP_CONFIGURATION,
                                0x00,
@@ -584,6 +595,13 @@ class CommandBuilder:
                 p1 = P1Type.FOLLOWING_CHUNK
         return chunks
 
+    def clear_network_registry(self, chain_id: Optional[int] = None) -> bytes:
+        payload = bytes() if chain_id is None else struct.pack(">Q", chain_id)
+        return self._serialize(InsType.PROVIDE_NETWORK_INFORMATION,
+                               0x00,
+                               P2Type.NETWORK_CLEAR_REGISTRY,
+                               payload)
+
     def sign_eip7702_authorization(self, bip32_path: str, tlv_payload: bytes) -> list[bytes]:
         return self.common_tlv_serialize(InsType.SIGN_EIP7702_AUTHORIZATION,
                                          tlv_payload,
@@ -598,6 +616,11 @@ class CommandBuilder:
     def provide_transaction_field_desc(self, tlv_payload: bytes) -> list[bytes]:
         return self.common_tlv_serialize(InsType.PROVIDE_TRANSACTION_FIELD_DESC, tlv_payload)
 
+    def provide_transaction_fields_desc_batch(self, tlv_payload: bytes) -> list[bytes]:
+        return self.common_tlv_serialize(InsType.PROVIDE_TRANSACTION_FIELD_DESC,
+                                         tlv_payload,
+                                         p2l=[P2Type.FIELD_BATCH])
+
     def opt_in_tx_simulation(self) -> bytes:
         # Serialize the payload
         return self._serialize(InsType.PROVIDE_TX_SIMULATION, P1Type.OPT_IN_TX_CHECK, 0x00)
@@ -613,3 +636,6 @@ class CommandBuilder:
 
     def provide_gating(self, tlv_payload: bytes) -> list[bytes]:
         return self.common_tlv_serialize(InsType.PROVIDE_GATING, tlv_payload)
+
+    def get_debug_stats(self, p1: int, p2: int, cdata: bytes = bytes()) -> bytes:
+        return self._serialize(InsType.DEBUG_STATS, p1, p2, cdata)
@@ -6,6 +6,7 @@ from typing import Any, Optional, Union, Callable
 import struct
 import functools
 
+from ragger.error import ExceptionRAPDU
 from client import keychain
 from client.client import EthAppClient, EIP712FieldType
 from client.ledger_pki import PKIPubKeyUsage
@@ -94,7 +95,7 @@ parsing_type_functions["string"] = parse_string
 parsing_type_functions["bytes"] = parse_bytes
 
 
-def send_struct_def_field(typename, keyname):
+def parse_struct_def_field(typename):
     type_enum = None
 
     (typename, array_lvls) = get_array_levels(typename)
@@ -106,6 +107,12 @@ def send_struct_def_field(typename, keyname):
         type_enum = EIP712FieldType.CUSTOM
         typesize = None
 
+    return (typename, type_enum, typesize, array_lvls)
+
+
+def send_struct_def_field(typename, keyname):
+    (typename, type_enum, typesize, array_lvls) = parse_struct_def_field(typename)
+
     with app_client.eip712_send_struct_def_struct_field(type_enum,
                                                         typename,
                                                         typesize,
@@ -579,7 +586,10 @@ def init_signature_context(sig_ctx, types, domain, filters):
     for i in range(8):
         sig_ctx["chainid"].append(chainid & (0xff << (i * 8)))
     sig_ctx["chainid"].reverse()
+    sig_ctx["schema_hash"] = get_schema_hash(types)
 
+
+def get_schema_hash(types) -> bytearray:
     # Order type fields
     for type_name in types.keys():
         for i in range(len(types[type_name])):
@@ -587,12 +597,37 @@ def init_signature_context(sig_ctx, types, domain, filters):
 
     schema_str = json.dumps(types).replace(" ", "")
     schema_hash = hashlib.sha224(schema_str.encode())
-    sig_ctx["schema_hash"] = bytearray.fromhex(schema_hash.hexdigest())
+    return bytearray.fromhex(schema_hash.hexdigest())
+
+
+def send_cached_schema(schema_hash: bytes) -> bool:
+    try:
+        app_client.eip712_send_struct_def_cached_schema(schema_hash)
+    except ExceptionRAPDU as err:
+        # not cached (yet), or not supported by this app version
+        assert err.status in (StatusWord.REF_DATA_NOT_FOUND, StatusWord.INVALID_P1_P2), \
+            f"Error sending cached schema: {err.status}"
+        return False
+    return True
+
+
+def send_struct_def(types):
+    for key in types.keys():
+        with app_client.eip712_send_struct_def_struct_name(key):
+            pass
+        response = app_client.response()
+        assert response.status == StatusWord.OK, \
+            f"Error sending struct def {key}: {response.status}"
+        for f in types[key]:
+            (f["type"], f["enum"], f["typesize"], f["array_lvls"]) = \
+             send_struct_def_field(f["type"], f["name"])
 
 
 def process_data(aclient: EthAppClient,
                  data_json: dict,
-                 filters: Optional[dict] = None) -> None:
+                 filters: Optional[dict] = None,
+                 use_schema_cache: bool = True,
+                 schema_cached: bool = False) -> None:
     global app_client
     global current_path
 
@@ -609,16 +644,15 @@ def process_data(aclient: EthAppClient,
     if filters:
         init_signature_context(sig_ctx, types, domain, filters)
 
-    # send types definition
-    for key in types.keys():
-        with app_client.eip712_send_struct_def_struct_name(key):
-            pass
-        response = app_client.response()
-        assert response.status == StatusWord.OK, \
-            f"Error sending struct def {key}: {response.status}"
-        for f in types[key]:
-            (f["type"], f["enum"], f["typesize"], f["array_lvls"]) = \
-             send_struct_def_field(f["type"], f["name"])
+    # schema_cached: the caller already loaded the cached schema
+    if schema_cached or (use_schema_cache and send_cached_schema(get_schema_hash(types))):
+        # the app already knows the types definition
+        for key in types.keys():
+            for f in types[key]:
+                (f["type"], f["enum"], f["typesize"], f["array_lvls"]) = \
+                 parse_struct_def_field(f["type"])
+    else:
+        send_struct_def(types)
 
     if filters:
         with app_client.eip712_filtering_activate():
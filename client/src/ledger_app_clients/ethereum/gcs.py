@@ -19,6 +19,7 @@ class TxInfoTag(IntEnum):
     CREATOR_URL = 0x08
     CONTRACT_NAME = 0x09
     DEPLOY_DATE = 0x0a
+    FIELDS_COUNT = 0x0b
     SIGNATURE = 0xff
 
 
@@ -34,6 +35,7 @@ class TxInfo(TlvSerializable):
     creator_url: Optional[str]
     contract_name: Optional[str]
     deploy_date: Optional[int]
+    fields_count: Optional[int]
     signature: Optional[bytes]
 
     def __init__(self,
@@ -48,6 +50,7 @@ class TxInfo(TlvSerializable):
                  creator_url: Optional[str] = None,
                  contract_name: Optional[str] = None,
                  deploy_date: Optional[int] = None,
+                 fields_count: Optional[int] = None,
                  signature: Optional[bytes] = None):
         self.version = version
         self.chain_id = chain_id
@@ -60,6 +63,7 @@ class TxInfo(TlvSerializable):
         self.creator_url = creator_url
         self.contract_name = contract_name
         self.deploy_date = deploy_date
+        self.fields_count = fields_count
         self.signature = signature
 
     def serialize(self) -> bytes:
@@ -80,6 +84,8 @@ class TxInfo(TlvSerializable):
             payload += self.serialize_field(TxInfoTag.CONTRACT_NAME, self.contract_name)
         if self.deploy_date is not None:
             payload += self.serialize_field(TxInfoTag.DEPLOY_DATE, self.deploy_date)
+        if self.fields_count is not None:
+            payload += self.serialize_field(TxInfoTag.FIELDS_COUNT, self.fields_count)
         signature = self.signature
         if signature is None:
             signature = sign_data(Key.CALLDATA, payload)
@@ -606,3 +612,20 @@ class Field(TlvSerializable):
             for constraint in self.constraints:
                 payload += self.serialize_field(0x05, constraint)
         return payload
+
+
+class FieldsBatchTag(IntEnum):
+    FIELD = 0x01
+
+
+class FieldsBatch(TlvSerializable):
+    fields: list[Field]
+
+    def __init__(self, fields: list[Field]):
+        self.fields = fields
+
+    def serialize(self) -> bytes:
+        payload = bytearray()
+        for field in self.fields:
+            payload += self.serialize_field(FieldsBatchTag.FIELD, field.serialize())
+        return payload
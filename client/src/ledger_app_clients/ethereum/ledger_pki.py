@@ -1,10 +1,12 @@
 from enum import IntEnum
+from typing import Optional
 
 from ledgered.devices import DeviceType
 
 from ragger.backend import BackendInterface, SpeculosBackend
 from ragger.utils import RAPDU
 
+from .apdu_trace import ApduTrace
 from .status_word import StatusWord
 
 
@@ -163,8 +165,9 @@ class PKIClient:
     _CLA: int = 0xB0
     _INS: int = 0x06
 
-    def __init__(self, backend: BackendInterface) -> None:
+    def __init__(self, backend: BackendInterface, trace: Optional[ApduTrace] = None) -> None:
         self._backend = backend
+        self._trace = trace
 
     def send_certificate(self, key_usage: PKIPubKeyUsage, from_CAL: bool = False) -> None:
         if not isinstance(self._backend, SpeculosBackend):
@@ -188,4 +191,6 @@ class PKIClient:
         header.append(p1)
         header.append(0x00)
         header.append(len(payload))
+        if self._trace is not None:
+            self._trace.record(header + payload)
         return self._backend.exchange_raw(header + payload)
@@ -50,3 +50,41 @@ def pk_addr(data: bytes, has_chaincode: bool = False):
         return None
 
     return pk, bytes.fromhex(addr.decode()), chaincode
+
+
+def syscall_stats(data: bytes) -> tuple[list[tuple[int, int]], int]:
+    count = data[0]
+    assert len(data) == (1 + count * 8 + 2)
+    totals = []
+    for idx in range(1, 1 + count * 8, 8):
+        totals.append((int.from_bytes(data[idx:idx + 4], "big"),
+                       int.from_bytes(data[idx + 4:idx + 8], "big")))
+    return totals, data[-2]
+
+
+def syscall_sites(data: bytes) -> list[tuple[int, str, int, int, int]]:
+    sites = []
+    idx = 1
+    for _ in range(data[0]):
+        kind = data[idx]
+        line = int.from_bytes(data[idx + 1:idx + 3], "big")
+        calls = int.from_bytes(data[idx + 3:idx + 7], "big")
+        nbytes = int.from_bytes(data[idx + 7:idx + 11], "big")
+        file_len = data[idx + 11]
+        idx += 12
+        sites.append((kind, data[idx:idx + file_len].decode(), line, calls, nbytes))
+        idx += file_len
+    assert idx == len(data)
+    return sites
+
+
+def phase_events(data: bytes) -> list[tuple[int, int, int, int]]:
+    count = data[4]
+    assert len(data) == (4 + 1 + count * 8)
+    events = []
+    for idx in range(5, len(data), 8):
+        events.append((int.from_bytes(data[idx:idx + 4], "big"),
+                       data[idx + 6],
+                       data[idx + 7],
+                       int.from_bytes(data[idx + 4:idx + 6], "big")))
+    return events
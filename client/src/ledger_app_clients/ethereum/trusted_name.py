@@ -44,6 +44,7 @@ class Tag(IntEnum):
     NFT_ID = 0x72
     OWNER = 0x74
     OWNER_DERIV_PATH = 0x75
+    ENTRY = 0x76
 
 
 class TrustedName(TlvSerializable):
@@ -128,3 +129,102 @@ class TrustedName(TlvSerializable):
             sig = sign_data(key, payload)
         payload += self.serialize_field(Tag.SIGNATURE, sig)
         return payload
+
+
+class TrustedNameEntry(TlvSerializable):
+    name: str
+    address: bytes
+    chain_id: int
+    tn_type: TrustedNameType
+    tn_source: TrustedNameSource
+    nft_id: int | None
+
+    def __init__(
+        self,
+        address: bytes,
+        name: str,
+        tn_type: TrustedNameType,
+        tn_source: TrustedNameSource,
+        chain_id: int,
+        nft_id: int | None = None,
+    ) -> None:
+        self.address = address
+        self.name = name
+        self.tn_type = tn_type
+        self.tn_source = tn_source
+        self.chain_id = chain_id
+        self.nft_id = nft_id
+
+    def serialize(self) -> bytes:
+        payload = bytearray()
+        payload += self.serialize_field(Tag.TYPE, self.tn_type)
+        payload += self.serialize_field(Tag.SOURCE, self.tn_source)
+        payload += self.serialize_field(Tag.NAME, self.name)
+        payload += self.serialize_field(Tag.CHAIN_ID, self.chain_id)
+        payload += self.serialize_field(Tag.ADDRESS, self.address)
+        if self.nft_id is not None:
+            payload += self.serialize_field(Tag.NFT_ID, self.nft_id)
+        return payload
+
+
+class TrustedNames(TlvSerializable):
+    """
+    Several trusted names under a single signature (struct version 3)
+    """
+    entries: list[TrustedNameEntry]
+    not_valid_after: tuple[int, int, int] | None
+    challenge: bytes | None
+    owner: bytes | None
+    owner_deriv_path: str | None
+    signature: bytes | None
+
+    def __init__(
+        self,
+        entries: list[TrustedNameEntry],
+        not_valid_after: tuple[int, int, int] | None = None,
+        challenge: bytes | None = None,
+        owner: bytes | None = None,
+        owner_deriv_path: str | None = None,
+        signature: bytes | None = None,
+    ) -> None:
+        self.entries = entries
+        self.not_valid_after = not_valid_after
+        self.challenge = challenge
+        self.owner = owner
+        self.owner_deriv_path = owner_deriv_path
+        self.signature = signature
+
+    @property
+    def tn_source(self) -> TrustedNameSource | None:
+        # signed by the CAL only if all the names come from it
+        if all(entry.tn_source == TrustedNameSource.CAL for entry in self.entries):
+            return TrustedNameSource.CAL
+        return None
+
+    def serialize(self) -> bytes:
+        payload = bytearray()
+        payload += self.serialize_field(Tag.STRUCT_TYPE, 0x03)
+        payload += self.serialize_field(Tag.STRUCT_VERSION, 3)
+        if self.not_valid_after is not None:
+            payload += self.serialize_field(Tag.NOT_VALID_AFTER, struct.pack("BBB", *self.not_valid_after))
+        if self.challenge is not None:
+            payload += self.serialize_field(Tag.CHALLENGE, self.challenge)
+        if self.owner is not None:
+            payload += self.serialize_field(Tag.OWNER, self.owner)
+        if self.owner_deriv_path is not None:
+            payload += self.serialize_field(Tag.OWNER_DERIV_PATH, pack_derivation_path(self.owner_deriv_path))
+        for entry in self.entries:
+            payload += self.serialize_field(Tag.ENTRY, entry.serialize())
+        sig = self.signature
+        if self.tn_source == TrustedNameSource.CAL:
+            key_id = 9
+            key = Key.CAL
+        else:
+            key_id = 7
+            key = Key.TRUSTED_NAME
+        payload += self.serialize_field(Tag.SIG_KEY_ID, key_id)
+        payload += self.serialize_field(Tag.SIG_ALGO, 1)
+        if sig is None:
+            sig = sign_data(key, payload)
+        payload += self.serialize_field(Tag.SIGNATURE, sig)
+        return payload
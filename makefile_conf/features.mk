@@ -50,6 +50,20 @@ endif
 # Gating signing - TODO: Reactivate this once the feature is fully available E2E
 DEFINES	+= HAVE_GATING_SUPPORT
 
+# Number of token/NFT infos kept during a transaction
+ASSETS_CACHE_SIZE ?= 8
+DEFINES += MAX_ASSETS=$(ASSETS_CACHE_SIZE)
+
+# Number of EIP-712 schemas kept across signing sessions, 1KB of RAM reserved for each
+EIP712_SCHEMA_CACHE_SIZE ?= 2
+DEFINES += EIP712_SCHEMA_CACHE_SIZE=$(EIP712_SCHEMA_CACHE_SIZE)
+
+# Persist the verified dynamic networks in NVM
+NETWORK_REGISTRY ?= 0
+ifneq ($(NETWORK_REGISTRY),0)
+    DEFINES += HAVE_NETWORK_REGISTRY
+endif
+
 EIP7702_TEST_WHITELIST ?= 0
 ifneq ($(EIP7702_TEST_WHITELIST),0)
     DEFINES += HAVE_EIP7702_WHITELIST_TEST
@@ -60,6 +74,21 @@ ifneq ($(DEBUG), 0)
     ifneq ($(MEMORY_PROFILING),0)
         DEFINES += HAVE_MEMORY_PROFILING
     endif
+    # Count the costly syscalls per call site, see src/syscall_stats.h
+    SYSCALL_STATS ?= 0
+    ifneq ($(SYSCALL_STATS),0)
+        DEFINES += HAVE_SYSCALL_STATS
+    endif
+    # Time the signing flows phases, Speculos only (relies on the emulator semihosting clock)
+    PHASE_TRACE ?= 0
+    ifneq ($(PHASE_TRACE),0)
+        DEFINES += HAVE_PHASE_TRACE
+    endif
+    # Cap the usable size of the memory buffer at runtime, for memory pressure tests
+    ARENA_CAP ?= 0
+    ifneq ($(ARENA_CAP),0)
+        DEFINES += HAVE_ARENA_CAP
+    endif
 endif
 
 # Check features incompatibilities
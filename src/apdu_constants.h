@@ -36,6 +36,7 @@
 #define INS_SIGN_EIP7702_AUTHORIZATION      0x34
 #define INS_PROVIDE_SAFE_ACCOUNT            0x36
 #define INS_PROVIDE_GATING                  0x38
+#define INS_DEBUG_STATS                     0x3A
 
 #define INS_STR(x)                                                             \
     (x == INS_GET_PUBLIC_KEY                    ? "GET_PUBLIC_KEY"             \
@@ -64,6 +65,7 @@
      : x == INS_SIGN_EIP7702_AUTHORIZATION      ? "SIGN_EIP7702_AUTHORIZATION" \
      : x == INS_PROVIDE_SAFE_ACCOUNT            ? "PROVIDE_SAFE_ACCOUNT"       \
      : x == INS_PROVIDE_GATING                  ? "PROVIDE_GATING"             \
+     : x == INS_DEBUG_STATS                     ? "DEBUG_STATS"                \
                                                 : "Unknown")
 #define P1_CONFIRM              0x01
 #define P1_NON_CONFIRM          0x00
@@ -85,10 +87,12 @@ uint16_t handle_get_public_key(uint8_t p1,
                                uint8_t dataLength,
                                unsigned int *flags,
                                unsigned int *tx);
-uint16_t handle_provide_erc20_token_information(const uint8_t *workBuffer,
+uint16_t handle_provide_erc20_token_information(uint8_t p2,
+                                                const uint8_t *workBuffer,
                                                 uint8_t dataLength,
                                                 unsigned int *tx);
-uint16_t handle_provide_nft_information(const uint8_t *dataBuffer,
+uint16_t handle_provide_nft_information(uint8_t p2,
+                                        const uint8_t *dataBuffer,
                                         uint8_t dataLength,
                                         unsigned int *tx);
 uint16_t handle_sign(uint8_t p1,
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <stdint.h>
+#include "parser.h"
+
+uint16_t handle_apdu(command_t *cmd, uint32_t *flags, uint32_t *tx);
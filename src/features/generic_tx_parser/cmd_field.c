@@ -7,17 +7,32 @@
 #include "gtp_tx_info.h"
 #include "tx_ctx.h"
 
+#define P2_FIELD_SINGLE 0x00
+#define P2_FIELD_BATCH  0x01
+
+#define FIELDS_BATCH_TAG_FIELD 0x01
+
+typedef struct {
+    uint8_t count;
+} s_fields_batch_ctx;
+
+static s_fields_batch_ctx g_fields_batch;
+
 static bool handle_tlv_payload(const buffer_t *buf) {
     s_field field = {0};
     s_field_ctx ctx = {0};
 
+    if (get_current_tx_info() == NULL) {
+        PRINTF("Error: Field received without a TX info!\n");
+        return false;
+    }
     ctx.field = &field;
     if (!handle_field_struct(buf, &ctx)) {
         PRINTF("Error: could not handle the field struct!\n");
         cleanup_field_constraints(&field);
         return false;
     }
-    if (cx_hash_no_throw(get_fields_hash_ctx(), 0, buf->ptr, buf->size, NULL, 0) != CX_OK) {
+    if (!tx_ctx_hash_field(buf->ptr, buf->size)) {
         PRINTF("Error: could not hash the field struct!\n");
         cleanup_field_constraints(&field);
         return false;
@@ -40,20 +55,65 @@ static bool handle_tlv_payload(const buffer_t *buf) {
     return true;
 }
 
+static bool handle_batched_field(const tlv_data_t *data, void *context) {
+    s_fields_batch_ctx *batch = context;
+
+    if (data->tag != FIELDS_BATCH_TAG_FIELD) {
+        PRINTF("Error: unexpected tag (0x%x) in fields batch!\n", data->tag);
+        return false;
+    }
+    if (batch->count == UINT8_MAX) {
+        return false;
+    }
+    batch->count += 1;
+    if (!handle_tlv_payload(&data->value)) {
+        PRINTF("Error: could not handle field #%u of the batch!\n", batch->count);
+        return false;
+    }
+    return true;
+}
+
 uint16_t handle_field(uint8_t p1, uint8_t p2, uint8_t lc, const uint8_t *payload) {
-    (void) p2;
+    e_tlv_apdu_ret ret;
+
     if ((appState != APP_STATE_SIGNING_TX) && (appState != APP_STATE_SIGNING_EIP712)) {
         PRINTF("App not in TX signing mode!\n");
         return SWO_COMMAND_NOT_ALLOWED;
     }
 
+    if ((p2 != P2_FIELD_SINGLE) && (p2 != P2_FIELD_BATCH)) {
+        PRINTF("Error: Invalid P2 (%u)\n", p2);
+        return SWO_WRONG_P1_P2;
+    }
+
     if (get_current_tx_info() == NULL) {
         PRINTF("Error: Field received without a TX info!\n");
         gcs_cleanup();
         return SWO_COMMAND_NOT_ALLOWED;
     }
 
-    if (!tlv_from_apdu(p1 == P1_FIRST_CHUNK, lc, payload, &handle_tlv_payload)) {
+    if (p2 == P2_FIELD_SINGLE) {
+        // its nested structs are only known once the whole FIELD is parsed
+        if (!tlv_from_apdu(p1 == P1_FIRST_CHUNK, lc, payload, &handle_tlv_payload)) {
+            return SWO_INCORRECT_DATA;
+        }
+        return SWO_SUCCESS;
+    }
+
+    // fields batch, each FIELD is handled as soon as it is fully received
+    if (p1 == P1_FIRST_CHUNK) {
+        explicit_bzero(&g_fields_batch, sizeof(g_fields_batch));
+    }
+    ret = tlv_stream_from_apdu(p1 == P1_FIRST_CHUNK,
+                               lc,
+                               payload,
+                               &handle_batched_field,
+                               &g_fields_batch);
+    if (ret == TLV_APDU_ERROR) {
+        return SWO_INCORRECT_DATA;
+    }
+    if ((ret == TLV_APDU_SUCCESS) && (g_fields_batch.count == 0)) {
+        PRINTF("Error: empty fields batch!\n");
         return SWO_INCORRECT_DATA;
     }
     return SWO_SUCCESS;
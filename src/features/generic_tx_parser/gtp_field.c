@@ -8,6 +8,7 @@
 #include "lists.h"
 #include "tlv_library.h"
 #include "tlv_utils.h"
+#include "phase_trace.h"
 
 typedef union {
     s_param_raw_context raw_ctx;
@@ -230,6 +231,7 @@ bool verify_field_struct(const s_field_ctx *context) {
 bool format_field(s_field *field) {
     bool ret;
 
+    PHASE_BEGIN(FIELD_FORMAT, field->param_type);
     switch (field->param_type) {
         case PARAM_TYPE_RAW:
             ret = format_param_raw(field);
@@ -277,6 +279,7 @@ bool format_field(s_field *field) {
 
     // so that EIP-712 error-handling does trigger
     strings.tmp.tmp[0] = '\0';
+    PHASE_END(FIELD_FORMAT, ret);
     return ret;
 }
 
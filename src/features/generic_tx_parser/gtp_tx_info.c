@@ -24,6 +24,7 @@
     X(0x08, TAG_CREATOR_URL, handle_creator_url, ALLOW_MULTIPLE_TAG)               \
     X(0x09, TAG_CONTRACT_NAME, handle_contract_name, ALLOW_MULTIPLE_TAG)           \
     X(0x0a, TAG_DEPLOY_DATE, handle_deploy_date, ALLOW_MULTIPLE_TAG)               \
+    X(0x0b, TAG_FIELDS_COUNT, handle_fields_count, ENFORCE_UNIQUE_TAG)             \
     X(0xff, TAG_SIGNATURE, handle_signature, ENFORCE_UNIQUE_TAG)
 
 static bool handle_version(const tlv_data_t *data, s_tx_info_ctx *context) {
@@ -69,6 +70,14 @@ static bool handle_fields_hash(const tlv_data_t *data, s_tx_info_ctx *context) {
     return true;
 }
 
+static bool handle_fields_count(const tlv_data_t *data, s_tx_info_ctx *context) {
+    if (!tlv_get_uint16_range(data, &context->tx_info->fields_count, 0, UINT16_MAX)) {
+        return false;
+    }
+    context->tx_info->has_fields_count = true;
+    return true;
+}
+
 static bool handle_operation_type(const tlv_data_t *data, s_tx_info_ctx *context) {
     str_cpy_explicit_trunc((const char *) data->value.ptr,
                            data->value.size,
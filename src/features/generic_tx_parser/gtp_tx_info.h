@@ -24,6 +24,8 @@ typedef struct {
     uint8_t contract_addr[ADDRESS_LENGTH];
     uint8_t selector[CALLDATA_SELECTOR_SIZE];
     uint8_t fields_hash[INT256_LENGTH];
+    uint16_t fields_count;
+    bool has_fields_count;
     char operation_type[OPERATION_TYPE_SIZE];
     char creator_name[CREATOR_NAME_SIZE];
     char creator_legal_name[CREATOR_LEGAL_NAME_SIZE];
@@ -9,6 +9,7 @@
 #include "context_712.h"
 #include "network.h"
 #include "hash_bytes.h"
+#include "syscall_stats.h"
 
 static s_tx_ctx *g_tx_ctx_list = NULL;
 static s_tx_ctx *g_tx_ctx_current = NULL;
@@ -22,10 +23,6 @@ size_t get_tx_ctx_count(void) {
     return list_size((list_node_t **) &g_tx_ctx_list);
 }
 
-cx_hash_t *get_fields_hash_ctx(void) {
-    return (cx_hash_t *) &g_tx_ctx_current->fields_hash_ctx;
-}
-
 const s_tx_info *get_current_tx_info(void) {
     if (g_tx_ctx_current == NULL) return NULL;
     return g_tx_ctx_current->tx_info;
@@ -79,8 +76,47 @@ static bool validate_inst_hash_on(const s_tx_ctx *tx_ctx) {
     return memcmp(tx_ctx->tx_info->fields_hash, hash, sizeof(hash)) == 0;
 }
 
+/**
+ * Feed a received FIELD struct into the fields hash of the current TX context
+ *
+ * The (costly) hash finalization is only done once the declared amount of fields has been
+ * received, or after each field if the TX info did not declare any count. The result is cached
+ * so that \ref validate_instruction_hash is only an integer check.
+ *
+ * @param[in] field serialized FIELD struct
+ * @param[in] size size of the struct
+ * @return whether it was successful or not
+ */
+bool tx_ctx_hash_field(const uint8_t *field, size_t size) {
+    s_tx_ctx *tx_ctx = g_tx_ctx_current;
+    const s_tx_info *tx_info;
+
+    if ((tx_ctx == NULL) || ((tx_info = tx_ctx->tx_info) == NULL)) return false;
+    if (tx_ctx->fields_received == UINT16_MAX) return false;
+    if (cx_hash_no_throw((cx_hash_t *) &tx_ctx->fields_hash_ctx, 0, field, size, NULL, 0) !=
+        CX_OK) {
+        return false;
+    }
+    tx_ctx->fields_received += 1;
+    if (!tx_info->has_fields_count) {
+        tx_ctx->fields_hash_match = validate_inst_hash_on(tx_ctx);
+        return true;
+    }
+    if (tx_ctx->fields_received < tx_info->fields_count) {
+        tx_ctx->fields_hash_match = false;
+        return true;
+    }
+    if ((tx_ctx->fields_received > tx_info->fields_count) || !validate_inst_hash_on(tx_ctx)) {
+        PRINTF("Error: fields do not match the TX info!\n");
+        return false;
+    }
+    tx_ctx->fields_hash_match = true;
+    return true;
+}
+
 bool validate_instruction_hash(void) {
-    return validate_inst_hash_on(g_tx_ctx_current);
+    if (g_tx_ctx_current == NULL) return false;
+    return g_tx_ctx_current->fields_hash_match;
 }
 
 static void delete_tx_ctx(s_tx_ctx *node) {
@@ -227,25 +263,35 @@ bool set_tx_info_into_tx_ctx(s_tx_info *tx_info) {
 
     if (g_tx_ctx_current == NULL) return false;
     g_tx_ctx_current->tx_info = tx_info;
-    if (tx_ctx_is_root()) {
-        if (appState == APP_STATE_SIGNING_EIP712) {
-            if (!set_intent_field(tx_info->operation_type)) return false;
-        }
+    if (tx_info->has_fields_count && (tx_info->fields_count > 0)) {
+        // fields are expected, no need to check against the hash of an empty set
+        g_tx_ctx_current->fields_hash_match = false;
     } else {
-        if (!set_intent_field(tx_info->operation_type)) return false;
-    }
-
-    if ((appState == APP_STATE_SIGNING_EIP712) || !tx_ctx_is_root()) {
         if (cx_sha3_init_no_throw(&ctx, 256) != CX_OK) {
             return false;
         }
         if (finalize_hash((cx_hash_t *) &ctx, hash, sizeof(hash)) != true) {
             return false;
         }
-        if (memcmp(hash, tx_info->fields_hash, sizeof(hash)) == 0) {
-            tx_ctx_pop();
+        g_tx_ctx_current->fields_hash_match = memcmp(hash, tx_info->fields_hash, sizeof(hash)) == 0;
+        if (tx_info->has_fields_count && !g_tx_ctx_current->fields_hash_match) {
+            PRINTF("Error: fields do not match the TX info!\n");
+            return false;
         }
     }
+
+    if (tx_ctx_is_root()) {
+        if (appState == APP_STATE_SIGNING_EIP712) {
+            if (!set_intent_field(tx_info->operation_type)) return false;
+        }
+    } else {
+        if (!set_intent_field(tx_info->operation_type)) return false;
+    }
+
+    if (((appState == APP_STATE_SIGNING_EIP712) || !tx_ctx_is_root()) &&
+        g_tx_ctx_current->fields_hash_match) {
+        tx_ctx_pop();
+    }
     return true;
 }
 
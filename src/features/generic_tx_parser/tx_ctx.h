@@ -19,14 +19,16 @@ typedef struct {
     uint64_t chain_id;
 
     cx_sha3_t fields_hash_ctx;
+    uint16_t fields_received;
     bool has_amount : 1;
+    bool fields_hash_match : 1;
 } s_tx_ctx;
 
 extern s_calldata *g_parked_calldata;
 
 bool tx_ctx_is_root(void);
 size_t get_tx_ctx_count(void);
-cx_hash_t *get_fields_hash_ctx(void);
+bool tx_ctx_hash_field(const uint8_t *field, size_t size);
 const s_tx_info *get_root_tx_info(void);
 const s_tx_info *get_current_tx_info(void);
 s_calldata *get_current_calldata(void);
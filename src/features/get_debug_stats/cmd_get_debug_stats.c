@@ -0,0 +1,182 @@
+#if defined(HAVE_SYSCALL_STATS) || defined(HAVE_PHASE_TRACE) || defined(HAVE_ARENA_CAP)
+
+#include <string.h>
+#include "cmd_get_debug_stats.h"
+#include "apdu_constants.h"
+#include "syscall_stats.h"
+#include "phase_trace.h"
+#include "mem_utils.h"
+
+#define P1_SYSCALL_STATS 0x00
+#define P1_PHASE_TRACE   0x01
+#define P1_PHASE_CLEAR   0x02
+#define P1_ARENA_CAP     0x03
+
+#define P2_SYSCALL_SUMMARY 0x00
+
+// Room left for the status word
+#define DEBUG_STATS_MAX_LENGTH (sizeof(G_io_tx_buffer) - 2)
+
+#ifdef HAVE_SYSCALL_STATS
+/**
+ * Send back the syscall totals of the last flow
+ *
+ * Format: count(1) | count * (calls(4) | bytes(4)) | sites count(1) | sites overflow(1)
+ *
+ * @param[out] tx output length
+ */
+static void get_syscall_summary(unsigned int *tx) {
+    const s_syscall_stats *stats = syscall_stats_get_last();
+
+    G_io_tx_buffer[(*tx)++] = SYSCALL_STATS_COUNT;
+    for (uint8_t i = 0; i < SYSCALL_STATS_COUNT; ++i) {
+        U4BE_ENCODE(G_io_tx_buffer, *tx, stats->calls[i]);
+        *tx += sizeof(uint32_t);
+        U4BE_ENCODE(G_io_tx_buffer, *tx, stats->bytes[i]);
+        *tx += sizeof(uint32_t);
+    }
+    G_io_tx_buffer[(*tx)++] = stats->sites_count;
+    G_io_tx_buffer[(*tx)++] = stats->sites_overflow;
+}
+
+/**
+ * Send back as many call sites of the last flow as possible
+ *
+ * Format: count(1) | count * (id(1) | line(2) | calls(4) | bytes(4) | file length(1) | file)
+ *
+ * @param[in] first index of the first call site
+ * @param[out] tx output length
+ * @return whether the index is valid
+ */
+static bool get_syscall_sites(uint8_t first, unsigned int *tx) {
+    const s_syscall_stats *stats = syscall_stats_get_last();
+    const s_syscall_site *site;
+    unsigned int count_offset = (*tx)++;
+    uint8_t count = 0;
+    size_t file_len;
+
+    if (first >= stats->sites_count) {
+        PRINTF("Error: no call site #%u!\n", first);
+        return false;
+    }
+    for (uint8_t i = first; i < stats->sites_count; ++i) {
+        site = &stats->sites[i];
+        file_len = MIN(strlen(site->file), UINT8_MAX);
+        if ((*tx + 12 + file_len) > DEBUG_STATS_MAX_LENGTH) {
+            break;
+        }
+        G_io_tx_buffer[(*tx)++] = site->id;
+        U2BE_ENCODE(G_io_tx_buffer, *tx, site->line);
+        *tx += sizeof(uint16_t);
+        U4BE_ENCODE(G_io_tx_buffer, *tx, site->calls);
+        *tx += sizeof(uint32_t);
+        U4BE_ENCODE(G_io_tx_buffer, *tx, site->bytes);
+        *tx += sizeof(uint32_t);
+        G_io_tx_buffer[(*tx)++] = file_len;
+        memcpy(&G_io_tx_buffer[*tx], site->file, file_len);
+        *tx += file_len;
+        count += 1;
+    }
+    G_io_tx_buffer[count_offset] = count;
+    return true;
+}
+#endif  // HAVE_SYSCALL_STATS
+
+#ifdef HAVE_PHASE_TRACE
+/**
+ * Send back as many phase events as possible
+ *
+ * Format: total(4) | count(1) | count * (tick(4) | arg(2) | phase(1) | edge(1))
+ *
+ * @param[in] first index of the first event, among the kept ones from the oldest
+ * @param[out] tx output length
+ * @return whether the index is valid
+ */
+static bool get_phase_events(uint8_t first, unsigned int *tx) {
+    const s_phase_event *event;
+    unsigned int count_offset;
+    uint8_t count = 0;
+
+    if (first > phase_trace_count()) {
+        PRINTF("Error: no phase event #%u!\n", first);
+        return false;
+    }
+    U4BE_ENCODE(G_io_tx_buffer, *tx, phase_trace_total());
+    *tx += sizeof(uint32_t);
+    count_offset = (*tx)++;
+    while (((event = phase_trace_get(first + count)) != NULL) &&
+           ((*tx + sizeof(*event)) <= DEBUG_STATS_MAX_LENGTH)) {
+        U4BE_ENCODE(G_io_tx_buffer, *tx, event->tick);
+        *tx += sizeof(uint32_t);
+        U2BE_ENCODE(G_io_tx_buffer, *tx, event->arg);
+        *tx += sizeof(uint16_t);
+        G_io_tx_buffer[(*tx)++] = event->phase;
+        G_io_tx_buffer[(*tx)++] = event->edge;
+        count += 1;
+    }
+    G_io_tx_buffer[count_offset] = count;
+    return true;
+}
+#endif  // HAVE_PHASE_TRACE
+
+/**
+ * Handle the debug statistics APDU
+ *
+ * @param[in] p1 kind of statistics
+ * @param[in] p2 for the syscalls, 0 for the totals or n for the call sites from the n-th one,
+ *               for the phases, index of the first event
+ * @param[in] data command data
+ * @param[in] length data length
+ * @param[out] tx output length
+ * @return APDU Response code
+ */
+uint16_t handle_debug_stats(uint8_t p1,
+                            uint8_t p2,
+                            const uint8_t *data,
+                            uint8_t length,
+                            unsigned int *tx) {
+#if !defined(HAVE_SYSCALL_STATS) && !defined(HAVE_PHASE_TRACE)
+    UNUSED(p2);
+    UNUSED(tx);
+#endif
+#ifndef HAVE_ARENA_CAP
+    UNUSED(data);
+    UNUSED(length);
+#endif
+    switch (p1) {
+#ifdef HAVE_SYSCALL_STATS
+        case P1_SYSCALL_STATS:
+            if (p2 == P2_SYSCALL_SUMMARY) {
+                get_syscall_summary(tx);
+            } else if (!get_syscall_sites(p2 - 1, tx)) {
+                return SWO_INCORRECT_DATA;
+            }
+            break;
+#endif
+#ifdef HAVE_PHASE_TRACE
+        case P1_PHASE_TRACE:
+            if (!get_phase_events(p2, tx)) {
+                return SWO_INCORRECT_DATA;
+            }
+            break;
+        case P1_PHASE_CLEAR:
+            phase_trace_clear();
+            break;
+#endif
+#ifdef HAVE_ARENA_CAP
+        case P1_ARENA_CAP:
+            if (length != sizeof(uint16_t)) {
+                return SWO_WRONG_DATA_LENGTH;
+            }
+            if (!app_mem_set_cap(U2BE(data, 0))) {
+                return SWO_INSUFFICIENT_MEMORY;
+            }
+            break;
+#endif
+        default:
+            return SWO_WRONG_P1_P2;
+    }
+    return SWO_SUCCESS;
+}
+
+#endif  // HAVE_SYSCALL_STATS || HAVE_PHASE_TRACE || HAVE_ARENA_CAP
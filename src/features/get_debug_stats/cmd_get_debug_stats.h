@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+uint16_t handle_debug_stats(uint8_t p1,
+                            uint8_t p2,
+                            const uint8_t *data,
+                            uint8_t length,
+                            unsigned int *tx);
@@ -6,6 +6,7 @@
 #include "feature_get_eth2_public_key.h"
 #include "common_ui.h"
 #include "os_io_seproxyhal.h"
+#include "syscall_stats.h"
 
 static const uint8_t BLS12_381_FIELD_MODULUS[] = {
     0x1a, 0x01, 0x11, 0xea, 0x39, 0x7f, 0xe6, 0x9a, 0x4b, 0x1b, 0xa7, 0xb6, 0x43, 0x4b, 0xac, 0xd7,
@@ -3,6 +3,85 @@
 #include "shared_context.h"
 #include "apdu_constants.h"
 #include "ox_ec.h"
+#include "os_pin.h"
+#include "syscall_stats.h"
+
+// Last derived account, to skip the BIP32 derivation when the same one is used again, the chain
+// code is never kept
+static struct {
+    bool valid;
+    bool has_address_str;
+    cx_curve_t curve;
+    bip32_path_t bip32;
+    uint8_t raw_pubkey[CX_SECP256_PUB_KEY_SIZE];
+    uint8_t address[ADDRESS_LENGTH];
+    uint64_t address_str_chain_id;
+    char address_str[ADDRESS_LENGTH_STR];
+} g_pubkey_cache;
+
+/**
+ * Wipe the derived account cache
+ *
+ * To be called whenever the app quits or the device gets locked.
+ */
+void pubkey_cache_clear(void) {
+    explicit_bzero(&g_pubkey_cache, sizeof(g_pubkey_cache));
+}
+
+/**
+ * Wipe the derived account cache if the device got locked
+ *
+ * Called on every ticker event, so that the cache does not outlive the PIN validation.
+ */
+void pubkey_cache_check_lock(void) {
+    if (g_pubkey_cache.valid && (os_global_pin_is_validated() != BOLOS_UX_OK)) {
+        pubkey_cache_clear();
+    }
+}
+
+static bool pubkey_cache_match(cx_curve_t curve, const bip32_path_t *bip32) {
+    return g_pubkey_cache.valid && (g_pubkey_cache.curve == curve) &&
+           (g_pubkey_cache.bip32.length == bip32->length) &&
+           (memcmp(g_pubkey_cache.bip32.path,
+                   bip32->path,
+                   bip32->length * sizeof(bip32->path[0])) == 0);
+}
+
+/**
+ * Make sure the cache holds the given account, derive it otherwise
+ *
+ * Asking for the chain code always goes through the derivation, since it is not cached.
+ *
+ * @param[in] bip32 BIP32 path of the account
+ * @param[out] chain_code chain code of the account, NULL if not needed
+ * @return error code
+ */
+static cx_err_t pubkey_cache_derive(const bip32_path_t *bip32, uint8_t *chain_code) {
+    cx_err_t error;
+
+    if (os_global_pin_is_validated() != BOLOS_UX_OK) {
+        // device got locked since the last derivation
+        pubkey_cache_clear();
+    }
+    if ((chain_code == NULL) && pubkey_cache_match(CX_CURVE_256K1, bip32)) {
+        return CX_OK;
+    }
+    pubkey_cache_clear();
+    if ((error = bip32_derive_get_pubkey_256(CX_CURVE_256K1,
+                                             bip32->path,
+                                             bip32->length,
+                                             g_pubkey_cache.raw_pubkey,
+                                             chain_code,
+                                             CX_SHA512)) != CX_OK) {
+        pubkey_cache_clear();
+        return error;
+    }
+    getEthAddressFromRawKey(g_pubkey_cache.raw_pubkey, g_pubkey_cache.address);
+    g_pubkey_cache.curve = CX_CURVE_256K1;
+    memcpy(&g_pubkey_cache.bip32, bip32, sizeof(g_pubkey_cache.bip32));
+    g_pubkey_cache.valid = true;
+    return CX_OK;
+}
 
 uint16_t get_public_key_string(bip32_path_t *bip32,
                                uint8_t *pubKey,
@@ -11,38 +90,40 @@ uint16_t get_public_key_string(bip32_path_t *bip32,
                                uint64_t chainId) {
     cx_err_t error = CX_INTERNAL_ERROR;
 
-    CX_CHECK(bip32_derive_get_pubkey_256(CX_CURVE_256K1,
-                                         bip32->path,
-                                         bip32->length,
-                                         pubKey,
-                                         chainCode,
-                                         CX_SHA512));
-    getEthAddressStringFromRawKey(pubKey, address, chainId);
+    CX_CHECK(pubkey_cache_derive(bip32, chainCode));
+    memcpy(pubKey, g_pubkey_cache.raw_pubkey, sizeof(g_pubkey_cache.raw_pubkey));
+    // the checksum depends on the chain ID (EIP-1191)
+    if (!g_pubkey_cache.has_address_str || (g_pubkey_cache.address_str_chain_id != chainId)) {
+        getEthAddressStringFromRawKey(g_pubkey_cache.raw_pubkey,
+                                      g_pubkey_cache.address_str,
+                                      chainId);
+        g_pubkey_cache.address_str_chain_id = chainId;
+        g_pubkey_cache.has_address_str = true;
+    }
+    memcpy(address, g_pubkey_cache.address_str, sizeof(g_pubkey_cache.address_str));
     error = CX_OK;
 end:
     return error;
 }
 
-uint16_t get_public_key(uint8_t *out, uint8_t outLength) {
-    uint8_t raw_pubkey[CX_SECP256_PUB_KEY_SIZE];
+uint16_t get_public_key_from_path(const bip32_path_t *bip32, uint8_t *out, uint8_t outLength) {
     cx_err_t error;
 
     if (outLength < ADDRESS_LENGTH) {
         return SWO_WRONG_DATA_LENGTH;
     }
-    if ((error = bip32_derive_get_pubkey_256(CX_CURVE_256K1,
-                                             tmpCtx.transactionContext.bip32.path,
-                                             tmpCtx.transactionContext.bip32.length,
-                                             raw_pubkey,
-                                             NULL,
-                                             CX_SHA512)) != CX_OK) {
+    if ((error = pubkey_cache_derive(bip32, NULL)) != CX_OK) {
         PRINTF("Error: could not derive pubkey!\n");
         return error;
     }
-    getEthAddressFromRawKey(raw_pubkey, out);
+    memcpy(out, g_pubkey_cache.address, sizeof(g_pubkey_cache.address));
     return SWO_SUCCESS;
 }
 
+uint16_t get_public_key(uint8_t *out, uint8_t outLength) {
+    return get_public_key_from_path(&tmpCtx.transactionContext.bip32, out, outLength);
+}
+
 uint32_t set_result_get_publicKey() {
     uint32_t tx = 0;
     G_io_tx_buffer[tx++] = CX_SECP256_PUB_KEY_SIZE;
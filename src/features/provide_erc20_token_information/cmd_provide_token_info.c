@@ -4,7 +4,8 @@
 #include "manage_asset_info.h"
 #include "os_pki.h"
 
-uint16_t handle_provide_erc20_token_information(const uint8_t *workBuffer,
+uint16_t handle_provide_erc20_token_information(uint8_t p2,
+                                                const uint8_t *workBuffer,
                                                 uint8_t dataLength,
                                                 unsigned int *tx) {
     uint32_t offset = 0;
@@ -57,8 +58,6 @@ uint16_t handle_provide_erc20_token_information(const uint8_t *workBuffer,
         return SWO_INCORRECT_DATA;
     }
 
-    G_io_tx_buffer[0] = tmpCtx.transactionContext.currentAssetIndex;
-    validate_current_asset_info();
-    *tx += 1;
+    *tx += validate_current_asset_info(G_io_tx_buffer, p2);
     return SWO_SUCCESS;
 }
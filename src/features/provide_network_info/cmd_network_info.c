@@ -7,10 +7,13 @@
 #include "tlv_apdu.h"
 #include "mem_utils.h"
 #include "ui_utils.h"
+#include "read.h"
+#include "network_registry.h"
 
 #define P2_NETWORK_CONFIG 0x00
 #define P2_NETWORK_ICON   0x01
 #define P2_GET_INFO       0x02
+#define P2_CLEAR_REGISTRY 0x03
 
 /**
  * @brief Returns the current network configuration.
@@ -46,6 +49,34 @@ static uint16_t handle_get_config(void) {
     return tx;
 }
 
+#ifdef HAVE_NETWORK_REGISTRY
+/**
+ * @brief Delete the stored networks.
+ *
+ * @param[in] data chain ID of the network to delete (8 bytes), none to delete all of them
+ * @param[in] length of the buffer
+ * @return APDU Response code
+ */
+static uint16_t handle_clear_registry(const uint8_t *data, uint8_t length) {
+    uint64_t chain_id = 0;
+
+    if (length == sizeof(chain_id)) {
+        chain_id = read_u64_be(data, 0);
+        if (chain_id == 0) {
+            return SWO_INCORRECT_DATA;
+        }
+    } else if (length != 0) {
+        PRINTF("Error: Unexpected chain ID length (%u)!\n", length);
+        return SWO_WRONG_DATA_LENGTH;
+    }
+    if (!network_registry_delete(chain_id) && (chain_id != 0)) {
+        PRINTF("Error: chain ID %llu is not stored!\n", chain_id);
+        return SWO_REFERENCED_DATA_NOT_FOUND;
+    }
+    return SWO_SUCCESS;
+}
+#endif
+
 /**
  * @brief Handle Network Configuration APDU.
  *
@@ -66,6 +97,7 @@ uint16_t handle_network_info(uint8_t p1,
 
     switch (p2) {
         case P2_NETWORK_CONFIG:
+            // the icon is sent apart, the descriptor alone usually fits in a single APDU
             if (!tlv_from_apdu(p1 == P1_FIRST_CHUNK, length, data, &handle_network_tlv_payload)) {
                 // If there was an error, free the allocated memory
                 network_info_cleanup(g_last_added_network);
@@ -94,6 +126,16 @@ uint16_t handle_network_info(uint8_t p1,
             *tx = handle_get_config();
             sw = SWO_SUCCESS;
             break;
+#ifdef HAVE_NETWORK_REGISTRY
+        case P2_CLEAR_REGISTRY:
+            if (p1 != 0x00) {
+                PRINTF("Error: Unexpected P1 (%u)!\n", p1);
+                sw = SWO_WRONG_P1_P2;
+                break;
+            }
+            sw = handle_clear_registry(data, length);
+            break;
+#endif
         default:
             network_info_cleanup(g_last_added_network);
             sw = SWO_WRONG_P1_P2;
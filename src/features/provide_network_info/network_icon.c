@@ -6,6 +6,8 @@
 #include "tlv_apdu.h"
 #include "app_mem_utils.h"
 #include "ui_utils.h"
+#include "network_registry.h"
+#include "hash_bytes.h"
 
 #define P2_NETWORK_CONFIG        0x00
 #define P2_NETWORK_ICON          0x01
@@ -15,6 +17,8 @@
 typedef struct {
     uint16_t received_size;
     uint16_t expected_size;
+    // hashed as the chunks are received
+    cx_sha256_t hash_ctx;
 } network_payload_t;
 
 // Global structure to temporary store the network icon APDU
@@ -118,7 +122,7 @@ static bool parse_icon_buffer(void) {
     }
 
     // Check icon hash
-    if (cx_sha256_hash(g_icon_bitmap, field_len, digest) != CX_OK) {
+    if (!finalize_hash((cx_hash_t *) &g_icon_payload.hash_ctx, digest, sizeof(digest))) {
         return false;
     }
     if (memcmp(digest, g_network_icon_hash, CX_SHA256_SIZE) != 0) {
@@ -139,6 +143,11 @@ static bool parse_icon_buffer(void) {
 
     // Reset temporary pointer (ownership transferred, don't free it!)
     g_icon_bitmap = NULL;
+#ifdef HAVE_NETWORK_REGISTRY
+    if (!network_registry_store_icon(g_last_added_network, field_len)) {
+        PRINTF("Warning: could not persist the network icon!\n");
+    }
+#endif
     return true;
 }
 
@@ -168,6 +177,7 @@ static uint16_t handle_first_icon_chunk(const buffer_t *buf) {
         return SWO_INSUFFICIENT_MEMORY;
     }
     g_icon_payload.expected_size = img_len;
+    cx_sha256_init(&g_icon_payload.hash_ctx);
 
     return SWO_SUCCESS;
 }
@@ -190,6 +200,7 @@ static uint16_t handle_next_icon_chunk(const buffer_t *buf) {
     }
     // Feed into payload
     memcpy(g_icon_bitmap + g_icon_payload.received_size, buf->ptr, buf->size);
+    hash_nbytes(buf->ptr, buf->size, (cx_hash_t *) &g_icon_payload.hash_ctx);
     g_icon_payload.received_size += buf->size;
 
     return SWO_SUCCESS;
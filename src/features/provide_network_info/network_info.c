@@ -10,6 +10,7 @@
 #include "tlv_library.h"
 #include "tlv_utils.h"
 #include "lcx_ecdsa.h"
+#include "network_registry.h"
 
 #define TYPE_DYNAMIC_NETWORK   0x08
 #define NETWORK_STRUCT_VERSION 0x01
@@ -19,6 +20,7 @@
 typedef struct {
     network_info_t network;
     uint8_t icon_hash[CX_SHA256_SIZE];
+    uint8_t desc_hash[CX_SHA256_SIZE];
     uint8_t sig_size;
     const uint8_t *sig;
     cx_sha256_t hash_ctx;
@@ -196,18 +198,18 @@ static bool network_common_handler(const tlv_data_t *data, s_network_info_ctx *c
  *
  * Verify the SHA-256 hash of the payload against the public key
  *
- * @param[in] context struct context
+ * @param[in,out] context struct context
  * @return whether it was successful
  */
-static bool verify_signature(const s_network_info_ctx *context) {
-    uint8_t hash[INT256_LENGTH];
-
-    if (finalize_hash((cx_hash_t *) &context->hash_ctx, hash, sizeof(hash)) != true) {
+static bool verify_signature(s_network_info_ctx *context) {
+    if (finalize_hash((cx_hash_t *) &context->hash_ctx,
+                      context->desc_hash,
+                      sizeof(context->desc_hash)) != true) {
         return false;
     }
 
-    if (check_signature_with_pubkey(hash,
-                                    sizeof(hash),
+    if (check_signature_with_pubkey(context->desc_hash,
+                                    sizeof(context->desc_hash),
                                     NULL,
                                     0,
                                     CERTIFICATE_PUBLIC_KEY_USAGE_NETWORK,
@@ -259,10 +261,10 @@ static void print_network_info(void) {
  *
  * Verify the SHA-256 hash of the payload against the public key
  *
- * @param[in] context struct context
+ * @param[in,out] context struct context
  * @return whether it was successful
  */
-static bool verify_network_info_struct(const s_network_info_ctx *context) {
+static bool verify_network_info_struct(s_network_info_ctx *context) {
     if (!verify_fields(context)) {
         PRINTF("Error: Missing mandatory fields in Network descriptor!\n");
         return false;
@@ -274,6 +276,27 @@ static bool verify_network_info_struct(const s_network_info_ctx *context) {
     return true;
 }
 
+/**
+ * @brief Free the icon bitmap of a network
+ *
+ * @param[in] network network
+ */
+static void free_network_icon(network_info_t *network) {
+    const uint8_t *bitmap = network->icon.bitmap;
+
+#ifdef HAVE_NETWORK_REGISTRY
+    if (network_registry_owns_icon(network)) {
+        // lives in NVM
+        network->icon.bitmap = NULL;
+        return;
+    }
+#endif
+    if (bitmap != NULL) {
+        APP_MEM_FREE_AND_NULL((void **) &bitmap);
+    }
+    network->icon.bitmap = NULL;
+}
+
 /**
  * @brief Append the network information to the global list
  *
@@ -286,10 +309,7 @@ static bool append_network_info(const s_network_info_ctx *context) {
     if (existing != NULL) {
         PRINTF("Network information already exist... Deleting it first!\n");
         // Remove from list and cleanup
-        const uint8_t *bitmap = existing->icon.bitmap;
-        if (bitmap != NULL) {
-            APP_MEM_FREE_AND_NULL((void **) &bitmap);
-        }
+        free_network_icon(existing);
         flist_remove((flist_node_t **) &g_dynamic_network_list, (flist_node_t *) existing, NULL);
         APP_MEM_FREE_AND_NULL((void **) &existing);
     }
@@ -351,6 +371,12 @@ static bool add_network_info(const s_network_info_ctx *context) {
         PRINTF("Error: Failed to prepare network icon!\n");
         return false;
     }
+#ifdef HAVE_NETWORK_REGISTRY
+    // Not being able to persist it does not prevent using it
+    if (!network_registry_store(&context->network, context->icon_hash, context->desc_hash)) {
+        PRINTF("Warning: could not persist the network information!\n");
+    }
+#endif
     print_network_info();
     return true;
 }
@@ -393,10 +419,7 @@ void network_info_cleanup(network_info_t *network) {
             network_info_t *net_info = (network_info_t *) node;
 
             // Free the icon bitmap if allocated
-            const uint8_t *bitmap = net_info->icon.bitmap;
-            if (bitmap != NULL) {
-                APP_MEM_FREE_AND_NULL((void **) &bitmap);
-            }
+            free_network_icon(net_info);
             // Free the network info structure
             APP_MEM_FREE_AND_NULL((void **) &net_info);
             node = next;
@@ -409,10 +432,7 @@ void network_info_cleanup(network_info_t *network) {
     } else {
         // Cleanup specific network
         // Free the icon bitmap if allocated
-        const uint8_t *bitmap = network->icon.bitmap;
-        if (bitmap != NULL) {
-            APP_MEM_FREE_AND_NULL((void **) &bitmap);
-        }
+        free_network_icon(network);
 
         // Remove from list
         flist_remove((flist_node_t **) &g_dynamic_network_list, (flist_node_t *) network, NULL);
@@ -0,0 +1,392 @@
+#ifdef HAVE_NETWORK_REGISTRY
+
+#include <stddef.h>
+#include <string.h>
+#include "os_nvm.h"
+#include "os_pic.h"
+#include "cx.h"
+#include "network_registry.h"
+#include "network_info.h"
+#include "app_mem_utils.h"
+#include "read.h"
+#include "public_keys.h"
+
+#define NETWORK_REGISTRY_SIZE 4
+// Icon header + maximum bitmap size accepted by the PROVIDE_NETWORK_INFO command
+#define NETWORK_REGISTRY_ICON_MAX_SIZE (8 + 1024)
+// To bump when the trust put in the stored descriptors changes (signing keys, descriptor format),
+// the entries stored under another epoch are dropped
+#define NETWORK_REGISTRY_EPOCH 1
+
+/*
+ * The descriptor signature can not be verified again at app start, the certificate it relies on is
+ * only loaded by the host within a session. Each entry keeps instead the provenance of that
+ * signature, and is dropped as soon as it does not match the one the app would now verify it with.
+ */
+typedef struct {
+    uint64_t chain_id;  // 0 if the entry is free
+    char name[MAX_NETWORK_LEN];
+    char ticker[MAX_TICKER_LEN];
+    // write order of the entries, the oldest one gets replaced when the registry is full
+    uint32_t generation;
+    uint32_t epoch;
+    // key usage the descriptor signature was verified with
+    uint8_t key_usage;
+    // fingerprint of the certificate it was verified with, all zeroes for the embedded key
+    uint8_t cert_fingerprint[CX_SHA256_SIZE];
+    // hash of the signed descriptor, to not rewrite the very same one
+    uint8_t desc_hash[CX_SHA256_SIZE];
+    // expected hash of the icon, all zeroes if there is none
+    uint8_t icon_hash[CX_SHA256_SIZE];
+    // CRC32 of all the fields above, to detect a corrupted or partially written entry
+    uint32_t crc;
+    uint16_t icon_size;  // 0 if the icon is not stored
+} s_network_registry_desc;
+
+typedef struct {
+    s_network_registry_desc desc;
+    uint8_t icon[NETWORK_REGISTRY_ICON_MAX_SIZE];
+} s_network_registry_entry;
+
+typedef struct {
+    s_network_registry_entry entries[NETWORK_REGISTRY_SIZE];
+} s_network_registry;
+
+const s_network_registry N_network_registry_real;
+
+#define N_network_registry (*(volatile s_network_registry *) PIC(&N_network_registry_real))
+
+static uint32_t desc_crc(const volatile s_network_registry_desc *desc) {
+    return cx_crc32((const void *) desc, offsetof(s_network_registry_desc, crc));
+}
+
+/**
+ * @brief Get the fingerprint of the loaded certificate for the network descriptors
+ *
+ * @param[out] fingerprint certificate fingerprint
+ * @return whether such a certificate is loaded
+ */
+static bool get_network_cert_fingerprint(uint8_t *fingerprint) {
+    uint8_t key_usage;
+
+    return get_pki_cert_fingerprint(&key_usage, fingerprint) &&
+           (key_usage == CERTIFICATE_PUBLIC_KEY_USAGE_NETWORK);
+}
+
+static volatile s_network_registry_entry *find_entry(uint64_t chain_id) {
+    for (uint8_t i = 0; i < NETWORK_REGISTRY_SIZE; ++i) {
+        if (N_network_registry.entries[i].desc.chain_id == chain_id) {
+            return &N_network_registry.entries[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Get the entry to store a new descriptor into
+ *
+ * The entry already used by the chain ID if any, then a free one, then the oldest one.
+ *
+ * @param[in] chain_id chain ID of the new descriptor
+ * @param[out] generation generation of the new descriptor
+ * @return the entry
+ */
+static volatile s_network_registry_entry *get_target_entry(uint64_t chain_id,
+                                                           uint32_t *generation) {
+    volatile s_network_registry_entry *target = find_entry(chain_id);
+    volatile s_network_registry_entry *oldest = &N_network_registry.entries[0];
+
+    *generation = 0;
+    for (uint8_t i = 0; i < NETWORK_REGISTRY_SIZE; ++i) {
+        volatile s_network_registry_entry *entry = &N_network_registry.entries[i];
+
+        if (entry->desc.chain_id == 0) {
+            if (target == NULL) {
+                target = entry;
+            }
+            continue;
+        }
+        if (entry->desc.generation >= *generation) {
+            *generation = entry->desc.generation + 1;
+        }
+        if (entry->desc.generation < oldest->desc.generation) {
+            oldest = entry;
+        }
+    }
+    return (target != NULL) ? target : oldest;
+}
+
+/**
+ * @brief Drop the loaded copy of a stored network
+ *
+ * Its icon points to the entry about to be overwritten, so it must not be kept.
+ *
+ * @param[in] chain_id chain ID of the stored network
+ * @param[in] unload whether to remove the whole network, or only its icon
+ */
+static void drop_loaded_network(uint64_t chain_id, bool unload) {
+    network_info_t *network = find_dynamic_network_by_chain_id(chain_id);
+
+    if (network == NULL) {
+        return;
+    }
+    if (unload) {
+        network_info_cleanup(network);
+    } else if (network_registry_owns_icon(network)) {
+        explicit_bzero(&network->icon, sizeof(network->icon));
+    }
+}
+
+/**
+ * @brief Check if a stored entry can still be trusted
+ *
+ * @param[in] entry registry entry in use
+ * @param[in] fingerprint fingerprint of the loaded certificate for the network descriptors, NULL
+ * if there is none, in which case the current provenance is not known yet
+ * @return whether it is intact, of the current epoch and of the current provenance
+ */
+static bool entry_is_trusted(const volatile s_network_registry_entry *entry,
+                             const uint8_t *fingerprint) {
+    uint8_t digest[CX_SHA256_SIZE];
+    uint16_t icon_size = entry->desc.icon_size;
+
+    if (desc_crc(&entry->desc) != entry->desc.crc) {
+        PRINTF("[NETWORK] - Corrupted entry for chain_id %llu\n", entry->desc.chain_id);
+        return false;
+    }
+    if ((entry->desc.epoch != NETWORK_REGISTRY_EPOCH) ||
+        (entry->desc.key_usage != CERTIFICATE_PUBLIC_KEY_USAGE_NETWORK)) {
+        PRINTF("[NETWORK] - Expired entry for chain_id %llu\n", entry->desc.chain_id);
+        return false;
+    }
+    if ((fingerprint != NULL) && (memcmp(fingerprint,
+                                         (const void *) entry->desc.cert_fingerprint,
+                                         sizeof(entry->desc.cert_fingerprint)) != 0)) {
+        PRINTF("[NETWORK] - Entry for chain_id %llu verified with another certificate\n",
+               entry->desc.chain_id);
+        return false;
+    }
+    if (icon_size > 0) {
+        if ((icon_size > sizeof(entry->icon)) ||
+            (cx_sha256_hash((const uint8_t *) entry->icon, icon_size, digest) != CX_OK) ||
+            (memcmp(digest, (const void *) entry->desc.icon_hash, sizeof(digest)) != 0)) {
+            PRINTF("[NETWORK] - Corrupted icon for chain_id %llu\n", entry->desc.chain_id);
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Erase a stored network
+ *
+ * It is also removed from the dynamic networks list, so that it stops being trusted right away.
+ *
+ * @param[in] entry registry entry
+ */
+static void erase_entry(volatile s_network_registry_entry *entry) {
+    const s_network_registry_desc desc = {0};
+
+    drop_loaded_network(entry->desc.chain_id, true);
+    nvm_write((void *) &entry->desc, (void *) &desc, sizeof(desc));
+}
+
+/**
+ * @brief Erase the stored networks which can not be trusted anymore
+ *
+ * @param[in] fingerprint fingerprint of the loaded certificate for the network descriptors, NULL
+ * if there is none
+ * @param[in] skipped chain ID of an entry to leave as is, 0 for none
+ */
+static void erase_untrusted_entries(const uint8_t *fingerprint, uint64_t skipped) {
+    for (uint8_t i = 0; i < NETWORK_REGISTRY_SIZE; ++i) {
+        volatile s_network_registry_entry *entry = &N_network_registry.entries[i];
+
+        if ((entry->desc.chain_id != 0) && (entry->desc.chain_id != skipped) &&
+            !entry_is_trusted(entry, fingerprint)) {
+            erase_entry(entry);
+        }
+    }
+}
+
+/**
+ * @brief Add a stored network to the dynamic networks list
+ *
+ * The icon bitmap is not copied, it directly points to the NVM.
+ *
+ * @param[in] entry registry entry
+ * @return whether it was successful
+ */
+static bool load_entry(const volatile s_network_registry_entry *entry) {
+    network_info_t *network = NULL;
+
+    // Do not track the allocation in logs, because this buffer is expected to stay allocated
+    if (APP_MEM_PERMANENT((void **) &network, sizeof(*network)) == false) {
+        PRINTF("Memory allocation failed for network info\n");
+        return false;
+    }
+    network->chain_id = entry->desc.chain_id;
+    memcpy(network->name, (const void *) entry->desc.name, sizeof(network->name));
+    memcpy(network->ticker, (const void *) entry->desc.ticker, sizeof(network->ticker));
+    if (entry->desc.icon_size > 0) {
+        network->icon.bitmap = (const uint8_t *) entry->icon;
+        network->icon.width = U2LE(entry->icon, 0);
+        network->icon.height = U2LE(entry->icon, 2);
+        // BPP is stored in the upper 4 bits of the 5th byte
+        network->icon.bpp = entry->icon[4] >> 4;
+        network->icon.isFile = true;
+    }
+    flist_push_back((flist_node_t **) &g_dynamic_network_list, (flist_node_t *) network);
+    PRINTF("[NETWORK] - Restored '%s' for chain_id %llu\n", network->name, network->chain_id);
+    return true;
+}
+
+/**
+ * @brief Load the stored networks into the dynamic networks list
+ *
+ * To be called once at app start. Only the entries which can not be trusted anymore get erased,
+ * nothing is written otherwise.
+ */
+void network_registry_load(void) {
+    uint8_t fingerprint[CX_SHA256_SIZE];
+    bool has_cert = get_network_cert_fingerprint(fingerprint);
+
+    erase_untrusted_entries(has_cert ? fingerprint : NULL, 0);
+    for (uint8_t i = 0; i < NETWORK_REGISTRY_SIZE; ++i) {
+        const volatile s_network_registry_entry *entry = &N_network_registry.entries[i];
+
+        if ((entry->desc.chain_id != 0) &&
+            (find_dynamic_network_by_chain_id(entry->desc.chain_id) == NULL)) {
+            if (!load_entry(entry)) {
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Persist a verified network descriptor
+ *
+ * The stored networks verified with another certificate are erased. Nothing is written if the very
+ * same descriptor is already stored.
+ *
+ * @param[in] network verified network
+ * @param[in] icon_hash expected icon hash
+ * @param[in] desc_hash hash of the signed descriptor
+ * @return whether it was successful
+ */
+bool network_registry_store(const network_info_t *network,
+                            const uint8_t *icon_hash,
+                            const uint8_t *desc_hash) {
+    s_network_registry_desc desc = {0};
+    volatile s_network_registry_entry *entry;
+    uint32_t generation;
+    bool same;
+
+    // all zeroes if it got verified with the key embedded in the app
+    if (get_network_cert_fingerprint(desc.cert_fingerprint)) {
+        // the entry of this network is about to be replaced, it must not be unloaded
+        erase_untrusted_entries(desc.cert_fingerprint, network->chain_id);
+    } else {
+        explicit_bzero(desc.cert_fingerprint, sizeof(desc.cert_fingerprint));
+    }
+    entry = get_target_entry(network->chain_id, &generation);
+    same = (entry->desc.chain_id == network->chain_id) &&
+           (memcmp((const void *) entry->desc.desc_hash, desc_hash, sizeof(desc.desc_hash)) == 0) &&
+           entry_is_trusted(entry, desc.cert_fingerprint);
+    if (same) {
+        return true;
+    }
+    if ((entry->desc.chain_id != 0) && (entry->desc.chain_id != network->chain_id)) {
+        // evicted network, it stays usable for this session but without its icon
+        drop_loaded_network(entry->desc.chain_id, false);
+    }
+    desc.chain_id = network->chain_id;
+    memcpy(desc.name, network->name, sizeof(desc.name));
+    memcpy(desc.ticker, network->ticker, sizeof(desc.ticker));
+    desc.generation = generation;
+    desc.epoch = NETWORK_REGISTRY_EPOCH;
+    desc.key_usage = CERTIFICATE_PUBLIC_KEY_USAGE_NETWORK;
+    memcpy(desc.desc_hash, desc_hash, sizeof(desc.desc_hash));
+    memcpy(desc.icon_hash, icon_hash, sizeof(desc.icon_hash));
+    desc.crc = desc_crc(&desc);
+    nvm_write((void *) &entry->desc, &desc, sizeof(desc));
+    PRINTF("[NETWORK] - Stored '%s' for chain_id %llu\n", network->name, network->chain_id);
+    return true;
+}
+
+/**
+ * @brief Delete stored networks
+ *
+ * They are also removed from the dynamic networks list, so that they stop being trusted right away.
+ *
+ * @param[in] chain_id chain ID of the network to delete, 0 to delete all of them
+ * @return whether a network was deleted
+ */
+bool network_registry_delete(uint64_t chain_id) {
+    bool deleted = false;
+
+    for (uint8_t i = 0; i < NETWORK_REGISTRY_SIZE; ++i) {
+        volatile s_network_registry_entry *entry = &N_network_registry.entries[i];
+
+        if ((entry->desc.chain_id == 0) ||
+            ((chain_id != 0) && (entry->desc.chain_id != chain_id))) {
+            continue;
+        }
+        PRINTF("[NETWORK] - Deleted stored chain_id %llu\n", entry->desc.chain_id);
+        erase_entry(entry);
+        deleted = true;
+    }
+    return deleted;
+}
+
+/**
+ * @brief Persist the verified icon of a stored network
+ *
+ * @param[in] network network which just received its icon
+ * @param[in] size icon size
+ * @return whether it was successful
+ */
+bool network_registry_store_icon(const network_info_t *network, uint16_t size) {
+    volatile s_network_registry_entry *entry;
+    uint8_t digest[CX_SHA256_SIZE];
+
+    if ((entry = find_entry(network->chain_id)) == NULL) {
+        return false;
+    }
+    if (size > sizeof(entry->icon)) {
+        PRINTF("Network icon too big to be stored (%u)\n", size);
+        return false;
+    }
+    if (cx_sha256_hash(network->icon.bitmap, size, digest) != CX_OK) {
+        return false;
+    }
+    if (memcmp(digest, (const void *) entry->desc.icon_hash, sizeof(digest)) != 0) {
+        PRINTF("Network icon does not match the stored descriptor\n");
+        return false;
+    }
+    if (entry->desc.icon_size == size) {
+        // same hash, already stored
+        return true;
+    }
+    nvm_write((void *) entry->icon, (void *) network->icon.bitmap, size);
+    nvm_write((void *) &entry->desc.icon_size, &size, sizeof(size));
+    return true;
+}
+
+/**
+ * @brief Check if the network icon bitmap lives in the registry
+ *
+ * Such a bitmap must not be freed.
+ *
+ * @param[in] network network
+ * @return whether it is owned by the registry
+ */
+bool network_registry_owns_icon(const network_info_t *network) {
+    const uint8_t *start = (const uint8_t *) &N_network_registry;
+
+    return (network->icon.bitmap >= start) &&
+           (network->icon.bitmap < (start + sizeof(N_network_registry)));
+}
+
+#endif  // HAVE_NETWORK_REGISTRY
@@ -0,0 +1,17 @@
+#pragma once
+
+#ifdef HAVE_NETWORK_REGISTRY
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "network.h"
+
+void network_registry_load(void);
+bool network_registry_store(const network_info_t *network,
+                            const uint8_t *icon_hash,
+                            const uint8_t *desc_hash);
+bool network_registry_delete(uint64_t chain_id);
+bool network_registry_store_icon(const network_info_t *network, uint16_t size);
+bool network_registry_owns_icon(const network_info_t *network);
+
+#endif  // HAVE_NETWORK_REGISTRY
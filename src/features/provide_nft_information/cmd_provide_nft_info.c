@@ -47,6 +47,8 @@
  *   that subsequent commands (for example, transaction signing) can display
  *   or otherwise use the NFT collection information.
  *
+ * @param p2          APDU P2, P2_ASSET_EVICTION_STATUS to also get whether
+ *                    an asset got evicted in the response.
  * @param workBuffer  Pointer to the APDU data buffer containing the NFT
  *                    metadata payload to be parsed and verified.
  * @param dataLength  Length of the data available in workBuffer.
@@ -56,7 +58,8 @@
  * @return SW_OK on success, or an ISO7816-style status word describing the
  *         validation or parsing error encountered.
  */
-uint16_t handle_provide_nft_information(const uint8_t *workBuffer,
+uint16_t handle_provide_nft_information(uint8_t p2,
+                                        const uint8_t *workBuffer,
                                         uint8_t dataLength,
                                         unsigned int *tx) {
     uint8_t hash[INT256_LENGTH];
@@ -214,10 +217,9 @@ uint16_t handle_provide_nft_information(const uint8_t *workBuffer,
     }
 
     // --- Commit the validated metadata ---
-    // Write the asset index into the response buffer, mark the asset info as
-    // validated, and advance the response length by one byte.
-    G_io_tx_buffer[0] = tmpCtx.transactionContext.currentAssetIndex;
-    validate_current_asset_info();
-    *tx += 1;
+    // Write the asset index (and whether an asset got evicted, if requested by P2)
+    // into the response buffer, mark the asset info as validated, and advance the
+    // response length.
+    *tx += validate_current_asset_info(G_io_tx_buffer, p2);
     return SWO_SUCCESS;
 }
@@ -18,6 +18,7 @@ static bool handle_tlv_payload(const buffer_t *buf) {
 
 uint16_t handle_proxy_info(uint8_t p1, uint8_t p2, uint8_t lc, const uint8_t *payload) {
     (void) p2;
+    // well under 255 bytes, so received in a single APDU and parsed in place
     if (!tlv_from_apdu(p1 == P1_FIRST_CHUNK, lc, payload, &handle_tlv_payload)) {
         proxy_cleanup();
         return SWO_INCORRECT_DATA;
@@ -28,6 +28,7 @@ static bool handle_tlv_payload(const buffer_t *buf) {
  * @param[in] length payload size
  */
 uint16_t handle_trusted_name(uint8_t p1, const uint8_t *data, uint8_t length) {
+    // the entries may repeat but not the other tags, which the parser checks over the whole payload
     if (!tlv_from_apdu(p1 == P1_FIRST_CHUNK, length, data, &handle_tlv_payload)) {
         return SWO_INCORRECT_DATA;
     }
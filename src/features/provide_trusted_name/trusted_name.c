@@ -12,23 +12,43 @@
 #include "crypto_helpers.h"
 #include "tlv_utils.h"
 #include "lcx_ecdsa.h"
-#include "shared_context.h"  // CX_SECP256_PUB_KEY_SIZE
+#include "shared_context.h"
 #include "ox_ec.h"
+#include "get_public_key.h"
 
 #define STRUCT_VERSION_1 0x01
 #define STRUCT_VERSION_2 0x02
+// bulk, version 2 names under the same signature
+#define STRUCT_VERSION_3 0x03
+
+#define TRUSTED_NAME_MAX_ENTRIES 64
 
 #define STRUCT_TYPE_TRUSTED_NAME 0x03
 #define SIG_ALGO_SECP256K1       0x01
 
-static s_trusted_name *g_trusted_name_list = NULL;
+// Power of 2, addresses are hash-derived so their last byte is a good enough bucket index
+#define TRUSTED_NAME_BUCKETS 16
+
+// Trusted names indexed by address, each bucket keeps the reception order
+static s_trusted_name *g_trusted_names[TRUSTED_NAME_BUCKETS] = {0};
+
+static s_trusted_name **get_bucket(const uint8_t *addr) {
+    return &g_trusted_names[addr[ADDRESS_LENGTH - 1] & (TRUSTED_NAME_BUCKETS - 1)];
+}
 
 static void delete_trusted_name(s_trusted_name *node) {
     APP_MEM_FREE(node);
 }
 
+static void add_trusted_name(s_trusted_name *node) {
+    ((flist_node_t *) node)->next = NULL;
+    flist_push_back((flist_node_t **) get_bucket(node->addr), (flist_node_t *) node);
+}
+
 void trusted_name_cleanup(void) {
-    flist_clear((flist_node_t **) &g_trusted_name_list, (f_list_node_del) &delete_trusted_name);
+    for (uint8_t i = 0; i < TRUSTED_NAME_BUCKETS; ++i) {
+        flist_clear((flist_node_t **) &g_trusted_names[i], (f_list_node_del) &delete_trusted_name);
+    }
 }
 
 static bool matching_type(e_name_type type, uint8_t type_count, const e_name_type *types) {
@@ -47,49 +67,101 @@ static bool matching_source(e_name_source source,
     return false;
 }
 
+typedef struct {
+    uint8_t type_count;
+    const e_name_type *types;
+    uint8_t source_count;
+    const e_name_source *sources;
+    const uint64_t *chain_id;
+    const uint8_t *addr;
+    // proxy implementation of addr, resolved once per lookup
+    const uint8_t *implem;
+    // lazily evaluated, only needed by version 1 trusted names
+    bool eth_compatible_checked;
+    bool eth_compatible;
+} s_trusted_name_query;
+
+static bool query_chain_is_ethereum_compatible(s_trusted_name_query *query) {
+    if (!query->eth_compatible_checked) {
+        query->eth_compatible = chain_is_ethereum_compatible(query->chain_id);
+        query->eth_compatible_checked = true;
+    }
+    return query->eth_compatible;
+}
+
+/**
+ * Check if a trusted name matches a lookup
+ *
+ * @param[in] trusted_name trusted name
+ * @param[in,out] query lookup parameters
+ * @param[in] via_implem whether the trusted name was found from the proxy implementation
+ * @return whether it matches
+ */
 static bool matching_trusted_name(const s_trusted_name *trusted_name,
-                                  uint8_t type_count,
-                                  const e_name_type *types,
-                                  uint8_t source_count,
-                                  const e_name_source *sources,
-                                  const uint64_t *chain_id,
-                                  const uint8_t *addr) {
-    const uint8_t *tmp;
+                                  s_trusted_name_query *query,
+                                  bool via_implem) {
+    const uint8_t *addr = query->addr;
 
     switch (trusted_name->struct_version) {
         case STRUCT_VERSION_1:
-            if (!matching_type(TN_TYPE_ACCOUNT, type_count, types)) {
+            if (via_implem) {
                 return false;
             }
-            if (!chain_is_ethereum_compatible(chain_id)) {
+            if (!matching_type(TN_TYPE_ACCOUNT, query->type_count, query->types)) {
+                return false;
+            }
+            if (!query_chain_is_ethereum_compatible(query)) {
                 return false;
             }
             break;
         case STRUCT_VERSION_2:
-            if (!matching_type(trusted_name->name_type, type_count, types)) {
+            if (!matching_type(trusted_name->name_type, query->type_count, query->types)) {
                 return false;
             }
-            if (!matching_source(trusted_name->name_source, source_count, sources)) {
+            if (!matching_source(trusted_name->name_source,
+                                 query->source_count,
+                                 query->sources)) {
                 return false;
             }
-            if (*chain_id != trusted_name->chain_id) {
+            if (*query->chain_id != trusted_name->chain_id) {
                 return false;
             }
 
             if ((trusted_name->name_type == TN_TYPE_CONTRACT) ||
                 (trusted_name->name_type == TN_TYPE_TOKEN)) {
-                if ((tmp = get_implem_contract(chain_id, addr, NULL)) != NULL) {
-                    addr = tmp;
+                if (query->implem != NULL) {
+                    addr = query->implem;
                 }
             }
+            if ((addr == query->implem) != via_implem) {
+                // will be (or was) checked from the other bucket
+                return false;
+            }
             break;
+        default:
+            // bulk names are registered as version 2 ones
+            return false;
     }
     return memcmp(addr, trusted_name->addr, ADDRESS_LENGTH) == 0;
 }
 
+static const s_trusted_name *find_in_bucket(const uint8_t *addr,
+                                            s_trusted_name_query *query,
+                                            bool via_implem) {
+    for (s_trusted_name *tmp = *get_bucket(addr); tmp != NULL;
+         tmp = (s_trusted_name *) ((flist_node_t *) tmp)->next) {
+        if (matching_trusted_name(tmp, query, via_implem)) {
+            return tmp;
+        }
+    }
+    return NULL;
+}
+
 /**
  * Get a trusted name that matches the given parameters
  *
+ * A direct address match is preferred over a match on its proxy implementation.
+ *
  * @param[in] types_count number of given trusted name types
  * @param[in] types given trusted name types
  * @param[in] chain_id given chain ID
@@ -102,11 +174,23 @@ const s_trusted_name *get_trusted_name(uint8_t type_count,
                                        const e_name_source *sources,
                                        const uint64_t *chain_id,
                                        const uint8_t *addr) {
-    for (s_trusted_name *tmp = g_trusted_name_list; tmp != NULL;
-         tmp = (s_trusted_name *) ((flist_node_t *) tmp)->next) {
-        if (matching_trusted_name(tmp, type_count, types, source_count, sources, chain_id, addr)) {
-            return tmp;
-        }
+    s_trusted_name_query query = {.type_count = type_count,
+                                  .types = types,
+                                  .source_count = source_count,
+                                  .sources = sources,
+                                  .chain_id = chain_id,
+                                  .addr = addr};
+    const s_trusted_name *trusted_name;
+
+    if (matching_type(TN_TYPE_CONTRACT, type_count, types) ||
+        matching_type(TN_TYPE_TOKEN, type_count, types)) {
+        query.implem = get_implem_contract(chain_id, addr, NULL);
+    }
+    if ((trusted_name = find_in_bucket(addr, &query, false)) != NULL) {
+        return trusted_name;
+    }
+    if (query.implem != NULL) {
+        return find_in_bucket(query.implem, &query, true);
     }
     return NULL;
 }
@@ -139,6 +223,7 @@ static bool handle_struct_version(const tlv_data_t *data, s_trusted_name_ctx *co
     switch (value) {
         case STRUCT_VERSION_1:
         case STRUCT_VERSION_2:
+        case STRUCT_VERSION_3:
             break;
         default:
             PRINTF("Unsupported STRUCTURE_VERSION: %u\n", value);
@@ -453,9 +538,11 @@ static bool handle_signature(const tlv_data_t *data, s_trusted_name_ctx *context
     X(0x72, TAG_NFT_ID, handle_nft_id, ENFORCE_UNIQUE_TAG)                           \
     X(0x74, TAG_OWNER, handle_owner, ENFORCE_UNIQUE_TAG)                             \
     X(0x75, TAG_OWNER_DERIV_PATH, handle_owner_deriv_path, ENFORCE_UNIQUE_TAG)       \
+    X(0x76, TAG_ENTRY, handle_entry, ALLOW_MULTIPLE_TAG)                             \
     X(0x15, TAG_DER_SIGNATURE, handle_signature, ENFORCE_UNIQUE_TAG)
 
-// Forward declaration
+// Forward declarations
+static bool handle_entry(const tlv_data_t *data, s_trusted_name_ctx *context);
 static bool trusted_name_common_handler(const tlv_data_t *data, s_trusted_name_ctx *context);
 
 // Generate parser from X-macro
@@ -469,6 +556,21 @@ DEFINE_TLV_PARSER(TRUSTED_NAME_TAGS, &trusted_name_common_handler, parse_tlv_tru
  * @return whether it was successful
  */
 static bool trusted_name_common_handler(const tlv_data_t *data, s_trusted_name_ctx *context) {
+    if (context->is_entry) {
+        // Entries are hashed as a whole by their parent, and only carry the per-name fields
+        switch (data->tag) {
+            case TAG_TRUSTED_NAME:
+            case TAG_ADDRESS:
+            case TAG_CHAIN_ID:
+            case TAG_TRUSTED_NAME_TYPE:
+            case TAG_TRUSTED_NAME_SOURCE:
+            case TAG_NFT_ID:
+                return true;
+            default:
+                PRINTF("ENTRY: unexpected tag 0x%02x\n", data->tag);
+                return false;
+        }
+    }
     // Hash everything except signature (tag 0x15)
     if (data->tag != TAG_DER_SIGNATURE) {
         hash_nbytes(data->raw.ptr, data->raw.size, (cx_hash_t *) &context->hash_ctx);
@@ -484,7 +586,63 @@ static bool trusted_name_common_handler(const tlv_data_t *data, s_trusted_name_c
  * @return whether parsing was successful
  */
 bool handle_trusted_name_tlv_payload(const buffer_t *payload, s_trusted_name_ctx *context) {
-    return parse_tlv_trusted_name(payload, context, &context->received_tags);
+    if (!parse_tlv_trusted_name(payload, context, &context->received_tags)) {
+        flist_clear((flist_node_t **) &context->entries, (f_list_node_del) &delete_trusted_name);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Handler for tag ENTRY
+ *
+ * Only the per-name fields of a version 2 struct are accepted in an entry. The name is only kept
+ * aside, it gets verified with the whole struct.
+ *
+ * @param[in] data the tlv data
+ * @param[in,out] context the trusted name context
+ * @return whether it was successful
+ */
+static bool handle_entry(const tlv_data_t *data, s_trusted_name_ctx *context) {
+    s_trusted_name_ctx entry_ctx = {0};
+    s_trusted_name *node;
+
+    if (context->is_entry) {
+        PRINTF("ENTRY: nested entries are not allowed\n");
+        return false;
+    }
+    if (context->entry_count == TRUSTED_NAME_MAX_ENTRIES) {
+        PRINTF("ENTRY: too many entries\n");
+        return false;
+    }
+    entry_ctx.is_entry = true;
+    entry_ctx.trusted_name.struct_version = STRUCT_VERSION_2;
+    if (!handle_trusted_name_tlv_payload(&data->value, &entry_ctx)) {
+        PRINTF("ENTRY: failed to parse\n");
+        return false;
+    }
+    if (!TLV_CHECK_RECEIVED_TAGS(entry_ctx.received_tags,
+                                 TAG_TRUSTED_NAME,
+                                 TAG_ADDRESS,
+                                 TAG_CHAIN_ID,
+                                 TAG_TRUSTED_NAME_TYPE,
+                                 TAG_TRUSTED_NAME_SOURCE)) {
+        PRINTF("ENTRY: missing mandatory fields\n");
+        return false;
+    }
+    // The policy checks and the lookups rely on it
+    if (entry_ctx.trusted_name.struct_version != STRUCT_VERSION_2) {
+        PRINTF("ENTRY: unexpected struct version (%u)\n", entry_ctx.trusted_name.struct_version);
+        return false;
+    }
+    if ((node = APP_MEM_ALLOC(sizeof(*node))) == NULL) {
+        PRINTF("Error: could not allocate trusted name struct!\n");
+        return false;
+    }
+    memcpy(node, &entry_ctx.trusted_name, sizeof(*node));
+    flist_push_back((flist_node_t **) &context->entries, (flist_node_t *) node);
+    context->entry_count += 1;
+    return true;
 }
 
 /**
@@ -514,6 +672,49 @@ static bool verify_signature(const s_trusted_name_ctx *context) {
     return true;
 }
 
+/**
+ * @brief Verify the received fields of a bulk struct
+ *
+ * The names only come from the entries, the struct level fields apply to all of them.
+ *
+ * @param[in] context Trusted name context
+ * @return whether it was successful
+ */
+static bool verify_bulk_fields(const s_trusted_name_ctx *context) {
+    bool has_account = false;
+    bool has_mab = false;
+
+    if (context->entry_count == 0) {
+        PRINTF("Error: no entry in bulk trusted names!\n");
+        return false;
+    }
+    if (TLV_CHECK_RECEIVED_TAGS(context->received_tags, TAG_TRUSTED_NAME) ||
+        TLV_CHECK_RECEIVED_TAGS(context->received_tags, TAG_ADDRESS) ||
+        TLV_CHECK_RECEIVED_TAGS(context->received_tags, TAG_COIN_TYPE) ||
+        TLV_CHECK_RECEIVED_TAGS(context->received_tags, TAG_CHAIN_ID) ||
+        TLV_CHECK_RECEIVED_TAGS(context->received_tags, TAG_TRUSTED_NAME_TYPE) ||
+        TLV_CHECK_RECEIVED_TAGS(context->received_tags, TAG_TRUSTED_NAME_SOURCE) ||
+        TLV_CHECK_RECEIVED_TAGS(context->received_tags, TAG_NFT_ID)) {
+        PRINTF("Error: unexpected name fields outside of the entries!\n");
+        return false;
+    }
+    for (const s_trusted_name *tmp = context->entries; tmp != NULL;
+         tmp = (s_trusted_name *) ((flist_node_t *) tmp)->next) {
+        has_account |= (tmp->name_type == TN_TYPE_ACCOUNT);
+        has_mab |= (tmp->name_source == TN_SOURCE_MAB);
+    }
+    if (has_account && !TLV_CHECK_RECEIVED_TAGS(context->received_tags, TAG_CHALLENGE)) {
+        PRINTF("Error: trusted account name requires a challenge!\n");
+        return false;
+    }
+    if (has_mab &&
+        !TLV_CHECK_RECEIVED_TAGS(context->received_tags, TAG_OWNER, TAG_OWNER_DERIV_PATH)) {
+        PRINTF("Error: did not receive owner and/or deriv path for MAB source!\n");
+        return false;
+    }
+    return true;
+}
+
 /**
  * @brief Verify the received fields
  *
@@ -529,9 +730,14 @@ static bool verify_fields(const s_trusted_name_ctx *context) {
                                  TAG_STRUCTURE_VERSION,
                                  TAG_SIGNER_KEY_ID,
                                  TAG_SIGNER_ALGO,
-                                 TAG_DER_SIGNATURE,
-                                 TAG_TRUSTED_NAME,
-                                 TAG_ADDRESS)) {
+                                 TAG_DER_SIGNATURE)) {
+        return false;
+    }
+    if (context->trusted_name.struct_version == STRUCT_VERSION_3) {
+        return verify_bulk_fields(context);
+    }
+    if ((context->entry_count > 0) ||
+        !TLV_CHECK_RECEIVED_TAGS(context->received_tags, TAG_TRUSTED_NAME, TAG_ADDRESS)) {
         return false;
     }
 
@@ -641,31 +847,27 @@ static bool check_trusted_name(const char *name, bool (*check_func)(char)) {
 }
 
 /**
- * Verify the validity of the received trusted struct
+ * Verify the content of a trusted name
  *
- * @param[in] context the trusted name context
- * @return whether the struct is valid
+ * @param[in] trusted_name the trusted name
+ * @param[in] context the trusted name context, for the struct level fields
+ * @return whether it is valid
  */
-bool verify_trusted_name_struct(const s_trusted_name_ctx *context) {
-    s_trusted_name *node = NULL;
-    if (!verify_fields(context)) {
-        PRINTF("Error: Missing mandatory fields in descriptor!\n");
-        return false;
-    }
-
-    if (context->trusted_name.struct_version == STRUCT_VERSION_2) {
-        switch (context->trusted_name.name_type) {
+static bool verify_trusted_name_content(const s_trusted_name *trusted_name,
+                                        const s_trusted_name_ctx *context) {
+    if (trusted_name->struct_version == STRUCT_VERSION_2) {
+        switch (trusted_name->name_type) {
             case TN_TYPE_ACCOUNT:
-                if (context->trusted_name.name_source == TN_SOURCE_CAL) {
+                if (trusted_name->name_source == TN_SOURCE_CAL) {
                     PRINTF("Error: cannot accept an account name from the CAL!\n");
                     return false;
                 }
                 break;
             case TN_TYPE_CONTRACT:
             case TN_TYPE_TOKEN:
-                if (context->trusted_name.name_source != TN_SOURCE_CAL) {
+                if (trusted_name->name_source != TN_SOURCE_CAL) {
                     PRINTF("Error: cannot accept a contract name from given source (%u)!\n",
-                           context->trusted_name.name_source);
+                           trusted_name->name_source);
                     return false;
                 }
                 break;
@@ -673,20 +875,14 @@ bool verify_trusted_name_struct(const s_trusted_name_ctx *context) {
                 return false;
         }
         // MAB source requires OWNER
-        if (context->trusted_name.name_source == TN_SOURCE_MAB) {
-            uint8_t raw_pubkey[CX_SECP256_PUB_KEY_SIZE];
+        if (trusted_name->name_source == TN_SOURCE_MAB) {
             uint8_t wallet_addr[ADDRESS_LENGTH];
 
-            if (bip32_derive_get_pubkey_256(CX_CURVE_256K1,
-                                            context->owner_deriv_path.path,
-                                            context->owner_deriv_path.length,
-                                            raw_pubkey,
-                                            NULL,
-                                            CX_SHA512) != CX_OK) {
-                PRINTF("Error: could not derive pubkey!\n");
+            if (get_public_key_from_path(&context->owner_deriv_path,
+                                         wallet_addr,
+                                         sizeof(wallet_addr)) != SWO_SUCCESS) {
                 return false;
             }
-            getEthAddressFromRawKey(raw_pubkey, wallet_addr);
 
             if (memcmp(context->owner, wallet_addr, sizeof(wallet_addr)) != 0) {
                 PRINTF("Error: mismatching owner received (0x%.*h vs 0x%.*h) !\n",
@@ -699,34 +895,79 @@ bool verify_trusted_name_struct(const s_trusted_name_ctx *context) {
         }
     }
 
-    size_t name_length = strnlen(context->trusted_name.name, sizeof(context->trusted_name.name));
-    if ((context->trusted_name.struct_version == STRUCT_VERSION_1) ||
-        ((context->trusted_name.name_type == TN_TYPE_ACCOUNT) &&
-         (context->trusted_name.name_source == TN_SOURCE_ENS))) {
+    size_t name_length = strnlen(trusted_name->name, sizeof(trusted_name->name));
+    if ((trusted_name->struct_version == STRUCT_VERSION_1) ||
+        ((trusted_name->name_type == TN_TYPE_ACCOUNT) &&
+         (trusted_name->name_source == TN_SOURCE_ENS))) {
         if ((name_length < 5) ||
-            (strncmp(".eth", (char *) &context->trusted_name.name[name_length - 4], 4) != 0)) {
+            (strncmp(".eth", (char *) &trusted_name->name[name_length - 4], 4) != 0)) {
             PRINTF("Unexpected TLD!\n");
             return false;
         }
-        if (!check_trusted_name(context->trusted_name.name, &ens_charset)) {
+        if (!check_trusted_name(trusted_name->name, &ens_charset)) {
             return false;
         }
     } else {
-        if (!check_trusted_name(context->trusted_name.name, &generic_trusted_name_charset)) {
+        if (!check_trusted_name(trusted_name->name, &generic_trusted_name_charset)) {
             return false;
         }
     }
+    return true;
+}
 
-    if (!verify_signature(context)) {
+/**
+ * Verify the validity of the received trusted struct
+ *
+ * @param[in] context the trusted name context
+ * @return whether the struct is valid
+ */
+static bool verify_struct(const s_trusted_name_ctx *context) {
+    if (!verify_fields(context)) {
+        PRINTF("Error: Missing mandatory fields in descriptor!\n");
         return false;
     }
+    if (context->trusted_name.struct_version == STRUCT_VERSION_3) {
+        for (const s_trusted_name *tmp = context->entries; tmp != NULL;
+             tmp = (s_trusted_name *) ((flist_node_t *) tmp)->next) {
+            if (!verify_trusted_name_content(tmp, context)) {
+                return false;
+            }
+        }
+    } else if (!verify_trusted_name_content(&context->trusted_name, context)) {
+        return false;
+    }
+    return verify_signature(context);
+}
+
+/**
+ * Verify the validity of the received trusted struct, and register its name(s)
+ *
+ * @param[in,out] context the trusted name context
+ * @return whether the struct is valid
+ */
+bool verify_trusted_name_struct(s_trusted_name_ctx *context) {
+    s_trusted_name *node = NULL;
+
+    if (!verify_struct(context)) {
+        flist_clear((flist_node_t **) &context->entries, (f_list_node_del) &delete_trusted_name);
+        return false;
+    }
+
+    if (context->trusted_name.struct_version == STRUCT_VERSION_3) {
+        while ((node = context->entries) != NULL) {
+            context->entries = (s_trusted_name *) ((flist_node_t *) node)->next;
+            add_trusted_name(node);
+        }
+        PRINTF("[TRUSTED NAME] - Registered %u trusted names\n", context->entry_count);
+        return true;
+    }
 
     if ((node = APP_MEM_ALLOC(sizeof(*node))) == NULL) {
         PRINTF("Error: could not allocate trusted name struct!\n");
         return false;
     }
     memcpy(node, &context->trusted_name, sizeof(*node));
-    flist_push_back((flist_node_t **) &g_trusted_name_list, (flist_node_t *) node);
+    add_trusted_name(node);
 
     print_trusted_name_info(context);
     return true;
@@ -62,6 +62,11 @@ typedef struct {
     uint8_t owner[ADDRESS_LENGTH];
     bip32_path_t owner_deriv_path;
     TLV_reception_t received_tags;
+    // bulk struct, names kept aside until the signature is verified
+    s_trusted_name *entries;
+    uint8_t entry_count;
+    // part of a bulk struct, hashed by its parent and restricted to the per-name fields
+    bool is_entry;
 } s_trusted_name_ctx;
 // clang-format on
 
@@ -73,5 +78,5 @@ const s_trusted_name *get_trusted_name(uint8_t type_count,
                                        const uint8_t *addr);
 
 bool handle_trusted_name_tlv_payload(const buffer_t *buf, s_trusted_name_ctx *context);
-bool verify_trusted_name_struct(const s_trusted_name_ctx *ctx);
+bool verify_trusted_name_struct(s_trusted_name_ctx *ctx);
 void trusted_name_cleanup(void);
@@ -4,6 +4,7 @@
 #include "eth_plugin_internal.h"
 #include "plugin_utils.h"
 #include "os_pki.h"
+#include "syscall_stats.h"
 
 uint16_t handle_set_external_plugin(const uint8_t *workBuffer, uint8_t dataLength) {
     PRINTF("Handling set Plugin\n");
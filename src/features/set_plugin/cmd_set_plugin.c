@@ -5,6 +5,7 @@
 #include "network.h"
 #include "public_keys.h"
 #include "os_pki.h"
+#include "syscall_stats.h"
 
 // Supported internal plugins
 #define ERC721_STR  "ERC721"
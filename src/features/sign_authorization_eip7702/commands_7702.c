@@ -14,6 +14,7 @@
 #include "get_public_key.h"
 #include "mem_utils.h"
 #include "hash_bytes.h"
+#include "syscall_stats.h"
 
 // Avoid saving the full structure when parsing
 // Alternative option : add a callback to f_tlv_payload_handler
@@ -3,9 +3,11 @@
 #include "ui_callbacks.h"
 #include "apdu_constants.h"
 #include "crypto_helpers.h"
+#include "phase_trace.h"
 
 unsigned int auth_7702_ok_cb(void) {
     uint32_t info = 0;
+    PHASE_BEGIN(SIGNATURE, 0);
     CX_ASSERT(bip32_derive_ecdsa_sign_rs_hash_256(CX_CURVE_256K1,
                                                   tmpCtx.authSigningContext7702.bip32.path,
                                                   tmpCtx.authSigningContext7702.bip32.length,
@@ -16,6 +18,7 @@ unsigned int auth_7702_ok_cb(void) {
                                                   G_io_tx_buffer + 1,
                                                   G_io_tx_buffer + 1 + INT256_LENGTH,
                                                   &info));
+    PHASE_END(SIGNATURE, 0);
     if (info & CX_ECCINFO_PARITY_ODD) {
         G_io_tx_buffer[0] = 1;
     } else {
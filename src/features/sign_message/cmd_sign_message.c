@@ -7,6 +7,7 @@
 #include "ui_utils.h"
 #include "mem_utils.h"
 #include "hash_bytes.h"
+#include "syscall_stats.h"
 
 typedef struct {
     uint16_t msg_length;
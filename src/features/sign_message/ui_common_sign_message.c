@@ -2,9 +2,11 @@
 #include "apdu_constants.h"
 #include "crypto_helpers.h"
 #include "ui_callbacks.h"
+#include "phase_trace.h"
 
 unsigned int io_seproxyhal_touch_signMessage_ok(void) {
     unsigned int info = 0;
+    PHASE_BEGIN(SIGNATURE, 0);
     CX_ASSERT(bip32_derive_ecdsa_sign_rs_hash_256(CX_CURVE_256K1,
                                                   tmpCtx.messageSigningContext.bip32.path,
                                                   tmpCtx.messageSigningContext.bip32.length,
@@ -15,6 +17,7 @@ unsigned int io_seproxyhal_touch_signMessage_ok(void) {
                                                   G_io_tx_buffer + 1,
                                                   G_io_tx_buffer + 1 + INT256_LENGTH,
                                                   &info));
+    PHASE_END(SIGNATURE, 0);
     G_io_tx_buffer[0] = ETHEREUM_SIGNATURE_V_BASE;
     if (info & CX_ECCINFO_PARITY_ODD) {
         G_io_tx_buffer[0]++;
@@ -5,6 +5,7 @@
 #include "ui_logic.h"
 #include "typed_data.h"
 #include "schema_hash.h"
+#include "schema_cache.h"
 #include "filtering.h"
 #include "common_ui.h"  // ui_idle
 #include "manage_asset_info.h"
@@ -18,6 +19,7 @@
 
 // APDUs P2
 #define P2_DEF_NAME               0x00
+#define P2_DEF_CACHED             0x0F
 #define P2_DEF_FIELD              0xFF
 #define P2_IMPL_NAME              P2_DEF_NAME
 #define P2_IMPL_ARRAY             0x0F
@@ -98,10 +100,17 @@ uint16_t handle_eip712_struct_def(uint8_t p2, const uint8_t *cdata, uint8_t leng
     if (ret) {
         switch (p2) {
             case P2_DEF_NAME:
-                ret = set_struct_name(length, cdata);
+                if ((ret = set_struct_name(length, cdata))) {
+                    schema_cache_record_def(p2, cdata, length);
+                }
                 break;
             case P2_DEF_FIELD:
-                ret = set_struct_field(length, cdata);
+                if ((ret = set_struct_field(length, cdata))) {
+                    schema_cache_record_def(p2, cdata, length);
+                }
+                break;
+            case P2_DEF_CACHED:
+                ret = schema_cache_load(cdata, length);
                 break;
             default:
                 PRINTF("Unknown P2 0x%x\n", p2);
@@ -135,6 +144,10 @@ uint16_t handle_eip712_struct_impl(uint8_t p1,
     } else {
         switch (p2) {
             case P2_IMPL_NAME:
+                if (struct_state != DEFINED) {
+                    // all the struct definitions have been received
+                    schema_cache_store();
+                }
                 // set root type
                 ret = path_set_root((char *) cdata, length);
                 if (ret) {
@@ -6,6 +6,7 @@
 #include "field_hash.h"
 #include "ui_logic.h"
 #include "typed_data.h"
+#include "schema_cache.h"
 #include "apdu_constants.h"  // APDU response codes
 #include "shared_context.h"  // reset_app_context
 #include "common_ui.h"       // ui_idle
@@ -66,6 +67,7 @@ void eip712_context_deinit(void) {
     field_hash_deinit();
     ui_712_deinit();
     sol_typenames_deinit();
+    schema_cache_discard_recording();
     APP_MEM_FREE_AND_NULL((void **) &eip712_context);
     reset_app_context();
 }
@@ -11,6 +11,7 @@
 #include "typed_data.h"
 #include "commands_712.h"
 #include "hash_bytes.h"
+#include "syscall_stats.h"
 
 static s_field_hashing *fh = NULL;
 
@@ -165,7 +166,7 @@ static bool field_hash_domain_special_fields(const s_struct_712_field *field_ptr
     const char *key;
     const char *ethermint_vc = "cosmos";
 
-    key = field_ptr->key_name;
+    key = get_struct_field_keyname(field_ptr);
     // copy contract address into context
     if (strcmp(key, "verifyingContract") == 0) {
         switch (field_ptr->type) {
@@ -55,25 +55,26 @@ static bool hash_filtering_path(cx_hash_t *hash_ctx, bool discarded, uint32_t *p
         for (uint8_t i = 0; i < path_get_depth_count(); ++i) {
             if (i > 0) {
                 hash_byte('.', hash_ctx);
-                *path_crc = cx_crc32_update(*path_crc, ".", 1);
             }
             if ((field_ptr = path_get_nth_field(i + 1)) == NULL) {
                 return false;
             }
-            if ((key = field_ptr->key_name) != NULL) {
+            if ((key = get_struct_field_keyname(field_ptr)) != NULL) {
                 // field name
                 hash_nbytes((uint8_t *) key, strlen(key), hash_ctx);
-                *path_crc = cx_crc32_update(*path_crc, key, strlen(key));
 
                 // array levels
                 if (field_ptr->type_is_array) {
                     for (int j = 0; j < field_ptr->array_level_count; ++j) {
                         hash_nbytes((uint8_t *) ".[]", 3, hash_ctx);
-                        *path_crc = cx_crc32_update(*path_crc, ".[]", 3);
                     }
                 }
             }
         }
+        // kept up to date along the path, no need to go through the strings again
+        if (!path_get_crc(path_crc)) {
+            return false;
+        }
     }
     // so it is only usable for the following filter
     ui_712_clear_discarded_path();
@@ -241,7 +242,9 @@ bool filtering_message_info(const uint8_t *payload, uint8_t length) {
     }
 
     // Handling
-    ui_712_set_filters_count(filters_count);
+    if (!ui_712_set_filters_count(filters_count)) {
+        return false;
+    }
     if (!N_storage.verbose_eip712) {
         ui_712_set_title("Contract", 8);
         ui_712_set_value(name, name_len);
@@ -273,7 +276,7 @@ static bool matches_backup_path(const char *path, uint8_t path_len, uint8_t *off
             offset += 1;
         }
         if ((field_ptr = path_backup_get_nth_field(i + 1)) != NULL) {
-            if ((key = field_ptr->key_name) != NULL) {
+            if ((key = get_struct_field_keyname(field_ptr)) != NULL) {
                 // field name
                 if (((offset + strlen(key)) > path_len) ||
                     (memcmp(path + offset, key, strlen(key)) != 0)) {
@@ -49,17 +49,20 @@ static bool format_hash_field_type_size(const s_struct_712_field *field_ptr, cx_
  */
 static bool format_hash_field_type_array_levels(const s_struct_712_field *field_ptr,
                                                 cx_hash_t *hash_ctx) {
+    const s_struct_712_field_array_level *array_levels;
     const char *uint_str_ptr;
 
+    if ((array_levels = get_struct_field_array_levels(field_ptr)) == NULL) {
+        return false;
+    }
     for (int i = 0; i < field_ptr->array_level_count; ++i) {
         hash_byte('[', hash_ctx);
 
-        switch (field_ptr->array_levels[i].type) {
+        switch (array_levels[i].type) {
             case ARRAY_DYNAMIC:
                 break;
             case ARRAY_FIXED_SIZE:
-                if ((uint_str_ptr = mem_alloc_and_format_uint(field_ptr->array_levels[i].size)) ==
-                    NULL) {
+                if ((uint_str_ptr = mem_alloc_and_format_uint(array_levels[i].size)) == NULL) {
                     apdu_response_code = SWO_INSUFFICIENT_MEMORY;
                     return false;
                 }
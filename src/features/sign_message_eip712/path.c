@@ -8,11 +8,16 @@
 #include "apdu_constants.h"  // APDU response codes
 #include "typed_data.h"
 #include "hash_bytes.h"
+#include "cx.h"
+#include "syscall_stats.h"
 
 static s_path *path_struct = NULL;
 static s_path *path_backup = NULL;
 
-static s_hash_ctx *g_hash_ctxs = NULL;
+// hashing contexts stack, the slots are kept once allocated so they can be reused by the
+// following struct or array elements
+static s_hash_ctx *g_hash_ctxs[MAX_HASH_DEPTH] = {0};
+static uint8_t g_hash_ctxs_count = 0;
 
 /**
  * Get the field pointer to by the first N depths of the given path
@@ -25,7 +30,6 @@ static s_hash_ctx *g_hash_ctxs = NULL;
 static const void *get_nth_field_from(const s_path *path, uint8_t *fields_count_ptr, uint8_t n) {
     const s_struct_712 *struct_ptr = NULL;
     const s_struct_712_field *field_ptr = NULL;
-    const char *typename;
 
     if (path == NULL) {
         return NULL;
@@ -38,25 +42,17 @@ static const void *get_nth_field_from(const s_path *path, uint8_t *fields_count_
         return NULL;
     }
     for (uint8_t depth = 0; depth < n; ++depth) {
-        if ((field_ptr = struct_ptr->fields) == NULL) {
+        if (struct_ptr == NULL) {
             return NULL;
         }
         if (fields_count_ptr != NULL) {
-            *fields_count_ptr = 0;
-            for (const s_struct_712_field *tmp = field_ptr; tmp != NULL;
-                 tmp = (s_struct_712_field *) ((flist_node_t *) tmp)->next) {
-                *fields_count_ptr += 1;
-            }
+            *fields_count_ptr = struct_ptr->field_count;
         }
-
-        for (uint8_t index = 0; index < path->depths[depth]; ++index) {
-            if ((field_ptr = (s_struct_712_field *) ((flist_node_t *) field_ptr)->next) == NULL) {
-                return NULL;
-            }
+        if ((field_ptr = get_struct_field_at(struct_ptr, path->depths[depth])) == NULL) {
+            return NULL;
         }
         if (field_ptr->type == TYPE_CUSTOM) {
-            typename = get_struct_field_typename(field_ptr);
-            if ((struct_ptr = get_structn(typename, strlen(typename))) == NULL) {
+            if ((struct_ptr = get_struct_field_custom_struct(field_ptr)) == NULL) {
                 return NULL;
             }
         }
@@ -64,6 +60,17 @@ static const void *get_nth_field_from(const s_path *path, uint8_t *fields_count_
     return field_ptr;
 }
 
+/**
+ * Mark the CRCs of the depths past the given count as outdated
+ *
+ * @param[in] depth_count number of leading depths left untouched
+ */
+static void invalidate_depth_crcs(uint8_t depth_count) {
+    if (path_struct->valid_crc_count > depth_count) {
+        path_struct->valid_crc_count = depth_count;
+    }
+}
+
 static const void *get_nth_field(uint8_t *fields_count_ptr, uint8_t n) {
     return get_nth_field_from(path_struct, fields_count_ptr, n);
 }
@@ -99,14 +106,12 @@ const void *path_backup_get_nth_field(uint8_t n) {
  * @return pointer to the matching field, \ref NULL otherwise
  */
 const void *path_get_nth_field_to_last(uint8_t n) {
-    const char *typename;
     const void *field_ptr;
     const void *struct_ptr = NULL;
 
     field_ptr = get_nth_field(NULL, path_struct->depth_count - n);
     if (field_ptr != NULL) {
-        typename = get_struct_field_typename(field_ptr);
-        struct_ptr = get_structn(typename, strlen(typename));
+        struct_ptr = get_struct_field_custom_struct(field_ptr);
     }
     return struct_ptr;
 }
@@ -134,6 +139,7 @@ static bool path_depth_list_push(void) {
     }
     path_struct->depths[path_struct->depth_count] = 0;
     path_struct->depth_count += 1;
+    invalidate_depth_crcs(path_struct->depth_count - 1);
     return true;
 }
 
@@ -143,12 +149,10 @@ static bool path_depth_list_push(void) {
  * @return pointer to the hashing context
  */
 s_hash_ctx *get_last_hash_ctx(void) {
-    flist_node_t *hash_ctx = (flist_node_t *) g_hash_ctxs;
-
-    while ((hash_ctx != NULL) && (hash_ctx->next != NULL)) {
-        hash_ctx = hash_ctx->next;
+    if (g_hash_ctxs_count == 0) {
+        return NULL;
     }
-    return (s_hash_ctx *) hash_ctx;
+    return g_hash_ctxs[g_hash_ctxs_count - 1];
 }
 
 /**
@@ -160,16 +164,18 @@ static s_hash_ctx *get_previous_hash_ctx(s_hash_ctx *hash_ctx) {
     if (hash_ctx == NULL) {
         return NULL;
     }
-    return (s_hash_ctx *) ((list_node_t *) hash_ctx)->prev;
-}
-
-// to be used as a \ref f_list_node_del
-static void delete_hash_ctx(s_hash_ctx *ctx) {
-    APP_MEM_FREE(ctx);
+    for (uint8_t i = 1; i < g_hash_ctxs_count; ++i) {
+        if (g_hash_ctxs[i] == hash_ctx) {
+            return g_hash_ctxs[i - 1];
+        }
+    }
+    return NULL;
 }
 
 static void remove_last_hash_ctx(void) {
-    list_pop_back((list_node_t **) &g_hash_ctxs, (f_list_node_del) &delete_hash_ctx);
+    if (g_hash_ctxs_count > 0) {
+        g_hash_ctxs_count -= 1;
+    }
 }
 
 /**
@@ -224,20 +230,25 @@ static bool feed_last_hash_depth(const uint8_t *hash) {
  * @return whether the memory allocation of the hashing context was successful
  */
 static bool push_new_hash_depth(bool init) {
-    s_hash_ctx *hash_ctx;
+    s_hash_ctx **hash_ctx;
 
-    // allocate new hash context
-    if (APP_MEM_CALLOC((void **) &hash_ctx, sizeof(*hash_ctx)) == false) {
+    if (g_hash_ctxs_count == MAX_HASH_DEPTH) {
+        PRINTF("Error: too many hashing depths\n");
         return false;
     }
+    hash_ctx = &g_hash_ctxs[g_hash_ctxs_count];
+    // only allocated the first time this depth is reached
+    if (*hash_ctx == NULL) {
+        if (APP_MEM_CALLOC((void **) hash_ctx, sizeof(**hash_ctx)) == false) {
+            return false;
+        }
+    }
     if (init) {
-        if (cx_keccak_init_no_throw(&hash_ctx->hash, 256) != CX_OK) {
-            APP_MEM_FREE(hash_ctx);
+        if (cx_keccak_init_no_throw(&(*hash_ctx)->hash, 256) != CX_OK) {
             return false;
         }
     }
-
-    list_push_back((list_node_t **) &g_hash_ctxs, (list_node_t *) hash_ctx);
+    g_hash_ctxs_count += 1;
     return true;
 }
 
@@ -257,6 +268,7 @@ static bool path_depth_list_pop(void) {
         return false;
     }
     path_struct->depth_count -= 1;
+    invalidate_depth_crcs(path_struct->depth_count);
 
     to_feed = finalize_hash_depth(hash);
     if (path_struct->depth_count > 0) {
@@ -378,13 +390,13 @@ static bool path_update(bool skip_if_array, bool stop_at_array, bool do_typehash
                 }
             }
         }
-        typename = get_struct_field_typename(field_ptr);
-        if ((struct_ptr = get_structn(typename, strlen(typename))) == NULL) {
+        if ((struct_ptr = get_struct_field_custom_struct(field_ptr)) == NULL) {
             return false;
         }
-        if ((field_ptr = struct_ptr->fields) == NULL) {
+        if ((field_ptr = get_struct_fields(struct_ptr)) == NULL) {
             return false;
         }
+        typename = get_struct_name(struct_ptr);
 
         if (push_new_hash_depth(true) == false) {
             return false;
@@ -456,6 +468,7 @@ bool path_set_root(const char *struct_name, uint8_t name_length) {
 
     // init depth, at 0 : empty path
     path_struct->depth_count = 0;
+    invalidate_depth_crcs(0);
     path_depth_list_push();
 
     // init array levels at 0
@@ -490,7 +503,7 @@ bool path_set_root(const char *struct_name, uint8_t name_length) {
  * @param[in] size requested array depth size
  * @return whether the checks and add were successful or not
  */
-static bool check_and_add_array_depth(s_struct_712_field_array_level *array_lvl,
+static bool check_and_add_array_depth(const s_struct_712_field_array_level *array_lvl,
                                       uint8_t total_count,
                                       uint8_t pidx,
                                       uint8_t size) {
@@ -569,13 +582,13 @@ bool path_new_array_depth(const uint8_t *data, uint8_t length) {
             return false;
         }
         if (field_ptr->type_is_array) {
-            if (field_ptr->array_levels == NULL) {
+            if (get_struct_field_array_levels(field_ptr) == NULL) {
                 apdu_response_code = SWO_INCORRECT_DATA;
                 return false;
             }
             total_count += field_ptr->array_level_count;
             if (total_count > path_struct->array_depth_count) {
-                if (!check_and_add_array_depth(field_ptr->array_levels,
+                if (!check_and_add_array_depth(get_struct_field_array_levels(field_ptr),
                                                total_count,
                                                pidx,
                                                array_size)) {
@@ -649,6 +662,7 @@ static bool path_advance_in_struct(void) {
     }
     if (path_struct->depth_count > 0) {
         *depth += 1;
+        invalidate_depth_crcs(path_struct->depth_count - 1);
         end_reached = (*depth == fields_count);
     }
     if (end_reached) {
@@ -751,6 +765,44 @@ uint8_t path_get_depth_count(void) {
     return get_depth_count(path_struct);
 }
 
+/**
+ * Get the CRC of the current path, as used by the filters
+ *
+ * The path is formed of the key names joined by dots, each followed by ".[]" per array level.
+ * Only the depths which changed since the last call get processed.
+ *
+ * @param[out] crc the path CRC
+ * @return whether it was successful or not
+ */
+bool path_get_crc(uint32_t *crc) {
+    const s_struct_712_field *field_ptr;
+    const char *key;
+    uint32_t value;
+
+    if (path_struct == NULL) {
+        return false;
+    }
+    for (uint8_t i = path_struct->valid_crc_count; i < path_struct->depth_count; ++i) {
+        value = (i > 0) ? cx_crc32_update(path_struct->depth_crcs[i - 1], ".", 1) : 0;
+        if ((field_ptr = get_nth_field(NULL, i + 1)) == NULL) {
+            return false;
+        }
+        if ((key = get_struct_field_keyname(field_ptr)) != NULL) {
+            value = cx_crc32_update(value, key, strlen(key));
+            if (field_ptr->type_is_array) {
+                for (int j = 0; j < field_ptr->array_level_count; ++j) {
+                    value = cx_crc32_update(value, ".[]", 3);
+                }
+            }
+        }
+        path_struct->depth_crcs[i] = value;
+        path_struct->valid_crc_count = i + 1;
+    }
+    *crc = (path_struct->depth_count > 0) ? path_struct->depth_crcs[path_struct->depth_count - 1]
+                                          : 0;
+    return true;
+}
+
 /**
  * Get the current amount of depth in the backup path
  *
@@ -771,7 +823,6 @@ bool path_exists_in_backup(const char *path, size_t length) {
     size_t offset = 0;
     size_t i;
     const s_struct_712_field *field_ptr;
-    const char *typename;
     const s_struct_712 *struct_ptr;
     const char *key;
 
@@ -791,13 +842,12 @@ bool path_exists_in_backup(const char *path, size_t length) {
         } else if (offset < length) {
             for (i = 0; ((offset + i) < length) && (path[offset + i] != '.'); ++i)
                 ;
-            typename = field_ptr->type_name;
-            if ((struct_ptr = get_structn(typename, strlen(typename))) == NULL) {
+            if ((struct_ptr = get_struct_field_custom_struct(field_ptr)) == NULL) {
                 return false;
             }
-            for (field_ptr = struct_ptr->fields; field_ptr != NULL;
-                 field_ptr = (s_struct_712_field *) ((flist_node_t *) field_ptr)->next) {
-                key = field_ptr->key_name;
+            for (field_ptr = get_struct_fields(struct_ptr); field_ptr != NULL;
+                 field_ptr = get_next_struct_field(field_ptr)) {
+                key = get_struct_field_keyname(field_ptr);
                 if ((strlen(key) == i) && (memcmp(key, path + offset, i) == 0)) {
                     break;
                 }
@@ -837,5 +887,9 @@ bool path_init(void) {
 void path_deinit(void) {
     APP_MEM_FREE_AND_NULL((void **) &path_struct);
     APP_MEM_FREE_AND_NULL((void **) &path_backup);
-    list_clear((list_node_t **) &g_hash_ctxs, (f_list_node_del) &delete_hash_ctx);
+    // in reverse order of allocation
+    for (uint8_t i = MAX_HASH_DEPTH; i > 0; --i) {
+        APP_MEM_FREE_AND_NULL((void **) &g_hash_ctxs[i - 1]);
+    }
+    g_hash_ctxs_count = 0;
 }
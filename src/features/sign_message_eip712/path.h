@@ -8,6 +8,8 @@
 
 #define MAX_PATH_DEPTH  16
 #define MAX_ARRAY_DEPTH 8
+// one hashing context per struct depth and per array depth
+#define MAX_HASH_DEPTH  (MAX_PATH_DEPTH + MAX_ARRAY_DEPTH)
 
 typedef struct {
     uint8_t path_index;
@@ -24,10 +26,13 @@ typedef struct {
     s_array_depth array_depths[MAX_ARRAY_DEPTH];
     const s_struct_712 *root_struct;
     e_root_type root_type;
+    // CRC of the path up to each depth, as used by the filters
+    uint32_t depth_crcs[MAX_PATH_DEPTH];
+    // number of leading depths whose CRC is up to date
+    uint8_t valid_crc_count;
 } s_path;
 
 typedef struct {
-    list_node_t _list;
     cx_sha3_t hash;
 } s_hash_ctx;
 
@@ -44,5 +49,6 @@ const void *path_backup_get_nth_field(uint8_t n);
 bool path_exists_in_backup(const char *path, size_t length);
 const void *path_get_nth_field_to_last(uint8_t n);
 uint8_t path_get_depth_count(void);
+bool path_get_crc(uint32_t *crc);
 uint8_t path_backup_get_depth_count(void);
 s_hash_ctx *get_last_hash_ctx(void);
@@ -0,0 +1,225 @@
+#include <string.h>
+#include "schema_cache.h"
+#include "schema_hash.h"
+#include "typed_data.h"
+#include "context_712.h"
+#include "app_mem_utils.h"
+#include "apdu_constants.h"  // APDU response codes
+#include "lists.h"
+
+// Bigger schemas are not worth keeping in memory
+#define SCHEMA_CACHE_MAX_SIZE 1024
+
+// Same value as the struct definition APDU P2
+#define SCHEMA_DEF_NAME 0x00
+
+// P2 (1) | length (1), before the data of each struct definition stored in a cache entry
+#define SCHEMA_DEF_HEADER_SIZE 2
+
+// Struct definition received during the current session
+typedef struct {
+    flist_node_t _list;
+    uint8_t p2;
+    uint8_t length;
+    uint8_t data[];
+} s_schema_def;
+
+typedef struct {
+    uint16_t size;  // 0 if the entry is free
+    uint16_t last_use;
+    uint8_t schema_hash[CX_SHA224_SIZE];
+    uint8_t defs[SCHEMA_CACHE_MAX_SIZE];  // struct definitions, one after the other
+} s_schema_cache_entry;
+
+// Reserved up front rather than allocated, not to fragment the memory arena with buffers that
+// outlive the signing sessions
+static s_schema_cache_entry g_schema_cache[EIP712_SCHEMA_CACHE_SIZE] = {0};
+static uint16_t g_schema_cache_use_count = 0;
+
+// struct definitions received during the current session
+static s_schema_def *g_recorded_defs = NULL;
+static uint16_t g_recorded_size = 0;
+static bool g_recording_dropped = false;
+
+// to be used as a \ref f_list_node_del
+static void delete_schema_def(s_schema_def *def) {
+    APP_MEM_FREE(def);
+}
+
+/**
+ * Rank the uses of the cached schemas from 1 in the same order, so that the counter never wraps
+ */
+static void renormalize_schema_uses(void) {
+    uint16_t ranks[EIP712_SCHEMA_CACHE_SIZE] = {0};
+    uint16_t count = 0;
+
+    for (uint8_t i = 0; i < EIP712_SCHEMA_CACHE_SIZE; ++i) {
+        if (g_schema_cache[i].size == 0) {
+            continue;
+        }
+        ranks[i] = 1;
+        for (uint8_t j = 0; j < EIP712_SCHEMA_CACHE_SIZE; ++j) {
+            if ((g_schema_cache[j].size != 0) &&
+                (g_schema_cache[j].last_use < g_schema_cache[i].last_use)) {
+                ranks[i] += 1;
+            }
+        }
+        count += 1;
+    }
+    for (uint8_t i = 0; i < EIP712_SCHEMA_CACHE_SIZE; ++i) {
+        g_schema_cache[i].last_use = ranks[i];
+    }
+    g_schema_cache_use_count = count;
+}
+
+static void touch_entry(s_schema_cache_entry *entry) {
+    if (g_schema_cache_use_count == UINT16_MAX) {
+        renormalize_schema_uses();
+    }
+    g_schema_cache_use_count += 1;
+    entry->last_use = g_schema_cache_use_count;
+}
+
+static s_schema_cache_entry *find_entry(const uint8_t *schema_hash) {
+    for (uint8_t i = 0; i < EIP712_SCHEMA_CACHE_SIZE; ++i) {
+        if ((g_schema_cache[i].size != 0) &&
+            (memcmp(g_schema_cache[i].schema_hash, schema_hash, CX_SHA224_SIZE) == 0)) {
+            return &g_schema_cache[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Get the entry a new schema will be stored into
+ *
+ * A free one if any, otherwise the least recently used one.
+ *
+ * @return the entry
+ */
+static s_schema_cache_entry *get_target_entry(void) {
+    s_schema_cache_entry *target = &g_schema_cache[0];
+
+    for (uint8_t i = 0; i < EIP712_SCHEMA_CACHE_SIZE; ++i) {
+        if (g_schema_cache[i].size == 0) {
+            return &g_schema_cache[i];
+        }
+        if (g_schema_cache[i].last_use < target->last_use) {
+            target = &g_schema_cache[i];
+        }
+    }
+    return target;
+}
+
+/**
+ * Discard the struct definitions recorded during the current session
+ */
+void schema_cache_discard_recording(void) {
+    flist_clear((flist_node_t **) &g_recorded_defs, (f_list_node_del) &delete_schema_def);
+    g_recorded_size = 0;
+    g_recording_dropped = false;
+}
+
+/**
+ * Drop every cached schema, as well as the current recording
+ */
+void schema_cache_clear(void) {
+    schema_cache_discard_recording();
+    explicit_bzero(g_schema_cache, sizeof(g_schema_cache));
+    g_schema_cache_use_count = 0;
+}
+
+/**
+ * Record a successfully parsed struct definition APDU
+ *
+ * The cache is only an optimization, the schema simply does not get cached if anything fails.
+ *
+ * @param[in] p2 instruction parameter 2
+ * @param[in] data command data
+ * @param[in] length length of the command data
+ */
+void schema_cache_record_def(uint8_t p2, const uint8_t *data, uint8_t length) {
+    s_schema_def *def = NULL;
+
+    if (g_recording_dropped) {
+        return;
+    }
+    g_recorded_size += SCHEMA_DEF_HEADER_SIZE + length;
+    if ((g_recorded_size > SCHEMA_CACHE_MAX_SIZE) ||
+        ((def = APP_MEM_ALLOC(sizeof(*def) + length)) == NULL)) {
+        PRINTF("Schema not cacheable\n");
+        schema_cache_discard_recording();
+        g_recording_dropped = true;
+        return;
+    }
+    def->p2 = p2;
+    def->length = length;
+    memcpy(def->data, data, length);
+    flist_push_back((flist_node_t **) &g_recorded_defs, (flist_node_t *) def);
+}
+
+/**
+ * Store the recorded struct definitions in the cache
+ *
+ * To be called once all the struct definitions have been received.
+ */
+void schema_cache_store(void) {
+    s_schema_cache_entry *entry;
+    uint16_t offset = 0;
+
+    if ((g_recorded_defs != NULL) && compute_schema_hash() &&
+        (find_entry(eip712_context->schema_hash) == NULL)) {
+        entry = get_target_entry();
+        // fits, the recording is dropped past SCHEMA_CACHE_MAX_SIZE
+        for (const s_schema_def *def = g_recorded_defs; def != NULL;
+             def = (s_schema_def *) ((flist_node_t *) def)->next) {
+            entry->defs[offset] = def->p2;
+            entry->defs[offset + 1] = def->length;
+            memcpy(&entry->defs[offset + SCHEMA_DEF_HEADER_SIZE], def->data, def->length);
+            offset += SCHEMA_DEF_HEADER_SIZE + def->length;
+        }
+        entry->size = offset;
+        memcpy(entry->schema_hash, eip712_context->schema_hash, sizeof(entry->schema_hash));
+        touch_entry(entry);
+    }
+    schema_cache_discard_recording();
+}
+
+/**
+ * Define the structs from a cached schema
+ *
+ * @param[in] data command data, the schema hash
+ * @param[in] length length of the command data
+ * @return whether it was successful
+ */
+bool schema_cache_load(const uint8_t *data, uint8_t length) {
+    s_schema_cache_entry *entry;
+    bool ret = true;
+    uint8_t def_length;
+
+    if ((length != CX_SHA224_SIZE) || (get_struct_list() != NULL)) {
+        apdu_response_code = SWO_INCORRECT_DATA;
+        return false;
+    }
+    if ((entry = find_entry(data)) == NULL) {
+        PRINTF("Schema not found in cache\n");
+        apdu_response_code = SWO_REFERENCED_DATA_NOT_FOUND;
+        // expected, the client just has to send the struct definitions
+        eip712_context->go_home_on_failure = false;
+        return false;
+    }
+    touch_entry(entry);
+    // already cached, no need to record it
+    schema_cache_discard_recording();
+    g_recording_dropped = true;
+    for (uint16_t offset = 0; ret && (offset < entry->size);
+         offset += SCHEMA_DEF_HEADER_SIZE + def_length) {
+        def_length = entry->defs[offset + 1];
+        if (entry->defs[offset] == SCHEMA_DEF_NAME) {
+            ret = set_struct_name(def_length, &entry->defs[offset + SCHEMA_DEF_HEADER_SIZE]);
+        } else {
+            ret = set_struct_field(def_length, &entry->defs[offset + SCHEMA_DEF_HEADER_SIZE]);
+        }
+    }
+    return ret;
+}
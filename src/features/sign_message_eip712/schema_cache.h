@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Number of EIP-712 schemas kept across signing sessions
+#ifndef EIP712_SCHEMA_CACHE_SIZE
+#define EIP712_SCHEMA_CACHE_SIZE 2
+#endif
+
+void schema_cache_record_def(uint8_t p2, const uint8_t *data, uint8_t length);
+void schema_cache_store(void);
+void schema_cache_discard_recording(void);
+bool schema_cache_load(const uint8_t *data, uint8_t length);
+void schema_cache_clear(void);
@@ -28,31 +28,31 @@ bool compute_schema_hash(void) {
     hash_byte('{', (cx_hash_t *) &hash_ctx);
     while (struct_ptr != NULL) {
         hash_byte('"', (cx_hash_t *) &hash_ctx);
-        hash_nbytes((uint8_t *) struct_ptr->name,
-                    strlen(struct_ptr->name),
+        hash_nbytes((uint8_t *) get_struct_name(struct_ptr),
+                    strlen(get_struct_name(struct_ptr)),
                     (cx_hash_t *) &hash_ctx);
         hash_nbytes((uint8_t *) "\":[", 3, (cx_hash_t *) &hash_ctx);
-        field_ptr = struct_ptr->fields;
+        field_ptr = get_struct_fields(struct_ptr);
         while (field_ptr != NULL) {
             hash_nbytes((uint8_t *) "{\"name\":\"", 9, (cx_hash_t *) &hash_ctx);
-            hash_nbytes((uint8_t *) field_ptr->key_name,
-                        strlen(field_ptr->key_name),
+            hash_nbytes((uint8_t *) get_struct_field_keyname(field_ptr),
+                        strlen(get_struct_field_keyname(field_ptr)),
                         (cx_hash_t *) &hash_ctx);
             hash_nbytes((uint8_t *) "\",\"type\":\"", 10, (cx_hash_t *) &hash_ctx);
             if (!format_hash_field_type(field_ptr, (cx_hash_t *) &hash_ctx)) {
                 return false;
             }
             hash_nbytes((uint8_t *) "\"}", 2, (cx_hash_t *) &hash_ctx);
-            if (((flist_node_t *) field_ptr)->next != NULL) {
+            if (get_next_struct_field(field_ptr) != NULL) {
                 hash_byte(',', (cx_hash_t *) &hash_ctx);
             }
-            field_ptr = (s_struct_712_field *) ((flist_node_t *) field_ptr)->next;
+            field_ptr = get_next_struct_field(field_ptr);
         }
         hash_byte(']', (cx_hash_t *) &hash_ctx);
-        if (((flist_node_t *) struct_ptr)->next != NULL) {
+        if (get_next_struct(struct_ptr) != NULL) {
             hash_byte(',', (cx_hash_t *) &hash_ctx);
         }
-        struct_ptr = (s_struct_712 *) ((flist_node_t *) struct_ptr)->next;
+        struct_ptr = get_next_struct(struct_ptr);
     }
     hash_byte('}', (cx_hash_t *) &hash_ctx);
 
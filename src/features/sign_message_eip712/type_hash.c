@@ -6,6 +6,7 @@
 #include "apdu_constants.h"  // APDU response codes
 #include "typed_data.h"
 #include "lists.h"
+#include "syscall_stats.h"
 
 /**
  * Encode & hash the given structure field
@@ -23,7 +24,7 @@ static bool encode_and_hash_field(const s_struct_712_field *field_ptr) {
     hash_byte(' ', (cx_hash_t *) &global_sha3);
 
     // field name
-    name = field_ptr->key_name;
+    name = get_struct_field_keyname(field_ptr);
     hash_nbytes((uint8_t *) name, strlen(name), (cx_hash_t *) &global_sha3);
     return true;
 }
@@ -40,16 +41,16 @@ static bool encode_and_hash_type(const s_struct_712 *struct_ptr) {
     const s_struct_712_field *field_ptr;
 
     // struct name
-    struct_name = struct_ptr->name;
+    struct_name = get_struct_name(struct_ptr);
     hash_nbytes((uint8_t *) struct_name, strlen(struct_name), (cx_hash_t *) &global_sha3);
 
     // opening struct parentheses
     hash_byte('(', (cx_hash_t *) &global_sha3);
 
-    for (field_ptr = struct_ptr->fields; field_ptr != NULL;
-         field_ptr = (s_struct_712_field *) ((flist_node_t *) field_ptr)->next) {
+    for (field_ptr = get_struct_fields(struct_ptr); field_ptr != NULL;
+         field_ptr = get_next_struct_field(field_ptr)) {
         // comma separating struct fields
-        if (field_ptr != struct_ptr->fields) {
+        if (field_ptr != get_struct_fields(struct_ptr)) {
             hash_byte(',', (cx_hash_t *) &global_sha3);
         }
 
@@ -83,13 +84,12 @@ static bool get_struct_dependencies(s_struct_dep **first_dep, const s_struct_712
     s_struct_dep *tmp;
     s_struct_dep *new_dep;
 
-    for (field_ptr = struct_ptr->fields; field_ptr != NULL;
-         field_ptr = (s_struct_712_field *) ((flist_node_t *) field_ptr)->next) {
+    for (field_ptr = get_struct_fields(struct_ptr); field_ptr != NULL;
+         field_ptr = get_next_struct_field(field_ptr)) {
         if (field_ptr->type == TYPE_CUSTOM) {
-            // get struct name
-            arg_structname = get_struct_field_typename(field_ptr);
-            // from its name, get the pointer to its definition
-            if ((arg_struct_ptr = get_structn(arg_structname, strlen(arg_structname))) == NULL) {
+            // get the pointer to its definition
+            if ((arg_struct_ptr = get_struct_field_custom_struct(field_ptr)) == NULL) {
+                arg_structname = get_struct_field_typename(field_ptr);
                 PRINTF("Error: could not find EIP-712 dependency struct \"");
                 for (int i = 0; i < (int) strlen(arg_structname); ++i)
                     PRINTF("%c", arg_structname[i]);
@@ -128,9 +128,9 @@ static bool compare_struct_deps(const s_struct_dep *a, const s_struct_dep *b) {
     size_t namelen1, namelen2;
     int str_cmp_result;
 
-    name1 = a->s->name;
+    name1 = get_struct_name(a->s);
     namelen1 = strlen(name1);
-    name2 = b->s->name;
+    name2 = get_struct_name(b->s);
     namelen2 = strlen(name2);
 
     str_cmp_result = strncmp(name1, name2, MIN(namelen1, namelen2));
@@ -4,7 +4,46 @@
 #include "context_712.h"
 #include "app_mem_utils.h"
 
+// By how many elements the buffers grow when they are full
+#define STRUCTS_GROWTH_STEP 4
+#define FIELDS_GROWTH_STEP  16
+#define STRINGS_GROWTH_STEP 16
+#define POOL_GROWTH_STEP    128
+
+// Number of hash buckets of the interned strings
+#define STRING_BUCKETS 16
+
+// custom type not defined (yet)
+#define NO_STRUCT_IDX UINT8_MAX
+
+// all the struct definitions, in the order they were received
 static s_struct_712 *g_structs = NULL;
+static uint16_t g_structs_count = 0;
+static uint16_t g_structs_capacity = 0;
+
+// all the struct fields, those of a given struct are contiguous
+static s_struct_712_field *g_fields = NULL;
+static uint16_t g_fields_count = 0;
+static uint16_t g_fields_capacity = 0;
+
+// interned strings and array levels
+static uint8_t *g_pool = NULL;
+static uint16_t g_pool_size = 0;
+static uint16_t g_pool_capacity = 0;
+
+typedef struct {
+    uint16_t offset;  // in the pool
+    uint16_t next;    // index + 1 of the next string of the same bucket, 0 if none
+    uint8_t length;
+    uint8_t hash;
+} s_interned_string;
+
+// index of the interned strings, chained by hash buckets
+static s_interned_string *g_strings = NULL;
+static uint16_t g_strings_count = 0;
+static uint16_t g_strings_capacity = 0;
+// index + 1 of the last string added to each bucket, 0 if none
+static uint16_t g_string_buckets[STRING_BUCKETS] = {0};
 
 /**
  * Initialize the typed data context
@@ -19,23 +58,204 @@ bool typed_data_init(void) {
     return true;
 }
 
-// to be used as a \ref f_list_node_del
-static void delete_field(s_struct_712_field *f) {
-    APP_MEM_FREE(f->type_name);
-    APP_MEM_FREE(f->array_levels);
-    APP_MEM_FREE(f->key_name);
-    APP_MEM_FREE(f);
+void typed_data_deinit(void) {
+    APP_MEM_FREE_AND_NULL((void **) &g_pool);
+    APP_MEM_FREE_AND_NULL((void **) &g_strings);
+    APP_MEM_FREE_AND_NULL((void **) &g_fields);
+    APP_MEM_FREE_AND_NULL((void **) &g_structs);
+    g_structs_count = g_structs_capacity = 0;
+    g_fields_count = g_fields_capacity = 0;
+    g_pool_size = g_pool_capacity = 0;
+    g_strings_count = g_strings_capacity = 0;
+    explicit_bzero(g_string_buckets, sizeof(g_string_buckets));
+}
+
+/**
+ * Make sure a buffer is big enough for the given number of elements
+ *
+ * The memory allocator cannot resize an allocation, so a bigger buffer replaces it.
+ *
+ * @param[in,out] buffer the buffer
+ * @param[in,out] capacity the number of elements the buffer can hold
+ * @param[in] count the number of elements needed
+ * @param[in] max the maximum number of elements
+ * @param[in] step by how many elements it grows
+ * @param[in] elem_size the size of an element
+ * @return whether it was successful
+ */
+static bool reserve(void **buffer,
+                    uint16_t *capacity,
+                    uint32_t count,
+                    uint32_t max,
+                    uint16_t step,
+                    size_t elem_size) {
+    uint32_t new_capacity;
+    void *new_buffer;
+
+    if (count <= *capacity) {
+        return true;
+    }
+    if (count > max) {
+        apdu_response_code = SWO_INSUFFICIENT_MEMORY;
+        return false;
+    }
+    new_capacity = count + step;
+    if (new_capacity > max) {
+        new_capacity = max;
+    }
+    if ((new_buffer = APP_MEM_ALLOC(new_capacity * elem_size)) == NULL) {
+        apdu_response_code = SWO_INSUFFICIENT_MEMORY;
+        return false;
+    }
+    if (*buffer != NULL) {
+        memcpy(new_buffer, *buffer, *capacity * elem_size);
+        APP_MEM_FREE(*buffer);
+    }
+    *buffer = new_buffer;
+    *capacity = new_capacity;
+    return true;
+}
+
+/**
+ * Allocate some bytes in the typed data pool
+ *
+ * Previously returned pointers to the pool might become invalid.
+ *
+ * @param[in] size the number of bytes
+ * @param[out] offset the offset of the allocated bytes in the pool
+ * @return whether it was successful
+ */
+static bool pool_alloc(uint16_t size, uint16_t *offset) {
+    if (!reserve((void **) &g_pool,
+                 &g_pool_capacity,
+                 g_pool_size + size,
+                 UINT16_MAX,
+                 POOL_GROWTH_STEP,
+                 sizeof(*g_pool))) {
+        return false;
+    }
+    *offset = g_pool_size;
+    g_pool_size += size;
+    return true;
 }
 
-// to be used as a \ref f_list_node_del
-static void delete_struct(s_struct_712 *s) {
-    APP_MEM_FREE(s->name);
-    flist_clear((flist_node_t **) &s->fields, (f_list_node_del) &delete_field);
-    APP_MEM_FREE(s);
+static const char *pool_string(uint16_t offset) {
+    return (const char *) &g_pool[offset];
 }
 
-void typed_data_deinit(void) {
-    flist_clear((flist_node_t **) &g_structs, (f_list_node_del) &delete_struct);
+static uint8_t string_hash(const char *str, uint8_t length) {
+    // FNV-1a, folded
+    uint32_t hash = 2166136261;
+
+    for (uint8_t i = 0; i < length; ++i) {
+        hash ^= (uint8_t) str[i];
+        hash *= 16777619;
+    }
+    return (uint8_t) (hash ^ (hash >> 8) ^ (hash >> 16) ^ (hash >> 24));
+}
+
+/**
+ * Look for an interned string
+ *
+ * @param[in] str the string
+ * @param[in] length the string length
+ * @param[in] hash the string hash
+ * @param[out] offset the offset of the string in the pool
+ * @return whether it was found
+ */
+static bool find_string(const char *str, uint8_t length, uint8_t hash, uint16_t *offset) {
+    const s_interned_string *interned;
+
+    for (uint16_t idx = g_string_buckets[hash % STRING_BUCKETS]; idx != 0; idx = interned->next) {
+        interned = &g_strings[idx - 1];
+        if ((interned->hash == hash) && (interned->length == length) &&
+            (memcmp(&g_pool[interned->offset], str, length) == 0)) {
+            *offset = interned->offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Get the offset of a string in the typed data pool, adding it if not already present
+ *
+ * Struct & key names are often repeated in a schema, they are only stored once. Any two equal
+ * names thus have the same offset.
+ *
+ * @param[in] str the string
+ * @param[in] length the string length
+ * @param[out] offset the offset of the string in the pool
+ * @return whether it was successful
+ */
+static bool intern_string(const char *str, uint8_t length, uint16_t *offset) {
+    uint8_t hash;
+    s_interned_string *interned;
+    uint8_t bucket;
+
+    if (memchr(str, '\0', length) != NULL) {
+        PRINTF("Unexpected NUL character in name\n");
+        return false;
+    }
+    hash = string_hash(str, length);
+    if (find_string(str, length, hash, offset)) {
+        return true;
+    }
+    if (!reserve((void **) &g_strings,
+                 &g_strings_capacity,
+                 g_strings_count + 1,
+                 UINT16_MAX - 1,
+                 STRINGS_GROWTH_STEP,
+                 sizeof(*g_strings))) {
+        return false;
+    }
+    if (!pool_alloc(length + 1, offset)) {
+        return false;
+    }
+    memcpy(&g_pool[*offset], str, length);
+    g_pool[*offset + length] = '\0';
+    bucket = hash % STRING_BUCKETS;
+    interned = &g_strings[g_strings_count];
+    interned->offset = *offset;
+    interned->length = length;
+    interned->hash = hash;
+    interned->next = g_string_buckets[bucket];
+    g_strings_count += 1;
+    g_string_buckets[bucket] = g_strings_count;
+    return true;
+}
+
+/**
+ * Forget the strings interned since the given count
+ *
+ * They are the latest ones, so each of them is the head of its bucket when removed.
+ *
+ * @param[in] count number of interned strings to keep
+ */
+static void unintern_strings(uint16_t count) {
+    const s_interned_string *interned;
+
+    while (g_strings_count > count) {
+        g_strings_count -= 1;
+        interned = &g_strings[g_strings_count];
+        g_string_buckets[interned->hash % STRING_BUCKETS] = interned->next;
+    }
+}
+
+/**
+ * Get the index of the struct with the given interned name
+ *
+ * @param[in] name_offset offset of the name in the typed data pool
+ * @return the index, \ref NO_STRUCT_IDX if not found
+ */
+static uint8_t get_struct_idx(uint16_t name_offset) {
+    for (uint16_t i = 0; i < g_structs_count; ++i) {
+        // interned, comparing the offsets is enough
+        if (g_structs[i].name_offset == name_offset) {
+            return i;
+        }
+    }
+    return NO_STRUCT_IDX;
 }
 
 /**
@@ -49,13 +269,82 @@ const char *get_struct_field_typename(const s_struct_712_field *field_ptr) {
         return NULL;
     }
     if (field_ptr->type == TYPE_CUSTOM) {
-        return field_ptr->type_name;
+        return pool_string(field_ptr->type_name_offset);
     }
     return get_struct_field_sol_typename(field_ptr);
 }
 
+const char *get_struct_field_keyname(const s_struct_712_field *field_ptr) {
+    if (field_ptr == NULL) {
+        return NULL;
+    }
+    return pool_string(field_ptr->key_name_offset);
+}
+
+const s_struct_712_field_array_level *get_struct_field_array_levels(
+    const s_struct_712_field *field_ptr) {
+    if ((field_ptr == NULL) || !field_ptr->type_is_array) {
+        return NULL;
+    }
+    return (const s_struct_712_field_array_level *) &g_pool[field_ptr->array_levels_offset];
+}
+
+/**
+ * Get the struct a custom type field refers to
+ *
+ * @param[in] field_ptr struct field pointer
+ * @return pointer to the struct, \ref NULL if not a custom type or not defined
+ */
+const s_struct_712 *get_struct_field_custom_struct(const s_struct_712_field *field_ptr) {
+    if ((field_ptr == NULL) || (field_ptr->type != TYPE_CUSTOM) ||
+        (field_ptr->type_struct_idx == NO_STRUCT_IDX)) {
+        apdu_response_code = SWO_INCORRECT_DATA;
+        return NULL;
+    }
+    return &g_structs[field_ptr->type_struct_idx];
+}
+
 const s_struct_712 *get_struct_list(void) {
-    return g_structs;
+    return (g_structs_count > 0) ? &g_structs[0] : NULL;
+}
+
+const s_struct_712 *get_next_struct(const s_struct_712 *struct_ptr) {
+    if ((struct_ptr == NULL) || ((struct_ptr + 1) >= (g_structs + g_structs_count))) {
+        return NULL;
+    }
+    return struct_ptr + 1;
+}
+
+const char *get_struct_name(const s_struct_712 *struct_ptr) {
+    if (struct_ptr == NULL) {
+        return NULL;
+    }
+    return pool_string(struct_ptr->name_offset);
+}
+
+const s_struct_712_field *get_struct_fields(const s_struct_712 *struct_ptr) {
+    return get_struct_field_at(struct_ptr, 0);
+}
+
+/**
+ * Get the Nth field of a struct
+ *
+ * @param[in] struct_ptr struct pointer
+ * @param[in] index index of the field
+ * @return pointer to the field, \ref NULL if out of bounds
+ */
+const s_struct_712_field *get_struct_field_at(const s_struct_712 *struct_ptr, uint8_t index) {
+    if ((struct_ptr == NULL) || (index >= struct_ptr->field_count)) {
+        return NULL;
+    }
+    return &g_fields[struct_ptr->first_field + index];
+}
+
+const s_struct_712_field *get_next_struct_field(const s_struct_712_field *field_ptr) {
+    if ((field_ptr == NULL) || field_ptr->is_last) {
+        return NULL;
+    }
+    return field_ptr + 1;
 }
 
 /**
@@ -66,23 +355,19 @@ const s_struct_712 *get_struct_list(void) {
  * @return pointer to struct
  */
 const s_struct_712 *get_structn(const char *name, uint8_t length) {
-    const s_struct_712 *struct_ptr;
+    uint16_t name_offset;
+    uint8_t idx;
 
     if (name == NULL) {
         apdu_response_code = SWO_INCORRECT_DATA;
         return NULL;
     }
-    for (struct_ptr = get_struct_list(); struct_ptr != NULL;
-         struct_ptr = (s_struct_712 *) ((flist_node_t *) struct_ptr)->next) {
-        if (struct_ptr->name != NULL) {
-            if ((length == strlen(struct_ptr->name)) &&
-                (memcmp(name, struct_ptr->name, length) == 0)) {
-                return struct_ptr;
-            }
-        }
+    if (!find_string(name, length, string_hash(name, length), &name_offset) ||
+        ((idx = get_struct_idx(name_offset)) == NO_STRUCT_IDX)) {
+        apdu_response_code = SWO_INCORRECT_DATA;
+        return NULL;
     }
-    apdu_response_code = SWO_INCORRECT_DATA;
-    return NULL;
+    return &g_structs[idx];
 }
 
 /**
@@ -94,26 +379,40 @@ const s_struct_712 *get_structn(const char *name, uint8_t length) {
  */
 bool set_struct_name(uint8_t length, const uint8_t *name) {
     s_struct_712 *new_struct;
+    uint16_t name_offset;
 
     if (name == NULL) {
         apdu_response_code = SWO_INCORRECT_DATA;
         return false;
     }
-
-    if (APP_MEM_CALLOC((void **) &new_struct, sizeof(*new_struct)) == false) {
-        apdu_response_code = SWO_INSUFFICIENT_MEMORY;
+    if (!intern_string((const char *) name, length, &name_offset)) {
         return false;
     }
-
-    if ((new_struct->name = APP_MEM_ALLOC(length + 1)) == NULL) {
-        apdu_response_code = SWO_INSUFFICIENT_MEMORY;
+    // the index has to fit in a field, and not be mistaken for NO_STRUCT_IDX
+    if (!reserve((void **) &g_structs,
+                 &g_structs_capacity,
+                 g_structs_count + 1,
+                 NO_STRUCT_IDX,
+                 STRUCTS_GROWTH_STEP,
+                 sizeof(*g_structs))) {
         return false;
     }
-    new_struct->name[length] = '\0';
-    memmove(new_struct->name, name, length);
+    new_struct = &g_structs[g_structs_count];
+    new_struct->name_offset = name_offset;
+    new_struct->first_field = g_fields_count;
+    new_struct->field_count = 0;
+    // resolve the fields which referred to it before its definition
+    if (get_struct_idx(name_offset) == NO_STRUCT_IDX) {
+        for (uint16_t i = 0; i < g_fields_count; ++i) {
+            if ((g_fields[i].type == TYPE_CUSTOM) &&
+                (g_fields[i].type_struct_idx == NO_STRUCT_IDX) &&
+                (g_fields[i].type_name_offset == name_offset)) {
+                g_fields[i].type_struct_idx = g_structs_count;
+            }
+        }
+    }
+    g_structs_count += 1;
     struct_state = INITIALIZED;
-
-    flist_push_back((flist_node_t **) &g_structs, (flist_node_t *) new_struct);
     return true;
 }
 
@@ -170,13 +469,12 @@ static bool set_struct_field_custom_typename(s_struct_712_field *field,
         apdu_response_code = SWO_INCORRECT_DATA;
         return false;
     }
-    if ((field->type_name = APP_MEM_ALLOC(typename_len + 1)) == NULL) {
-        apdu_response_code = SWO_INSUFFICIENT_MEMORY;
+    if (!intern_string((const char *) &data[*data_idx],
+                       typename_len,
+                       &field->type_name_offset)) {
         return false;
     }
-
-    field->type_name[typename_len] = '\0';
-    memmove(field->type_name, &data[*data_idx], typename_len);
+    field->type_struct_idx = get_struct_idx(field->type_name_offset);
     *data_idx += typename_len;
     return true;
 }
@@ -192,34 +490,36 @@ static bool set_struct_field_array(s_struct_712_field *field,
                                    const uint8_t *data,
                                    uint8_t *data_idx,
                                    uint8_t length) {
+    s_struct_712_field_array_level *levels;
+
     if ((*data_idx + sizeof(field->array_level_count)) > length)  // check buffer bound
     {
         apdu_response_code = SWO_INCORRECT_DATA;
         return false;
     }
     field->array_level_count = data[(*data_idx)++];
-    if ((field->array_levels =
-             APP_MEM_ALLOC(sizeof(*field->array_levels) * field->array_level_count)) == NULL) {
+    if (!pool_alloc(sizeof(*levels) * field->array_level_count, &field->array_levels_offset)) {
         return false;
     }
+    levels = (s_struct_712_field_array_level *) &g_pool[field->array_levels_offset];
     for (int idx = 0; idx < field->array_level_count; ++idx) {
-        if ((*data_idx + sizeof(field->array_levels[idx].type)) > length)  // check buffer bound
+        if ((*data_idx + sizeof(levels[idx].type)) > length)  // check buffer bound
         {
             apdu_response_code = SWO_INCORRECT_DATA;
             return false;
         }
-        field->array_levels[idx].type = data[(*data_idx)++];
-        switch (field->array_levels[idx].type) {
+        levels[idx].type = data[(*data_idx)++];
+        levels[idx].size = 0;
+        switch (levels[idx].type) {
             case ARRAY_DYNAMIC:  // nothing to do
                 break;
             case ARRAY_FIXED_SIZE:
-                if ((*data_idx + sizeof(field->array_levels[idx].size)) >
-                    length)  // check buffer bound
+                if ((*data_idx + sizeof(levels[idx].size)) > length)  // check buffer bound
                 {
                     apdu_response_code = SWO_INCORRECT_DATA;
                     return false;
                 }
-                field->array_levels[idx].size = data[(*data_idx)++];
+                levels[idx].size = data[(*data_idx)++];
                 break;
             default:
                 // should not be in here :^)
@@ -279,12 +579,9 @@ static bool set_struct_field_keyname(s_struct_712_field *field,
         return false;
     }
 
-    if ((field->key_name = APP_MEM_ALLOC(keyname_len + 1)) == NULL) {
-        apdu_response_code = SWO_INSUFFICIENT_MEMORY;
+    if (!intern_string((const char *) &data[*data_idx], keyname_len, &field->key_name_offset)) {
         return false;
     }
-    field->key_name[keyname_len] = '\0';
-    memmove(field->key_name, &data[*data_idx], keyname_len);
     *data_idx += keyname_len;
     return true;
 }
@@ -298,11 +595,15 @@ static bool set_struct_field_keyname(s_struct_712_field *field,
  */
 bool set_struct_field(uint8_t length, const uint8_t *data) {
     uint8_t data_idx = 0;
+    s_struct_712_field new_field = {.type_struct_idx = NO_STRUCT_IDX};
+    s_struct_712 *last_struct;
+    uint16_t pool_size_bak = g_pool_size;
+    uint16_t strings_count_bak = g_strings_count;
 
     if ((data == NULL) || (length == 0)) {
         apdu_response_code = SWO_INCORRECT_DATA;
         return false;
-    } else if (g_structs == NULL) {
+    } else if (g_structs_count == 0) {
         apdu_response_code = SWO_INCORRECT_DATA;
         return false;
     }
@@ -312,63 +613,69 @@ bool set_struct_field(uint8_t length, const uint8_t *data) {
         return false;
     }
 
-    s_struct_712_field *new_field = NULL;
-    if (APP_MEM_CALLOC((void **) &new_field, sizeof(*new_field)) == false) {
-        apdu_response_code = SWO_INSUFFICIENT_MEMORY;
+    last_struct = &g_structs[g_structs_count - 1];
+    if (last_struct->field_count == UINT8_MAX) {
+        apdu_response_code = SWO_INCORRECT_DATA;
         return false;
     }
 
-    if (!set_struct_field_typedesc(new_field, data, &data_idx, length)) {
+    if (!set_struct_field_typedesc(&new_field, data, &data_idx, length)) {
         goto cleanup;
     }
 
     // check TypeSize flag in TypeDesc
-    if (new_field->type_has_size) {
+    if (new_field.type_has_size) {
         // TYPESIZE and TYPE_CUSTOM are mutually exclusive
-        if (new_field->type == TYPE_CUSTOM) {
+        if (new_field.type == TYPE_CUSTOM) {
             apdu_response_code = SWO_INCORRECT_DATA;
             goto cleanup;
         }
 
-        if (set_struct_field_typesize(new_field, data, &data_idx, length) == false) {
+        if (set_struct_field_typesize(&new_field, data, &data_idx, length) == false) {
             goto cleanup;
         }
 
-    } else if (new_field->type == TYPE_CUSTOM) {
-        if (set_struct_field_custom_typename(new_field, data, &data_idx, length) == false) {
+    } else if (new_field.type == TYPE_CUSTOM) {
+        if (set_struct_field_custom_typename(&new_field, data, &data_idx, length) == false) {
             goto cleanup;
         }
     }
-    if (new_field->type_is_array) {
-        if (set_struct_field_array(new_field, data, &data_idx, length) == false) {
+    if (new_field.type_is_array) {
+        if (set_struct_field_array(&new_field, data, &data_idx, length) == false) {
             goto cleanup;
         }
     }
 
-    if (set_struct_field_keyname(new_field, data, &data_idx, length) == false) {
+    if (set_struct_field_keyname(&new_field, data, &data_idx, length) == false) {
         goto cleanup;
     }
 
     if (data_idx != length)  // check that there is no more
     {
         apdu_response_code = SWO_INCORRECT_DATA;
-        return false;
+        goto cleanup;
     }
 
-    // get last struct
-    s_struct_712 *s = g_structs;
-    while ((s_struct_712 *) ((flist_node_t *) s)->next != NULL) {
-        s = (s_struct_712 *) ((flist_node_t *) s)->next;
+    if (!reserve((void **) &g_fields,
+                 &g_fields_capacity,
+                 g_fields_count + 1,
+                 UINT16_MAX,
+                 FIELDS_GROWTH_STEP,
+                 sizeof(*g_fields))) {
+        goto cleanup;
     }
-
-    flist_push_back((flist_node_t **) &s->fields, (flist_node_t *) new_field);
+    // the fields of the last struct are the last ones
+    if (last_struct->field_count > 0) {
+        g_fields[g_fields_count - 1].is_last = false;
+    }
+    new_field.is_last = true;
+    g_fields[g_fields_count] = new_field;
+    g_fields_count += 1;
+    last_struct->field_count += 1;
     return true;
 cleanup:
-    if (new_field != NULL) {
-        APP_MEM_FREE(new_field->key_name);
-        APP_MEM_FREE(new_field->array_levels);
-        APP_MEM_FREE(new_field->type_name);
-        APP_MEM_FREE(new_field);
-    }
+    // drop what this field added to the pool
+    unintern_strings(strings_count_bak);
+    g_pool_size = pool_size_bak;
     return false;
 }
@@ -26,43 +26,56 @@ typedef enum {
     TYPES_COUNT
 } e_type;
 
+// packed, since stored as is in the typed data pool
 typedef struct {
-    e_array_type type;
+    uint8_t type;  // e_array_type
     uint8_t size;
 } s_struct_712_field_array_level;
 
-typedef struct struct_712_field {
-    flist_node_t _list;
+typedef struct {
     // TypeDesc
     bool type_is_array : 1;
     bool type_has_size : 1;
     e_type type : 4;
-    // TypeNameLength
-    // TypeName
-    char *type_name;
+    // whether it is the last field of its struct
+    bool is_last : 1;
     // TypeSize
     uint8_t type_size;
     // ArrayLevelCount
     uint8_t array_level_count;
-    // ArrayLevels
-    s_struct_712_field_array_level *array_levels;
-    // KeyNameLength
-    // KeyName
-    char *key_name;
+    // index of the struct, only for the custom types
+    uint8_t type_struct_idx;
+    // TypeName, offset in the typed data pool
+    uint16_t type_name_offset;
+    // ArrayLevels, offset in the typed data pool
+    uint16_t array_levels_offset;
+    // KeyName, offset in the typed data pool
+    uint16_t key_name_offset;
 } s_struct_712_field;
 
-typedef struct struct_712 {
-    flist_node_t _list;
-    char *name;
-    s_struct_712_field *fields;
+typedef struct {
+    // offset in the typed data pool
+    uint16_t name_offset;
+    // index of its first field, they are all contiguous
+    uint16_t first_field;
+    uint8_t field_count;
 } s_struct_712;
 
 const void *get_array_in_mem(const void *ptr, uint8_t *array_size);
 const char *get_string_in_mem(const uint8_t *ptr, uint8_t *string_length);
 const char *get_struct_field_typename(const s_struct_712_field *ptr);
+const char *get_struct_field_keyname(const s_struct_712_field *field_ptr);
+const s_struct_712_field_array_level *get_struct_field_array_levels(
+    const s_struct_712_field *field_ptr);
+const s_struct_712 *get_struct_field_custom_struct(const s_struct_712_field *field_ptr);
 e_array_type struct_field_array_depth(const uint8_t *ptr, uint8_t *array_size);
 const s_struct_712 *get_struct_list(void);
+const s_struct_712 *get_next_struct(const s_struct_712 *struct_ptr);
 const s_struct_712 *get_structn(const char *name_ptr, uint8_t name_length);
+const char *get_struct_name(const s_struct_712 *struct_ptr);
+const s_struct_712_field *get_struct_fields(const s_struct_712 *struct_ptr);
+const s_struct_712_field *get_struct_field_at(const s_struct_712 *struct_ptr, uint8_t index);
+const s_struct_712_field *get_next_struct_field(const s_struct_712_field *field_ptr);
 bool set_struct_name(uint8_t length, const uint8_t *name);
 bool set_struct_field(uint8_t length, const uint8_t *data);
 bool typed_data_init(void);
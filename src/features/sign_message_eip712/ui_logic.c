@@ -18,9 +18,14 @@
 #include "utils.h"
 #include "tx_ctx.h"  // g_parked_calldata
 #include "read.h"    // read_u64_be
+#include "manage_asset_info.h"  // skip_current_asset_info
 
 #define N_OF_M_LENGTH 10  // enough to hold "nn of mm"
 
+// By how many pairs the review pairs array grows when it is full
+#define UI_712_PAIRS_GROWTH_STEP  8
+#define UI_712_STRINGS_BLOCK_SIZE 256
+
 #define AMOUNT_JOIN_FLAG_TOKEN  (1 << 0)
 #define AMOUNT_JOIN_FLAG_VALUE  (1 << 1)
 #define AMOUNT_JOIN_NAME_LENGTH 25
@@ -54,10 +59,37 @@ typedef struct {
     e_amount_join_state state;
 } s_amount_context;
 
-typedef struct filter_crc {
+// Block of the pooled review strings, a string never moves once written into it
+typedef struct ui_712_strings_block {
     flist_node_t _list;
-    uint32_t value;
-} s_filter_crc;
+    uint16_t size;
+    uint16_t capacity;
+    char data[];
+} s_ui_712_strings_block;
+
+// Review pairs, directly in the NBGL format
+typedef struct {
+    nbgl_contentTagValue_t *values;
+    uint8_t count;
+    uint8_t capacity;
+    // number of batch intents, whose "n of m" values are only known at the end
+    uint8_t intent_count;
+    uint8_t intent_end_count;
+    // the previous pair ended a batch intent, the next one starts a new page
+    bool page_start_pending;
+    s_ui_712_strings_block *strings;
+    s_ui_712_strings_block *last_strings;
+} s_ui_712_pairs;
+
+// Open-addressed hash set of the received filter path CRCs
+typedef struct {
+    uint32_t *values;
+    uint8_t *used;  // bitmap of the occupied slots
+    uint8_t capacity;  // power of 2, at least twice the number of expected filters
+    uint8_t count;
+} s_filter_crc_set;
+
+_Static_assert((MAX_FILTERS * 2) <= 128, "Filter CRCs set capacity stored on a single byte");
 
 typedef struct {
     bool end_reached;
@@ -67,29 +99,150 @@ typedef struct {
     uint8_t field_flags;
     uint8_t structs_to_review;
     s_amount_context amount;
-    s_filter_crc *filters_crc;
+    s_filter_crc_set filters_crc;
     char *discarded_path;
     uint8_t tn_type_count;
     uint8_t tn_source_count;
     e_name_type tn_types[TN_TYPE_COUNT];
     e_name_source tn_sources[TN_SOURCE_COUNT];
-    s_ui_712_pair *ui_pairs;
+    s_ui_712_pairs pairs;
     s_eip712_calldata_info *calldata_info;
     uint8_t calldata_index;
 } t_ui_context;
 
 static t_ui_context *ui_ctx = NULL;
 
-// to be used as a \ref f_list_node_del
-static void delete_filter_crc(s_filter_crc *fcrc) {
-    APP_MEM_FREE(fcrc);
+static void filter_crc_set_free(s_filter_crc_set *set) {
+    APP_MEM_FREE_AND_NULL((void **) &set->values);
+    APP_MEM_FREE_AND_NULL((void **) &set->used);
+    explicit_bzero(set, sizeof(*set));
+}
+
+static bool filter_crc_set_init(s_filter_crc_set *set, uint8_t count) {
+    uint8_t capacity = 2;
+
+    filter_crc_set_free(set);
+    while (capacity < (count * 2)) {
+        capacity <<= 1;
+    }
+    if ((APP_MEM_CALLOC((void **) &set->values, capacity * sizeof(*set->values)) == false) ||
+        (APP_MEM_CALLOC((void **) &set->used, (capacity + 7) / 8) == false)) {
+        filter_crc_set_free(set);
+        return false;
+    }
+    set->capacity = capacity;
+    return true;
+}
+
+/**
+ * Find the slot of a CRC in the set, or the free slot it would go in
+ *
+ * Never fails to find one since the set is never more than half full.
+ *
+ * @param[in] set filter CRCs set
+ * @param[in] crc filter path CRC
+ * @return slot index
+ */
+static uint8_t filter_crc_set_slot(const s_filter_crc_set *set, uint32_t crc) {
+    // the CRC bits are already well spread, a simple mask does the job
+    uint8_t slot = crc & (set->capacity - 1);
+
+    while ((set->used[slot / 8] & (1 << (slot % 8))) && (set->values[slot] != crc)) {
+        slot = (slot + 1) & (set->capacity - 1);
+    }
+    return slot;
 }
 
 // to be used as a \ref f_list_node_del
-static void delete_ui_pair(s_ui_712_pair *pair) {
-    APP_MEM_FREE(pair->key);
-    APP_MEM_FREE(pair->value);
-    APP_MEM_FREE(pair);
+static void delete_strings_block(s_ui_712_strings_block *block) {
+    APP_MEM_FREE(block);
+}
+
+static void pairs_free(s_ui_712_pairs *pairs) {
+    APP_MEM_FREE_AND_NULL((void **) &pairs->values);
+    flist_clear((flist_node_t **) &pairs->strings, (f_list_node_del) &delete_strings_block);
+    explicit_bzero(pairs, sizeof(*pairs));
+}
+
+/**
+ * Allocate a string in the review strings pool
+ *
+ * @param[in] length the string length, without the terminating NULL
+ * @return the zeroed string, \ref NULL if the allocation failed
+ */
+static char *pairs_alloc_string(s_ui_712_pairs *pairs, size_t length) {
+    s_ui_712_strings_block *block = pairs->last_strings;
+    size_t capacity;
+    char *str;
+
+    if ((block == NULL) || ((block->size + length + 1) > block->capacity)) {
+        // the bigger strings get a block of their own
+        capacity = MAX(length + 1, UI_712_STRINGS_BLOCK_SIZE);
+        if (capacity > UINT16_MAX) {
+            return NULL;
+        }
+        if (APP_MEM_CALLOC((void **) &block, sizeof(*block) + capacity) == false) {
+            return NULL;
+        }
+        block->capacity = capacity;
+        flist_push_back((flist_node_t **) &pairs->strings, (flist_node_t *) block);
+        pairs->last_strings = block;
+    }
+    str = &block->data[block->size];
+    block->size += length + 1;
+    return str;
+}
+
+/**
+ * Make sure the review pairs array can hold the given number of pairs
+ *
+ * The memory allocator cannot resize an allocation, so a bigger array replaces it. The pairs
+ * only point to the pooled strings, moving them around is fine.
+ *
+ * @param[in] count the number of pairs needed
+ * @return whether it was successful
+ */
+static bool pairs_reserve(s_ui_712_pairs *pairs, uint16_t count) {
+    nbgl_contentTagValue_t *values;
+    uint16_t capacity;
+
+    if (count <= pairs->capacity) {
+        return true;
+    }
+    if (count > UINT8_MAX) {
+        PRINTF("Too many EIP-712 review pairs\n");
+        return false;
+    }
+    capacity = MIN(count + UI_712_PAIRS_GROWTH_STEP, UINT8_MAX);
+    if (APP_MEM_CALLOC((void **) &values, capacity * sizeof(*values)) == false) {
+        return false;
+    }
+    if (pairs->values != NULL) {
+        memcpy(values, pairs->values, pairs->count * sizeof(*values));
+        APP_MEM_FREE(pairs->values);
+    }
+    pairs->values = values;
+    pairs->capacity = capacity;
+    return true;
+}
+
+/**
+ * Append a new review pair
+ *
+ * @return the pair, \ref NULL if the allocation failed
+ */
+static nbgl_contentTagValue_t *pairs_append(s_ui_712_pairs *pairs) {
+    nbgl_contentTagValue_t *pair;
+
+    if (!pairs_reserve(pairs, pairs->count + 1)) {
+        return NULL;
+    }
+    pair = &pairs->values[pairs->count];
+    explicit_bzero(pair, sizeof(*pair));
+    pair->forcePageStart = pairs->page_start_pending;
+    pairs->page_start_pending = false;
+    pairs->count += 1;
+    return pair;
 }
 
 // to be used as a \ref f_list_node_del
@@ -162,30 +315,21 @@ void ui_712_finalize_field(void) {
  *
  */
 void ui_712_set_intent(void) {
-    s_ui_712_pair *new_pair = NULL;
-    const char *title = "Review transaction";
-    size_t title_length = strlen(title);
-
-    // Allocate memory for the new pair
-    if (APP_MEM_CALLOC((void **) &new_pair, sizeof(*new_pair)) == false) {
-        return;
-    }
-    // Add it to the chained list
-    flist_push_back((flist_node_t **) &ui_ctx->ui_pairs, (flist_node_t *) new_pair);
+    nbgl_contentTagValue_t *pair;
+    char *value;
 
-    // Allocate and copy the title
-    if (APP_MEM_CALLOC((void **) &new_pair->key, title_length + 1) == false) {
+    if ((pair = pairs_append(&ui_ctx->pairs)) == NULL) {
         return;
     }
-    memcpy(new_pair->key, title, title_length);
-
-    // Allocate and clear the intent buffer
-    if (APP_MEM_CALLOC((void **) &new_pair->value, N_OF_M_LENGTH) == false) {
+    // "nn of mm" placeholder, only filled once the batch size is known
+    if ((value = pairs_alloc_string(&ui_ctx->pairs, N_OF_M_LENGTH - 1)) == NULL) {
+        ui_ctx->pairs.count -= 1;
         return;
     }
-
-    // Mark it as an intent
-    new_pair->start_intent = true;
+    pair->item = "Review transaction";
+    pair->value = value;
+    pair->centeredInfo = true;
+    ui_ctx->pairs.intent_count += 1;
 }
 
 /**
@@ -195,16 +339,18 @@ void ui_712_set_intent(void) {
  * @param[in] length its length
  */
 void ui_712_set_title(const char *str, size_t length) {
-    s_ui_712_pair *new_pair = NULL;
+    nbgl_contentTagValue_t *pair;
+    char *key;
 
-    if (APP_MEM_CALLOC((void **) &new_pair, sizeof(*new_pair)) == false) {
+    if ((pair = pairs_append(&ui_ctx->pairs)) == NULL) {
         return;
     }
-    flist_push_back((flist_node_t **) &ui_ctx->ui_pairs, (flist_node_t *) new_pair);
-    if (APP_MEM_CALLOC((void **) &new_pair->key, length + 1) == false) {
+    if ((key = pairs_alloc_string(&ui_ctx->pairs, length)) == NULL) {
+        ui_ctx->pairs.count -= 1;
         return;
     }
-    memcpy(new_pair->key, str, length);
+    memcpy(key, str, length);
+    pair->item = key;
 }
 
 /**
@@ -216,34 +362,33 @@ void ui_712_set_title(const char *str, size_t length) {
  * @param[in] length its length
  */
 void ui_712_set_value(const char *str, size_t length) {
-    s_ui_712_pair *tmp = ui_ctx->ui_pairs;
+    nbgl_contentTagValue_t *pair;
+    char *value;
 
-    if (tmp == NULL) {
+    if (ui_ctx->pairs.count == 0) {
         // No pairs created yet
         return;
     }
-    while (((flist_node_t *) tmp)->next != NULL) {
-        tmp = (s_ui_712_pair *) ((flist_node_t *) tmp)->next;
-    }
-    if (tmp->value != NULL) {
-        PRINTF("Value already exist for tag %s: %s\n", tmp->key, tmp->value);
+    pair = &ui_ctx->pairs.values[ui_ctx->pairs.count - 1];
+    if (pair->value != NULL) {
+        PRINTF("Value already exist for tag %s: %s\n", pair->item, pair->value);
         return;
     }
-    if ((str != NULL) && (length > 0)) {
-        // buffer is directly provided with parameters
-        if (APP_MEM_CALLOC((void **) &tmp->value, length + 1) == false) {
-            return;
-        }
-        memcpy(tmp->value, str, length);
-    } else {
+    if ((str == NULL) || (length == 0)) {
         // Add the value from the global variable strings.tmp.tmp
-        if ((tmp->value = APP_MEM_STRDUP(strings.tmp.tmp)) == NULL) {
-            return;
-        }
+        str = strings.tmp.tmp;
+        length = strlen(strings.tmp.tmp);
+    }
+    if ((value = pairs_alloc_string(&ui_ctx->pairs, length)) == NULL) {
+        return;
     }
-    tmp->end_intent = validate_instruction_hash();
-    if (tmp->end_intent) {
+    memcpy(value, str, length);
+    pair->value = value;
+    if (validate_instruction_hash()) {
         PRINTF("[Intent] End\n");
+        // the next pair starts a new page, only kept for batches of several transactions
+        ui_ctx->pairs.page_start_pending = true;
+        ui_ctx->pairs.intent_end_count += 1;
     }
 }
 
@@ -293,7 +438,7 @@ bool ui_712_review_struct(const s_struct_712 *struct_ptr) {
     }
 
     ui_712_set_title(title, strlen(title));
-    if ((struct_name = struct_ptr->name) != NULL) {
+    if ((struct_name = get_struct_name(struct_ptr)) != NULL) {
         ui_712_set_value(struct_name, strlen(struct_name));
     }
     return ui_712_redraw_generic_step();
@@ -632,8 +777,7 @@ static bool update_amount_join(const uint8_t *data, uint8_t length) {
     } else {
         if (tmpCtx.transactionContext.currentAssetIndex == ui_ctx->amount.idx) {
             // So that the following amount-join find their tokens in the expected indices
-            tmpCtx.transactionContext.currentAssetIndex =
-                (tmpCtx.transactionContext.currentAssetIndex + 1) % MAX_ASSETS;
+            skip_current_asset_info();
         }
     }
     switch (ui_ctx->amount.state) {
@@ -1084,13 +1228,8 @@ static void delete_calldata_info(s_eip712_calldata_info *node) {
  */
 void ui_712_deinit(void) {
     if (ui_ctx != NULL) {
-        if (ui_ctx->filters_crc != NULL) {
-            flist_clear((flist_node_t **) &ui_ctx->filters_crc,
-                        (f_list_node_del) &delete_filter_crc);
-        }
-        if (ui_ctx->ui_pairs != NULL) {
-            flist_clear((flist_node_t **) &ui_ctx->ui_pairs, (f_list_node_del) &delete_ui_pair);
-        }
+        filter_crc_set_free(&ui_ctx->filters_crc);
+        pairs_free(&ui_ctx->pairs);
         if (ui_ctx->amount.joins != NULL) {
             flist_clear((flist_node_t **) &ui_ctx->amount.joins,
                         (f_list_node_del) &delete_amount_join);
@@ -1181,10 +1320,16 @@ e_eip712_filtering_mode ui_712_get_filtering_mode(void) {
  * Set the number of filters this message should process
  *
  * @param[in] count number of filters
+ * @return whether it was successful or not
  */
-void ui_712_set_filters_count(uint8_t count) {
+bool ui_712_set_filters_count(uint8_t count) {
+    if (!filter_crc_set_init(&ui_ctx->filters_crc, count)) {
+        apdu_response_code = SWO_INSUFFICIENT_MEMORY;
+        return false;
+    }
     ui_ctx->filters_to_process = count;
     ui_ctx->message_info_received = true;
+    return true;
 }
 
 /**
@@ -1193,7 +1338,7 @@ void ui_712_set_filters_count(uint8_t count) {
  * @return number of filters
  */
 uint8_t ui_712_remaining_filters(void) {
-    return ui_ctx->filters_to_process - flist_size((flist_node_t **) &ui_ctx->filters_crc);
+    return ui_ctx->filters_to_process - ui_ctx->filters_crc.count;
 }
 
 bool ui_712_message_info_received(void) {
@@ -1251,7 +1396,7 @@ bool ui_712_token_join_prepare_amount(uint8_t index, const char *name, uint8_t n
 bool ui_712_show_raw_key(const s_struct_712_field *field_ptr) {
     const char *key;
 
-    if ((key = field_ptr->key_name) == NULL) {
+    if ((key = get_struct_field_keyname(field_ptr)) == NULL) {
         return false;
     }
 
@@ -1268,33 +1413,30 @@ bool ui_712_show_raw_key(const s_struct_712_field *field_ptr) {
  * @return whether it was successful or not
  */
 bool ui_712_push_new_filter_path(uint32_t path_crc) {
-    s_filter_crc *tmp;
-    s_filter_crc *new_crc;
-    uint8_t filter_count = 0;
+    s_filter_crc_set *set = &ui_ctx->filters_crc;
+    uint8_t slot;
 
+    if (set->capacity == 0) {
+        // no message info received yet
+        apdu_response_code = SWO_INCORRECT_DATA;
+        return false;
+    }
     // check if already present
-    for (tmp = ui_ctx->filters_crc; tmp != NULL;
-         tmp = (s_filter_crc *) ((flist_node_t *) tmp)->next) {
-        if (tmp->value == path_crc) {
-            PRINTF("EIP-712 path CRC (%x) already found!\n", path_crc);
-            return true;
-        }
-        filter_count += 1;
+    slot = filter_crc_set_slot(set, path_crc);
+    if (set->used[slot / 8] & (1 << (slot % 8))) {
+        PRINTF("EIP-712 path CRC (%x) already found!\n", path_crc);
+        return true;
     }
 
-    if (filter_count >= ui_ctx->filters_to_process) {
+    if (set->count >= ui_ctx->filters_to_process) {
         apdu_response_code = SWO_INCORRECT_DATA;
         return false;
     }
-    // allocate it
-    if (APP_MEM_CALLOC((void **) &new_crc, sizeof(*new_crc)) == false) {
-        apdu_response_code = SWO_INSUFFICIENT_MEMORY;
-        return false;
-    }
-    new_crc->value = path_crc;
+    set->values[slot] = path_crc;
+    set->used[slot / 8] |= (1 << (slot % 8));
+    set->count += 1;
 
     PRINTF("Pushing new EIP-712 path CRC (%x)\n", path_crc);
-    flist_push_back((flist_node_t **) &ui_ctx->filters_crc, (flist_node_t *) new_crc);
     return true;
 }
 
@@ -1343,53 +1485,53 @@ void ui_712_set_trusted_name_requirements(uint8_t type_count,
 /**
  * Set the tag/value pairs for the review
  *
+ * @return whether it was successful
  */
-void ui_712_push_pairs(void) {
-    uint8_t nbPairs = 0;
-    uint8_t pair = 0;
-    s_ui_712_pair *tmp = NULL;
+bool ui_712_push_pairs(void) {
+    s_ui_712_pairs *pairs = &ui_ctx->pairs;
+    nbgl_contentTagValue_t *pair;
+    uint8_t nbPairs = pairs->count;
     uint8_t tx_idx = 0;
 
-    // Initialize the pairs list
-    nbPairs = flist_size((flist_node_t **) &ui_ctx->ui_pairs);
     if (N_storage.displayHash) {
+        // room for the hashes
+        if (!pairs_reserve(pairs, nbPairs + 2)) {
+            return false;
+        }
         nbPairs += 2;
     }
-
-    ui_pairs_init(nbPairs);
-    // Initialize the tag/value pairs from the chain list
-    tmp = ui_ctx->ui_pairs;
-    while (tmp != NULL) {
-        if (tmp->start_intent) {
-            // Batch intermediate page
-            tx_idx++;
-            // Replace "nn of mm" placeholder, initialized in ui_712_set_intent()
-            snprintf(tmp->value, N_OF_M_LENGTH, "%d of %d", tx_idx, txContext.batch_nb_tx);
-            g_pairs[pair].centeredInfo = true;
-        }
-        g_pairs[pair].item = tmp->key;
-        g_pairs[pair].value = tmp->value;
-        LEDGER_ASSERT(pair < g_pairsList->nbPairs,
-                      "EIP-712 pair overflow (%d / %d)",
-                      pair,
-                      g_pairsList->nbPairs);
-        pair++;
-        if ((tmp->end_intent) && (txContext.batch_nb_tx > 1)) {
-            // End of batch transaction : start next info on full page
-            g_pairs[pair].forcePageStart = true;
+    // the batch size is only known now, after all the pairs got received
+    if ((pairs->intent_count > 0) || (pairs->intent_end_count > 0)) {
+        for (uint8_t i = 0; i < pairs->count; ++i) {
+            pair = &pairs->values[i];
+            if (pair->centeredInfo) {
+                // Batch intermediate page
+                tx_idx++;
+                // Replace "nn of mm" placeholder, initialized in ui_712_set_intent()
+                snprintf((char *) pair->value,
+                         N_OF_M_LENGTH,
+                         "%d of %d",
+                         tx_idx,
+                         txContext.batch_nb_tx);
+            }
+            if (txContext.batch_nb_tx <= 1) {
+                pair->forcePageStart = false;
+            }
         }
-        tmp = (s_ui_712_pair *) ((flist_node_t *) tmp)->next;
     }
+    // handed over to the NBGL pairs list, which only owns it once successful
+    if (!ui_pairs_set(pairs->values, nbPairs)) {
+        return false;
+    }
+    pairs->values = NULL;
+    pairs->capacity = 0;
 
     if (N_storage.displayHash) {
-        LEDGER_ASSERT(pair < g_pairsList->nbPairs,
-                      "EIP-712 pair overflow for Hash (%d / %d)",
-                      pair,
-                      g_pairsList->nbPairs);
         // Prepare the pairs list with the hashes
-        eip712_format_hash(pair);
-        g_pairs[pair].forcePageStart = true;
+        eip712_format_hash(pairs->count);
+        g_pairs[pairs->count].forcePageStart = true;
     }
+    return true;
 }
 
 void add_calldata_info(s_eip712_calldata_info *node) {
@@ -11,14 +11,6 @@
 
 typedef enum { EIP712_FILTERING_BASIC, EIP712_FILTERING_FULL } e_eip712_filtering_mode;
 
-typedef struct ui_712_pair {
-    flist_node_t _list;
-    char *key;
-    char *value;
-    bool start_intent;  // This pair starts a new transaction in a batch
-    bool end_intent;    // This pair ends a transaction in a batch
-} s_ui_712_pair;
-
 typedef enum {
     CALLDATA_FLAG_ADDR_NONE = 0,
     CALLDATA_FLAG_ADDR_FILTER = 1,
@@ -89,7 +81,7 @@ void ui_712_field_flags_reset(void);
 void ui_712_finalize_field(void);
 void ui_712_set_filtering_mode(e_eip712_filtering_mode mode);
 e_eip712_filtering_mode ui_712_get_filtering_mode(void);
-void ui_712_set_filters_count(uint8_t count);
+bool ui_712_set_filters_count(uint8_t count);
 uint8_t ui_712_remaining_filters(void);
 bool ui_712_message_info_received(void);
 void ui_712_queue_struct_to_review(void);
@@ -105,7 +97,7 @@ void ui_712_set_trusted_name_requirements(uint8_t type_count,
                                           const e_name_type *types,
                                           uint8_t source_count,
                                           const e_name_source *sources);
-void ui_712_push_pairs(void);
+bool ui_712_push_pairs(void);
 void add_calldata_info(s_eip712_calldata_info *node);
 s_eip712_calldata_info *get_calldata_info(uint8_t index);
 s_eip712_calldata_info *get_current_calldata_info(void);
@@ -7,6 +7,8 @@
 #include "ui_logic.h"
 #include "ui_nbgl.h"
 #include "cmd_get_tx_simulation.h"
+#include "syscall_stats.h"
+#include "phase_trace.h"
 
 static const uint8_t EIP_712_MAGIC[] = {0x19, 0x01};
 
@@ -37,6 +39,7 @@ void ui_712_approve_cb(void) {
     PRINTF("EIP712 Message hash 0x%.*h\n", 32, tmpCtx.messageSigningContext712.messageHash);
 
     unsigned int info = 0;
+    PHASE_BEGIN(SIGNATURE, 0);
     CX_ASSERT(bip32_derive_ecdsa_sign_rs_hash_256(CX_CURVE_256K1,
                                                   tmpCtx.messageSigningContext712.bip32.path,
                                                   tmpCtx.messageSigningContext712.bip32.length,
@@ -47,6 +50,7 @@ void ui_712_approve_cb(void) {
                                                   G_io_tx_buffer + 1,
                                                   G_io_tx_buffer + 1 + INT256_LENGTH,
                                                   &info));
+    PHASE_END(SIGNATURE, 0);
     G_io_tx_buffer[0] = ETHEREUM_SIGNATURE_V_BASE;
     if (info & CX_ECCINFO_PARITY_ODD) {
         G_io_tx_buffer[0]++;
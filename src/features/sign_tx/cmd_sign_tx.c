@@ -9,6 +9,8 @@
 #include "app_mem_utils.h"
 #include "mem_utils.h"
 #include "tx_ctx.h"
+#include "syscall_stats.h"
+#include "phase_trace.h"
 
 typedef enum {
     SIGN_MODE_BASIC = 0,
@@ -159,10 +161,13 @@ uint16_t handle_sign(uint8_t p1,
                 PRINTF("Error: remnant unprocessed TX context!\n");
                 return SWO_COMMAND_NOT_ALLOWED;
             }
+            PHASE_BEGIN(UI_BUILD, 0);
             if (!ui_gcs()) {
+                PHASE_END(UI_BUILD, false);
                 ui_gcs_cleanup();
                 return SWO_NOT_SUPPORTED_ERROR_NO_INFO;
             }
+            PHASE_END(UI_BUILD, true);
             *flags |= IO_ASYNCH_REPLY;
             return APDU_NO_RESPONSE;
         default:
@@ -173,7 +178,9 @@ uint16_t handle_sign(uint8_t p1,
         PRINTF("Parser not initialized\n");
         return SWO_COMMAND_NOT_ALLOWED;
     }
+    PHASE_BEGIN(RLP_PARSE, length - offset);
     parserStatus_e pstatus = process_tx(&txContext, &payload[offset], length - offset);
+    PHASE_END(RLP_PARSE, pstatus);
     sw = handle_parsing_status(pstatus);
     if (p2 == SIGN_MODE_BASIC) {
         if ((pstatus == USTREAM_FINISHED) && (sw == SWO_SUCCESS)) {
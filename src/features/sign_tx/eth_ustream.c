@@ -28,6 +28,7 @@
 #include "shared_context.h"  // tmpContent
 #include "read.h"            // read_u64_be
 #include "network.h"         // get_tx_chain_id
+#include "syscall_stats.h"
 
 static bool check_fields(txContext_t *context, const char *name, uint32_t length) {
     UNUSED(name);  // Just for the case where DEBUG is not enabled
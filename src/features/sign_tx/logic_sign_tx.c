@@ -18,6 +18,9 @@
 #include "mem_utils.h"
 #include "tx_ctx.h"
 #include "eth_swap_utils.h"
+#include "syscall_stats.h"
+#include "phase_trace.h"
+#include "plugin_parameters.h"
 
 static uint32_t split_binary_parameter_part(char *result, size_t result_size, uint8_t *parameter) {
     uint32_t i;
@@ -61,6 +64,7 @@ customStatus_e custom_processor(txContext_t *context) {
                 return CUSTOM_FAULT;
             }
             dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_UNAVAILABLE;
+            dataContext.tokenContext.pluginBatching = false;
             // If contract debugging mode is activated, do not go through the plugin activation
             // as they wouldn't be displayed if the plugin consumes all data but fallbacks
             // Still go through plugin activation in Swap context
@@ -69,8 +73,10 @@ customStatus_e custom_processor(txContext_t *context) {
                     eth_plugin_prepare_init(&pluginInit,
                                             context->workBuffer,
                                             context->currentFieldLength);
+                    PHASE_BEGIN(PLUGIN_INIT, 0);
                     dataContext.tokenContext.pluginStatus =
                         eth_plugin_perform_init(tmpContent.txContent.destination, &pluginInit);
+                    PHASE_END(PLUGIN_INIT, dataContext.tokenContext.pluginStatus);
                 }
             }
             PRINTF("pluginstatus %d\n", dataContext.tokenContext.pluginStatus);
@@ -81,6 +87,7 @@ customStatus_e custom_processor(txContext_t *context) {
             } else if (status >= ETH_PLUGIN_RESULT_SUCCESSFUL) {
                 dataContext.tokenContext.fieldIndex = 0;
                 dataContext.tokenContext.fieldOffset = 0;
+                dataContext.tokenContext.pluginBatching = plugin_batching_enabled(&pluginInit);
                 if (copy_tx_data(context, NULL, 4) == false) {
                     return CUSTOM_FAULT;
                 }
@@ -112,6 +119,15 @@ customStatus_e custom_processor(txContext_t *context) {
                  dataContext.tokenContext.pluginStatus <= ETH_PLUGIN_RESULT_UNSUCCESSFUL)) {
                 return CUSTOM_NOT_HANDLED;
             }
+            if ((dataContext.tokenContext.pluginStatus >= ETH_PLUGIN_RESULT_SUCCESSFUL) &&
+                dataContext.tokenContext.pluginBatching &&
+                (dataContext.tokenContext.fieldOffset == 0)) {
+                customStatus_e ret = provide_plugin_parameters(context);
+
+                if (ret != CUSTOM_NOT_HANDLED) {
+                    return ret;
+                }
+            }
             blockSize =
                 CALLDATA_CHUNK_SIZE - (dataContext.tokenContext.fieldOffset % CALLDATA_CHUNK_SIZE);
         }
@@ -509,18 +525,26 @@ end:
 }
 
 static uint16_t start_signature_flow(void) {
+    uint16_t sw;
+
+    PHASE_BEGIN(UI_BUILD, 0);
     if (pluginType == PLUGIN_TYPE_NONE) {
-        return ux_approve_tx(false);
+        sw = ux_approve_tx(false);
+    } else {
+        dataContext.tokenContext.pluginUiState = PLUGIN_UI_OUTSIDE;
+        dataContext.tokenContext.pluginUiCurrentItem = 0;
+        sw = ux_approve_tx(true);
     }
-    dataContext.tokenContext.pluginUiState = PLUGIN_UI_OUTSIDE;
-    dataContext.tokenContext.pluginUiCurrentItem = 0;
-    return ux_approve_tx(true);
+    PHASE_END(UI_BUILD, sw);
+    return sw;
 }
 
 uint16_t finalize_parsing(const txContext_t *context) {
     uint16_t sw = SWO_PARAMETER_ERROR_NO_INFO;
 
+    PHASE_BEGIN(FIELD_FORMAT, 0);
     sw = finalize_parsing_helper(context);
+    PHASE_END(FIELD_FORMAT, sw);
     if (sw != SWO_SUCCESS) {
         return sw;
     }
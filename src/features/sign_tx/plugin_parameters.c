@@ -0,0 +1,67 @@
+#include "shared_context.h"
+#include "eth_plugin_handler.h"
+#include "plugin_parameters.h"
+
+/**
+ * @brief Whether the initialized plugin receives the parameters in batches
+ *
+ * Only external plugins are costly enough to call for it to matter, and they have to opt in, since
+ * the ones predating the message may answer it with an error.
+ *
+ * @param[in] init ETH_PLUGIN_INIT_CONTRACT message, as answered by the plugin
+ * @return whether ETH_PLUGIN_PROVIDE_PARAMETERS can be sent
+ */
+bool plugin_batching_enabled(const ethPluginInitContract_t *init) {
+    return (pluginType == PLUGIN_TYPE_EXTERNAL) &&
+           (init->interfaceVersion == ETH_PLUGIN_PROVIDE_PARAMETERS_OPT_IN);
+}
+
+/**
+ * @brief Provide all the complete parameters available in the APDU to the plugin at once
+ *
+ * Saves a plugin call per parameter, which is expensive for external plugins. A plugin that opted
+ * in may still decline them, it then gets the parameters one by one from then on.
+ *
+ * @param[in] context TX context
+ * @return CUSTOM_HANDLED if the parameters were provided, CUSTOM_NOT_HANDLED if the regular path
+ * has to be used, CUSTOM_FAULT on error
+ */
+customStatus_e provide_plugin_parameters(txContext_t *context) {
+    ethPluginProvideParameters_t provide_parameters;
+    eth_plugin_result_t ret;
+    uint32_t length;
+
+    length = context->currentFieldLength - context->currentFieldPos;
+    if (context->commandLength < length) {
+        length = context->commandLength;
+    }
+    length -= length % CALLDATA_CHUNK_SIZE;
+    // not worth it for a single parameter
+    if (length <= CALLDATA_CHUNK_SIZE) {
+        return CUSTOM_NOT_HANDLED;
+    }
+    eth_plugin_prepare_provide_parameters(
+        &provide_parameters,
+        context->workBuffer,
+        dataContext.tokenContext.fieldIndex * CALLDATA_CHUNK_SIZE + CALLDATA_SELECTOR_SIZE,
+        length);
+    ret = eth_plugin_call(ETH_PLUGIN_PROVIDE_PARAMETERS, (void *) &provide_parameters);
+    if ((ret == ETH_PLUGIN_RESULT_UNAVAILABLE) || (ret == ETH_PLUGIN_RESULT_FALLBACK)) {
+        PRINTF("Plugin declined the batched parameters\n");
+        dataContext.tokenContext.pluginBatching = false;
+        return CUSTOM_NOT_HANDLED;
+    }
+    if (ret != ETH_PLUGIN_RESULT_OK) {
+        PRINTF("Plugin parameters call failed\n");
+        return CUSTOM_FAULT;
+    }
+    if (copy_tx_data(context, NULL, length) == false) {
+        return CUSTOM_FAULT;
+    }
+    if (context->currentFieldPos == context->currentFieldLength) {
+        context->currentField++;
+        context->processingField = false;
+    }
+    dataContext.tokenContext.fieldIndex += length / CALLDATA_CHUNK_SIZE;
+    return CUSTOM_HANDLED;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <stdbool.h>
+#include "eth_ustream.h"
+#include "eth_plugin_interface.h"
+
+bool plugin_batching_enabled(const ethPluginInitContract_t *init);
+customStatus_e provide_plugin_parameters(txContext_t *context);
@@ -4,10 +4,12 @@
 #include "feature_sign_tx.h"
 #include "apdu_constants.h"
 #include "ui_callbacks.h"
+#include "phase_trace.h"
 
 uint32_t io_seproxyhal_touch_tx_ok(void) {
     uint32_t info = 0;
     int err = 0;
+    PHASE_BEGIN(SIGNATURE, 0);
     CX_ASSERT(bip32_derive_ecdsa_sign_rs_hash_256(CX_CURVE_256K1,
                                                   tmpCtx.transactionContext.bip32.path,
                                                   tmpCtx.transactionContext.bip32.length,
@@ -18,6 +20,7 @@ uint32_t io_seproxyhal_touch_tx_ok(void) {
                                                   G_io_tx_buffer + 1,
                                                   G_io_tx_buffer + 1 + INT256_LENGTH,
                                                   &info));
+    PHASE_END(SIGNATURE, 0);
 
     if (txContext.txType == EIP1559 || txContext.txType == EIP2930 || txContext.txType == EIP7702) {
         if (info & CX_ECCINFO_PARITY_ODD) {
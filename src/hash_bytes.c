@@ -1,4 +1,5 @@
 #include "hash_bytes.h"
+#include "syscall_stats.h"
 
 /**
  * Continue given progressive hash on given bytes
@@ -1,6 +1,141 @@
 #include "apdu_constants.h"
 #include "public_keys.h"
 #include "ledger_pki.h"
+#include "hash_bytes.h"
+#include "syscall_stats.h"
+#include "phase_trace.h"
+
+#ifndef HAVE_BYPASS_SIGNATURES
+
+#define SIG_CACHE_SIZE 8
+
+typedef struct {
+    uint8_t digest[CX_SHA256_SIZE];
+    // LRU tick of the last use, 0 if the entry is free
+    uint32_t last_use;
+} s_sig_cache_entry;
+
+// Successful signature verifications, so that identical signed descriptors are not verified again
+static struct {
+    s_sig_cache_entry entries[SIG_CACHE_SIZE];
+    // digest of the certificate loaded when the entries were verified
+    uint8_t cert_digest[CX_SHA256_SIZE];
+    uint32_t tick;
+} g_sig_cache;
+
+/**
+ * Flush the cache if the loaded certificate is not the one the entries were verified with
+ *
+ * The certificate is told apart by its content, so reloading the very same one keeps the cache:
+ * the verifications made with it still hold.
+ */
+static void sig_cache_sync_cert(void) {
+    uint8_t key_usage;
+    uint8_t digest[CX_SHA256_SIZE];
+
+    // all zeroes if no certificate is loaded
+    get_pki_cert_fingerprint(&key_usage, digest);
+    if (memcmp(digest, g_sig_cache.cert_digest, sizeof(digest)) != 0) {
+        explicit_bzero(&g_sig_cache, sizeof(g_sig_cache));
+        memcpy(g_sig_cache.cert_digest, digest, sizeof(digest));
+    }
+}
+
+/**
+ * Compute the cache key of a signature verification
+ *
+ * @return whether it was successful
+ */
+static bool sig_cache_key(const uint8_t *hash,
+                          uint8_t hash_len,
+                          const uint8_t *pub_key,
+                          uint8_t key_len,
+                          uint8_t key_usage,
+                          const uint8_t *sig,
+                          uint8_t sig_len,
+                          uint8_t *out) {
+    cx_sha256_t hash_ctx;
+
+    cx_sha256_init(&hash_ctx);
+    hash_byte(key_usage, (cx_hash_t *) &hash_ctx);
+    hash_byte(key_len, (cx_hash_t *) &hash_ctx);
+    if (key_len > 0) {
+        hash_nbytes(pub_key, key_len, (cx_hash_t *) &hash_ctx);
+    }
+    hash_byte(hash_len, (cx_hash_t *) &hash_ctx);
+    hash_nbytes(hash, hash_len, (cx_hash_t *) &hash_ctx);
+    hash_byte(sig_len, (cx_hash_t *) &hash_ctx);
+    hash_nbytes(sig, sig_len, (cx_hash_t *) &hash_ctx);
+    return finalize_hash((cx_hash_t *) &hash_ctx, out, CX_SHA256_SIZE);
+}
+
+static bool sig_cache_lookup(const uint8_t *key) {
+    for (uint8_t i = 0; i < SIG_CACHE_SIZE; ++i) {
+        s_sig_cache_entry *entry = &g_sig_cache.entries[i];
+
+        if ((entry->last_use != 0) && (memcmp(entry->digest, key, sizeof(entry->digest)) == 0)) {
+            entry->last_use = ++g_sig_cache.tick;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void sig_cache_insert(const uint8_t *key) {
+    s_sig_cache_entry *lru = &g_sig_cache.entries[0];
+
+    // a free entry always has the lowest tick
+    for (uint8_t i = 1; i < SIG_CACHE_SIZE; ++i) {
+        if (g_sig_cache.entries[i].last_use < lru->last_use) {
+            lru = &g_sig_cache.entries[i];
+        }
+    }
+    memcpy(lru->digest, key, sizeof(lru->digest));
+    lru->last_use = ++g_sig_cache.tick;
+}
+
+#endif  // HAVE_BYPASS_SIGNATURES
+
+/**
+ * Compute the fingerprint of the loaded certificate
+ *
+ * @param[out] key_usage key usage of the certificate, 0 if there is none
+ * @param[out] fingerprint SHA-256 of its key usage, trusted name and public key, all zeroes if
+ * there is none
+ * @return whether a certificate is loaded and got fingerprinted
+ */
+bool get_pki_cert_fingerprint(uint8_t *key_usage, uint8_t *fingerprint) {
+    size_t trusted_name_len = 0;
+    uint8_t trusted_name[CERTIFICATE_TRUSTED_NAME_MAXLEN] = {0};
+    cx_ecfp_384_public_key_t public_key = {0};
+    cx_sha256_t hash_ctx;
+
+    *key_usage = 0;
+    explicit_bzero(fingerprint, CX_SHA256_SIZE);
+    if (os_pki_get_info(key_usage, trusted_name, &trusted_name_len, &public_key) != 0) {
+        *key_usage = 0;
+        return false;
+    }
+    cx_sha256_init(&hash_ctx);
+    hash_byte(*key_usage, (cx_hash_t *) &hash_ctx);
+    hash_nbytes(trusted_name, trusted_name_len, (cx_hash_t *) &hash_ctx);
+    hash_nbytes(public_key.W, public_key.W_len, (cx_hash_t *) &hash_ctx);
+    if (!finalize_hash((cx_hash_t *) &hash_ctx, fingerprint, CX_SHA256_SIZE)) {
+        *key_usage = 0;
+        explicit_bzero(fingerprint, CX_SHA256_SIZE);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Forget every cached signature verification
+ */
+void sig_cache_clear(void) {
+#ifndef HAVE_BYPASS_SIGNATURES
+    explicit_bzero(&g_sig_cache, sizeof(g_sig_cache));
+#endif
+}
 
 bool check_signature_with_pubkey(uint8_t *hash,
                                  const uint8_t hash_len,
@@ -15,6 +150,8 @@ bool check_signature_with_pubkey(uint8_t *hash,
     const cx_curve_t expected_curve = CX_CURVE_256K1;
     const buffer_t buffer = {.ptr = hash, .size = hash_len};
     const buffer_t signature = {.ptr = (uint8_t *) sig, .size = sig_len};
+    uint8_t cache_key[CX_SHA256_SIZE];
+    bool cacheable;
 #endif
 
     PRINTF("==================================================================\n");
@@ -30,6 +167,14 @@ bool check_signature_with_pubkey(uint8_t *hash,
     PRINTF("********** Bypass signature check **********\n");
     ret = true;
 #else
+    PHASE_BEGIN(DESCRIPTOR_CHECK, keyUsageExp);
+    sig_cache_sync_cert();
+    cacheable = sig_cache_key(hash, hash_len, PubKey, keyLen, keyUsageExp, sig, sig_len, cache_key);
+    if (cacheable && sig_cache_lookup(cache_key)) {
+        PRINTF("Signature already verified\n");
+        PHASE_END(DESCRIPTOR_CHECK, true);
+        return true;
+    }
     switch (check_signature_with_pki(buffer, &keyUsageExp, &expected_curve, signature)) {
         case CHECK_SIGNATURE_WITH_PKI_SUCCESS:
             ret = true;
@@ -58,6 +203,10 @@ bool check_signature_with_pubkey(uint8_t *hash,
             ret = false;
             break;
     }
+    if (ret && cacheable) {
+        sig_cache_insert(cache_key);
+    }
+    PHASE_END(DESCRIPTOR_CHECK, ret);
 #endif
     return ret;
 }
@@ -30,21 +30,13 @@
 #include "handle_get_printable_amount.h"
 #include "handle_check_address.h"
 #include "swap_entrypoints.h"
-#include "commands_712.h"
 #include "challenge.h"
-#include "cmd_trusted_name.h"
+#include "trusted_name.h"
 #include "crypto_helpers.h"
 #include "manage_asset_info.h"
-#include "cmd_network_info.h"
 #include "app_mem_utils.h"
 #include "mem_utils.h"
-#include "cmd_enum_value.h"
-#include "cmd_tx_info.h"
-#include "cmd_field.h"
-#include "cmd_get_tx_simulation.h"
 #include "cmd_get_gating.h"
-#include "cmd_proxy_info.h"
-#include "commands_7702.h"
 #include "sign_message.h"
 #include "ui_utils.h"
 #include "network_info.h"
@@ -52,6 +44,11 @@
 #include "tx_ctx.h"
 #include "enum_value.h"
 #include "proxy_info.h"
+#include "get_public_key.h"
+#include "network_registry.h"
+#include "apdu_dispatcher.h"
+#include "syscall_stats.h"
+#include "phase_trace.h"
 
 tmpCtx_t tmpCtx;
 txContext_t txContext;
@@ -66,7 +63,6 @@ pluginType_t pluginType;
 
 #ifdef HAVE_ETH2
 uint32_t eth2WithdrawalIndex;
-#include "withdrawal_index.h"
 #endif
 
 #include "ux.h"
@@ -103,9 +99,20 @@ void reset_app_context(void) {
 #ifdef HAVE_GATING_SUPPORT
     clear_gating();
 #endif
+#ifdef HAVE_SYSCALL_STATS
+    syscall_stats_end_flow();
+#endif
+}
+
+/**
+ * Called by the SDK on every ticker event
+ */
+void app_ticker_event_callback(void) {
+    pubkey_cache_check_lock();
 }
 
 void app_quit(void) {
+    pubkey_cache_clear();
     network_info_cleanup(NULL);
     reset_app_context();
     app_exit();
@@ -153,144 +160,6 @@ const uint8_t *parseBip32(const uint8_t *dataBuffer, uint8_t *dataLength, bip32_
     return dataBuffer;
 }
 
-static uint16_t handleApdu(command_t *cmd, uint32_t *flags, uint32_t *tx) {
-    uint16_t sw = APDU_NO_RESPONSE;
-
-    if (cmd->cla != CLA) {
-        return SWO_INVALID_CLA;
-    }
-
-    switch (cmd->ins) {
-        case INS_GET_PUBLIC_KEY:
-            forget_known_assets();
-            sw = handle_get_public_key(cmd->p1, cmd->p2, cmd->data, cmd->lc, flags, tx);
-            break;
-
-        case INS_PROVIDE_ERC20_TOKEN_INFORMATION:
-            sw = handle_provide_erc20_token_information(cmd->data, cmd->lc, tx);
-            break;
-
-        case INS_PROVIDE_NFT_INFORMATION:
-            sw = handle_provide_nft_information(cmd->data, cmd->lc, tx);
-            break;
-
-        case INS_SET_EXTERNAL_PLUGIN:
-            sw = handle_set_external_plugin(cmd->data, cmd->lc);
-            break;
-
-        case INS_SET_PLUGIN:
-            sw = handle_set_plugin(cmd->data, cmd->lc);
-            break;
-
-        case INS_PERFORM_PRIVACY_OPERATION:
-            sw = handle_perform_privacy_operation(cmd->p1, cmd->p2, cmd->data, cmd->lc, flags, tx);
-            break;
-
-        case INS_SIGN:
-            sw = handle_sign(cmd->p1, cmd->p2, cmd->data, cmd->lc, flags);
-            break;
-
-        case INS_GET_APP_CONFIGURATION:
-            sw = handle_get_app_configuration(tx);
-            break;
-
-        case INS_SIGN_PERSONAL_MESSAGE:
-            forget_known_assets();
-            sw = handle_sign_personal_message(cmd->p1, cmd->data, cmd->lc, flags);
-            break;
-
-        case INS_SIGN_EIP_712_MESSAGE:
-            switch (cmd->p2) {
-                case P2_EIP712_LEGACY_IMPLEM:
-                    forget_known_assets();
-                    sw = handle_sign_eip712_message_v0(cmd->p1, cmd->data, cmd->lc, flags);
-                    break;
-                case P2_EIP712_FULL_IMPLEM:
-                    sw = handle_eip712_sign(cmd->data, cmd->lc, flags);
-                    break;
-                default:
-                    sw = SWO_WRONG_P1_P2;
-            }
-            break;
-
-#ifdef HAVE_ETH2
-        case INS_GET_ETH2_PUBLIC_KEY:
-            forget_known_assets();
-            sw = handle_get_eth2_public_key(cmd->p1, cmd->p2, cmd->data, cmd->lc, flags, tx);
-            break;
-
-        case INS_SET_ETH2_WITHDRAWAL_INDEX:
-            sw = handle_set_eth2_withdrawal_index(cmd->p1, cmd->p2, cmd->data, cmd->lc);
-            break;
-#endif  // HAVE_ETH2
-
-        case INS_EIP712_STRUCT_DEF:
-            sw = handle_eip712_struct_def(cmd->p2, cmd->data, cmd->lc);
-            break;
-
-        case INS_EIP712_STRUCT_IMPL:
-            sw = handle_eip712_struct_impl(cmd->p1, cmd->p2, cmd->data, cmd->lc, flags);
-            break;
-
-        case INS_EIP712_FILTERING:
-            sw = handle_eip712_filtering(cmd->p1, cmd->p2, cmd->data, cmd->lc, flags);
-            break;
-
-        case INS_GET_CHALLENGE:
-            sw = handle_get_challenge(tx);
-            break;
-
-        case INS_PROVIDE_TRUSTED_NAME:
-            sw = handle_trusted_name(cmd->p1, cmd->data, cmd->lc);
-            break;
-
-        case INS_PROVIDE_ENUM_VALUE:
-            sw = handle_enum_value(cmd->p1, cmd->p2, cmd->lc, cmd->data);
-            break;
-
-        case INS_GTP_TRANSACTION_INFO:
-            sw = handle_tx_info(cmd->p1, cmd->p2, cmd->lc, cmd->data);
-            break;
-
-        case INS_GTP_FIELD:
-            sw = handle_field(cmd->p1, cmd->p2, cmd->lc, cmd->data);
-            break;
-
-        case INS_PROVIDE_PROXY_INFO:
-            sw = handle_proxy_info(cmd->p1, cmd->p2, cmd->lc, cmd->data);
-            break;
-
-        case INS_PROVIDE_NETWORK_CONFIGURATION:
-            sw = handle_network_info(cmd->p1, cmd->p2, cmd->data, cmd->lc, tx);
-            break;
-
-#ifdef HAVE_TRANSACTION_CHECKS
-        case INS_PROVIDE_TX_SIMULATION:
-            sw = handle_tx_simulation(cmd->p1, cmd->p2, cmd->data, cmd->lc, flags);
-            break;
-#endif
-
-        case INS_SIGN_EIP7702_AUTHORIZATION:
-            sw = handle_sign_eip7702_authorization(cmd->p1, cmd->data, cmd->lc, flags);
-            break;
-
-        case INS_PROVIDE_SAFE_ACCOUNT:
-            sw = handle_safe_account(cmd->p1, cmd->p2, cmd->data, cmd->lc, flags);
-            break;
-
-#ifdef HAVE_GATING_SUPPORT
-        case INS_PROVIDE_GATING:
-            sw = handle_gating(cmd->p1, cmd->p2, cmd->data, cmd->lc);
-            break;
-#endif
-
-        default:
-            sw = SWO_INVALID_INS;
-            break;
-    }
-    return sw;
-}
-
 void app_main(void) {
     uint32_t rx = 0;
     uint32_t tx = 0;
@@ -326,7 +195,9 @@ void app_main(void) {
 
                     tx = 0;
                     flags = 0;
-                    sw = handleApdu(&cmd, &flags, &tx);
+                    PHASE_BEGIN(APDU, cmd.ins);
+                    sw = handle_apdu(&cmd, &flags, &tx);
+                    PHASE_END(APDU, sw);
                 }
             }
             CATCH(EXCEPTION_IO_RESET) {
@@ -396,6 +267,10 @@ static void app_init(bool library_mode) {
     common_app_init();
     storage_init();
     if (library_mode == false) {
+#ifdef HAVE_NETWORK_REGISTRY
+        // Restore the persisted dynamic networks
+        network_registry_load();
+#endif
         // If we are not in library mode, we need to initialize the UX
         io_init();
         ui_idle();
@@ -2,6 +2,8 @@
 
 void forget_known_assets(void) {
     memset(tmpCtx.transactionContext.assetSet, false, MAX_ASSETS);
+    tmpCtx.transactionContext.assetUseCount = 0;
+    tmpCtx.transactionContext.assetEvicted = false;
     tmpCtx.transactionContext.currentAssetIndex = 0;
 }
 
@@ -19,13 +21,84 @@ static bool asset_info_is_set(int index) {
     return tmpCtx.transactionContext.assetSet[index];
 }
 
+static uint8_t get_asset_tag(const uint8_t *addr) {
+    uint8_t tag = 0;
+
+    for (int i = 0; i < ADDRESS_LENGTH; ++i) {
+        tag = ((tag << 1) | (tag >> 7)) ^ addr[i];
+    }
+    return tag;
+}
+
+/**
+ * Rank the uses of the assets from 1, keeping their order, so that the counter does not wrap
+ */
+static void renormalize_asset_uses(void) {
+    uint16_t *last_use = tmpCtx.transactionContext.assetLastUse;
+    uint16_t ranks[MAX_ASSETS] = {0};
+    uint16_t count = 0;
+
+    for (uint8_t i = 0; i < MAX_ASSETS; ++i) {
+        if (!asset_info_is_set(i)) {
+            continue;
+        }
+        ranks[i] = 1;
+        for (uint8_t j = 0; j < MAX_ASSETS; ++j) {
+            if (asset_info_is_set(j) && (last_use[j] < last_use[i])) {
+                ranks[i] += 1;
+            }
+        }
+        count += 1;
+    }
+    memcpy(last_use, ranks, sizeof(ranks));
+    tmpCtx.transactionContext.assetUseCount = count;
+}
+
+static void touch_asset_info(int index) {
+    if (tmpCtx.transactionContext.assetUseCount == UINT16_MAX) {
+        renormalize_asset_uses();
+    }
+    tmpCtx.transactionContext.assetUseCount += 1;
+    tmpCtx.transactionContext.assetLastUse[index] = tmpCtx.transactionContext.assetUseCount;
+}
+
+/**
+ * Get the index the next provided asset will be stored at
+ *
+ * Free indices are handed out in order, since the host expects it (e.g. for EIP-712
+ * amount-joins), then the least recently used asset gets evicted.
+ *
+ * @param[in] from index the search starts after
+ * @return the index
+ */
+static uint8_t get_next_asset_index(uint8_t from) {
+    uint8_t lru = from;
+    uint8_t index;
+
+    for (uint8_t offset = 1; offset <= MAX_ASSETS; ++offset) {
+        index = (from + offset) % MAX_ASSETS;
+        if (!asset_info_is_set(index)) {
+            return index;
+        }
+        if (tmpCtx.transactionContext.assetLastUse[index] <
+            tmpCtx.transactionContext.assetLastUse[lru]) {
+            lru = index;
+        }
+    }
+    return lru;
+}
+
 int get_asset_index_by_addr(const uint8_t *addr) {
+    uint8_t tag = get_asset_tag(addr);
+
     // Works for ERC-20 & NFT tokens since both structs in the union have the
     // contract address aligned
     for (int i = 0; i < MAX_ASSETS; i++) {
         extraInfo_t *asset = get_asset_info(i);
-        if (asset_info_is_set(i) && (memcmp(asset->token.address, addr, ADDRESS_LENGTH) == 0)) {
+        if (asset_info_is_set(i) && (tmpCtx.transactionContext.assetTag[i] == tag) &&
+            (memcmp(asset->token.address, addr, ADDRESS_LENGTH) == 0)) {
             PRINTF("Asset found at index %d\n", i);
+            touch_asset_info(i);
             return i;
         }
     }
@@ -37,13 +110,44 @@ extraInfo_t *get_asset_info_by_addr(const uint8_t *addr) {
 }
 
 extraInfo_t *get_current_asset_info(void) {
-    return get_asset_info(tmpCtx.transactionContext.currentAssetIndex);
+    uint8_t index = tmpCtx.transactionContext.currentAssetIndex;
+
+    // about to be overwritten, a failed provisioning must not leave a corrupted asset behind
+    if (asset_info_is_set(index)) {
+        PRINTF("Evicting the asset at index %d\n", index);
+        tmpCtx.transactionContext.assetSet[index] = false;
+        tmpCtx.transactionContext.assetEvicted = true;
+    }
+    return get_asset_info(index);
 }
 
-void validate_current_asset_info(void) {
-    // mark it as set
-    tmpCtx.transactionContext.assetSet[tmpCtx.transactionContext.currentAssetIndex] = true;
-    // increment index
+void skip_current_asset_info(void) {
     tmpCtx.transactionContext.currentAssetIndex =
-        (tmpCtx.transactionContext.currentAssetIndex + 1) % MAX_ASSETS;
+        get_next_asset_index(tmpCtx.transactionContext.currentAssetIndex);
+}
+
+/**
+ * Mark the asset being provided as valid, and write the response
+ *
+ * @param[out] out response buffer
+ * @param[in] p2 APDU P2, \ref P2_ASSET_EVICTION_STATUS to also get whether an asset got evicted
+ * @return response length
+ */
+uint8_t validate_current_asset_info(uint8_t *out, uint8_t p2) {
+    uint8_t index = tmpCtx.transactionContext.currentAssetIndex;
+    uint8_t length = 0;
+
+    out[length++] = index;
+    if ((p2 & P2_ASSET_EVICTION_STATUS) != 0) {
+        // lets the host know that it would have to provide the evicted asset again
+        out[length++] = tmpCtx.transactionContext.assetEvicted;
+    }
+    // mark it as set
+    tmpCtx.transactionContext.assetSet[index] = true;
+    tmpCtx.transactionContext.assetTag[index] =
+        get_asset_tag(tmpCtx.transactionContext.extraInfo[index].token.address);
+    touch_asset_info(index);
+    tmpCtx.transactionContext.assetEvicted = false;
+    skip_current_asset_info();
+    return length;
 }
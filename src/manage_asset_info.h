@@ -2,8 +2,12 @@
 
 #include "shared_context.h"
 
+// PROVIDE ERC20/NFT INFORMATION P2 flag, the response then tells whether an asset got evicted
+#define P2_ASSET_EVICTION_STATUS 0x01
+
 void forget_known_assets(void);
 int get_asset_index_by_addr(const uint8_t *addr);
 extraInfo_t *get_asset_info_by_addr(const uint8_t *contractAddress);
 extraInfo_t *get_current_asset_info(void);
-void validate_current_asset_info(void);
+void skip_current_asset_info(void);
+uint8_t validate_current_asset_info(uint8_t *out, uint8_t p2);
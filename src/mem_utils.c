@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdint.h>
+#include "os_print.h"
 #include "app_mem_utils.h"
 #include "mem_utils.h"
 
@@ -7,6 +8,11 @@
 
 static uint8_t mem_buffer[SIZE_MEM_BUFFER] __attribute__((aligned(sizeof(intmax_t))));
 
+#ifdef HAVE_ARENA_CAP
+// Allocated to make the rest of the buffer unusable
+static void *g_mem_ballast = NULL;
+#endif
+
 /**
  * Initialize the memory buffer.
  *
@@ -16,6 +22,31 @@ bool app_mem_init(void) {
     return mem_utils_init(mem_buffer, sizeof(mem_buffer));
 }
 
+#ifdef HAVE_ARENA_CAP
+/**
+ * Cap the usable size of the memory buffer, for memory pressure tests
+ *
+ * The cap is enforced by allocating the rest of the buffer, so it works on an already used buffer
+ * as long as enough of it is still free.
+ *
+ * @param[in] cap usable size in bytes, 0 to remove the cap
+ * @return whether the cap could be applied
+ */
+bool app_mem_set_cap(uint16_t cap) {
+    if (g_mem_ballast != NULL) {
+        APP_MEM_FREE_AND_NULL(&g_mem_ballast);
+    }
+    if ((cap == 0) || (cap >= SIZE_MEM_BUFFER)) {
+        return cap <= SIZE_MEM_BUFFER;
+    }
+    if ((g_mem_ballast = APP_MEM_ALLOC(SIZE_MEM_BUFFER - cap)) == NULL) {
+        PRINTF("Error: could not cap the memory buffer to %u bytes!\n", cap);
+        return false;
+    }
+    return true;
+}
+#endif
+
 /**
  * Format an unsigned 32-bit value as a string and allocate memory for it.
  *
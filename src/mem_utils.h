@@ -3,4 +3,7 @@
 #include <stdint.h>
 
 bool app_mem_init();
+#ifdef HAVE_ARENA_CAP
+bool app_mem_set_cap(uint16_t cap);
+#endif
 const char *mem_alloc_and_format_uint(uint32_t value);
@@ -7,6 +7,7 @@
 #include "ui_utils.h"
 #include "mem_utils.h"
 #include "cmd_get_gating.h"
+#include "phase_trace.h"
 
 /**
  * @brief Trigger the EIP712 review flow
@@ -71,18 +72,24 @@ static void ui_712_start_review(e_eip712_filtering_mode filtering_mode,
  * @return status code indicating success or failure
  */
 uint16_t ui_sign_712(e_eip712_filtering_mode filtering_mode) {
+    PHASE_BEGIN(UI_BUILD, 0);
     // Initialize the pairs list
-    ui_712_push_pairs();
+    if (!ui_712_push_pairs()) {
+        PHASE_END(UI_BUILD, SWO_INSUFFICIENT_MEMORY);
+        return SWO_INSUFFICIENT_MEMORY;
+    }
 
     if (filtering_mode == EIP712_FILTERING_BASIC) {
 #ifdef HAVE_GATING_SUPPORT
         if (set_gating_warning() == false) {
+            PHASE_END(UI_BUILD, SWO_INCORRECT_DATA);
             return SWO_INCORRECT_DATA;
         }
 #endif
     }
 
     ui_712_start_review(filtering_mode, TYPE_MESSAGE, ui_typed_message_review_choice);
+    PHASE_END(UI_BUILD, SWO_SUCCESS);
     return SWO_SUCCESS;
 }
 
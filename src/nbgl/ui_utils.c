@@ -61,6 +61,28 @@ error:
     return false;
 }
 
+/**
+ * Initialize the pairs list with an already filled pairs array
+ *
+ * Unlike \ref ui_pairs_init, no error status is sent, the caller reports the failure.
+ *
+ * @param[in] pairs the pairs array, freed with the pairs list from now on if successful, still
+ *                  owned by the caller otherwise
+ * @param[in] nbPairs the number of pairs
+ * @return whether the initialization was successful
+ */
+bool ui_pairs_set(nbgl_contentTagValue_t *pairs, uint8_t nbPairs) {
+    ui_pairs_cleanup();
+    if (!APP_MEM_CALLOC((void **) &g_pairsList, sizeof(nbgl_contentTagValueList_t))) {
+        return false;
+    }
+    g_pairs = pairs;
+    g_pairsList->nbPairs = nbPairs;
+    g_pairsList->pairs = g_pairs;
+    g_pairsList->wrapping = true;
+    return true;
+}
+
 /**
  * Initialize the buffers
  *
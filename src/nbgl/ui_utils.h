@@ -12,6 +12,7 @@ extern char *g_finishMsg;
 void ui_all_cleanup(void);
 
 bool ui_pairs_init(uint8_t nbPairs);
+bool ui_pairs_set(nbgl_contentTagValue_t *pairs, uint8_t nbPairs);
 void ui_pairs_cleanup(void);
 
 bool ui_buffers_init(uint8_t title_len, uint8_t subtitle_len, uint8_t finish_len);
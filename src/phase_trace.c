@@ -0,0 +1,107 @@
+#ifdef HAVE_PHASE_TRACE
+
+#include <string.h>
+#include "os.h"
+#include "phase_trace.h"
+
+#ifdef FUZZ
+#include <time.h>
+#else
+// ARM semihosting operations, served by the emulator
+#define SEMIHOSTING_SYS_ELAPSED  0x30
+#define SEMIHOSTING_SYS_TICKFREQ 0x31
+#endif
+
+static s_phase_event g_phase_events[PHASE_TRACE_SIZE];
+// Events recorded since the last clear, the ring buffer index is derived from it
+static uint32_t g_phase_total;
+
+#ifndef FUZZ
+static uint32_t semihosting_call(uint32_t op, void *arg) {
+    register uint32_t r0 __asm__("r0") = op;
+    register void *r1 __asm__("r1") = arg;
+
+    __asm__ volatile("bkpt 0xab" : "+r"(r0) : "r"(r1) : "memory");
+    return r0;
+}
+#endif
+
+/**
+ * Get the monotonic tick
+ *
+ * On the host builds it comes from the system clock. On Speculos, there is no cycle counter
+ * readable by the app, so it comes from the semihosting elapsed time of the emulator, which makes
+ * this feature unusable on a real device.
+ *
+ * @return tick in microseconds
+ */
+static uint32_t get_tick(void) {
+#ifdef FUZZ
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+#else
+    static uint32_t freq = 0;
+    uint32_t elapsed[2];
+
+    if (freq == 0) {
+        freq = semihosting_call(SEMIHOSTING_SYS_TICKFREQ, NULL);
+        if ((freq == 0) || (freq == UINT32_MAX)) {
+            return 0;
+        }
+    }
+    if (semihosting_call(SEMIHOSTING_SYS_ELAPSED, elapsed) != 0) {
+        return 0;
+    }
+    return (uint32_t) (((((uint64_t) elapsed[1]) << 32) | elapsed[0]) * 1000000 / freq);
+#endif
+}
+
+/**
+ * Record a phase boundary
+ *
+ * @param[in] phase the phase
+ * @param[in] edge whether it begins or ends
+ * @param[in] arg phase specific value
+ */
+void phase_trace_add(e_phase phase, e_phase_edge edge, uint16_t arg) {
+    s_phase_event *event = &g_phase_events[g_phase_total % PHASE_TRACE_SIZE];
+
+    event->tick = get_tick();
+    event->arg = arg;
+    event->phase = phase;
+    event->edge = edge;
+    g_phase_total += 1;
+}
+
+uint32_t phase_trace_total(void) {
+    return g_phase_total;
+}
+
+uint8_t phase_trace_count(void) {
+    return MIN(g_phase_total, PHASE_TRACE_SIZE);
+}
+
+/**
+ * Get a recorded event
+ *
+ * @param[in] index index among the kept events, from the oldest one
+ * @return the event, or NULL if out of bounds
+ */
+const s_phase_event *phase_trace_get(uint8_t index) {
+    uint32_t oldest;
+
+    if (index >= phase_trace_count()) {
+        return NULL;
+    }
+    oldest = g_phase_total - phase_trace_count();
+    return &g_phase_events[(oldest + index) % PHASE_TRACE_SIZE];
+}
+
+void phase_trace_clear(void) {
+    explicit_bzero(g_phase_events, sizeof(g_phase_events));
+    g_phase_total = 0;
+}
+
+#endif  // HAVE_PHASE_TRACE
@@ -0,0 +1,53 @@
+#pragma once
+
+/**
+ * Opt-in timing of the signing flows phases
+ *
+ * Each phase boundary is recorded as a fixed-size event in a ring buffer, read back with the debug
+ * statistics APDU. Nothing is printed, so that the timings are not distorted.
+ */
+
+#include <stdint.h>
+
+typedef enum {
+    PHASE_APDU,              // arg: INS, then status word
+    PHASE_RLP_PARSE,         // arg: chunk length, then parser status
+    PHASE_PLUGIN_INIT,       // arg: 0, then plugin result
+    PHASE_DESCRIPTOR_CHECK,  // arg: key usage, then result
+    PHASE_FIELD_FORMAT,      // arg: 0 or field type, then result
+    PHASE_UI_BUILD,          // arg: 0, then result
+    PHASE_SIGNATURE,         // arg: 0
+} e_phase;
+
+typedef enum {
+    PHASE_EDGE_BEGIN,
+    PHASE_EDGE_END,
+} e_phase_edge;
+
+typedef struct {
+    uint32_t tick;  // microseconds
+    uint16_t arg;   // phase specific, see e_phase
+    uint8_t phase;  // e_phase
+    uint8_t edge;   // e_phase_edge
+} s_phase_event;
+
+// Events kept, the oldest ones get overwritten
+#define PHASE_TRACE_SIZE 128
+
+#ifdef HAVE_PHASE_TRACE
+
+void phase_trace_add(e_phase phase, e_phase_edge edge, uint16_t arg);
+uint32_t phase_trace_total(void);
+uint8_t phase_trace_count(void);
+const s_phase_event *phase_trace_get(uint8_t index);
+void phase_trace_clear(void);
+
+#define PHASE_BEGIN(phase, arg) phase_trace_add(PHASE_##phase, PHASE_EDGE_BEGIN, arg)
+#define PHASE_END(phase, arg)   phase_trace_add(PHASE_##phase, PHASE_EDGE_END, arg)
+
+#else
+
+#define PHASE_BEGIN(phase, arg)
+#define PHASE_END(phase, arg)
+
+#endif  // HAVE_PHASE_TRACE
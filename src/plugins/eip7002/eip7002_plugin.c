@@ -8,15 +8,6 @@
 #include "shared_context.h"
 #include "utils.h"
 
-static const uint8_t withdrawal_request_predeploy_address[ADDRESS_LENGTH] = {
-    0x00, 0x00, 0x09, 0x61, 0xEf, 0x48, 0x0E, 0xb5, 0x5e, 0x80,
-    0xD1, 0x9a, 0xd8, 0x35, 0x79, 0xA6, 0x4c, 0x00, 0x70, 0x02,
-};
-
-const uint8_t *const EIP7002_ADDRESSES[NUM_EIP7002_ADDRESSES] = {
-    withdrawal_request_predeploy_address,
-};
-
 #define VALIDATOR_PUBKEY_SIZE   BLS12381_G1_COMPRESSED_PUBKEY_LENGTH
 #define AMOUNT_SIZE             8
 #define WITHDRAWAL_REQUEST_SIZE (VALIDATOR_PUBKEY_SIZE + AMOUNT_SIZE)
@@ -8,15 +8,6 @@
 #include "shared_context.h"
 #include "utils.h"
 
-static const uint8_t consolidation_request_predeploy_address[ADDRESS_LENGTH] = {
-    0x00, 0x00, 0xBB, 0xdD, 0xc7, 0xCE, 0x48, 0x86, 0x42, 0xfb,
-    0x57, 0x9F, 0x8B, 0x00, 0xf3, 0xa5, 0x90, 0x00, 0x72, 0x51,
-};
-
-const uint8_t *const EIP7251_ADDRESSES[NUM_EIP7251_ADDRESSES] = {
-    consolidation_request_predeploy_address,
-};
-
 #define VALIDATOR_PUBKEY_SIZE      BLS12381_G1_COMPRESSED_PUBKEY_LENGTH
 #define CONSOLIDATION_REQUEST_SIZE (VALIDATOR_PUBKEY_SIZE * 2)
 
@@ -10,12 +10,15 @@
 #include "manage_asset_info.h"
 #include "eth_swap_utils.h"
 #include "erc20_plugin.h"
+#include "internal_plugins.gen.h"
 
-typedef enum { ERC20_TRANSFER = 0, ERC20_APPROVE } erc20Selector_t;
-static const uint8_t ERC20_TRANSFER_SELECTOR[SELECTOR_SIZE] = {0xa9, 0x05, 0x9c, 0xbb};
-static const uint8_t ERC20_APPROVE_SELECTOR[SELECTOR_SIZE] = {0x09, 0x5e, 0xa7, 0xb3};
-const uint8_t *const ERC20_SELECTORS[NUM_ERC20_SELECTORS] = {ERC20_TRANSFER_SELECTOR,
-                                                             ERC20_APPROVE_SELECTOR};
+// Indices in g_erc20_selectors, looked up by value in internal_plugins.json
+typedef enum {
+    ERC20_TRANSFER = PLUGIN_ERC20_SELECTOR_IDX_A9059CBB,
+    ERC20_APPROVE = PLUGIN_ERC20_SELECTOR_IDX_095EA7B3,
+} erc20Selector_t;
+_Static_assert(PLUGIN_ERC20_SELECTORS_COUNT == 2,
+               "ERC20 selectors in internal_plugins.json not all handled");
 
 #define MAX_CONTRACT_NAME_LEN 15
 #define MAX_EXTRA_DATA_CHUNKS 2
@@ -47,15 +50,15 @@ void erc20_plugin_call(eth_plugin_msg_t message, void *parameters) {
                 msg->result = ETH_PLUGIN_RESULT_ERROR;
             } else {
                 size_t i;
-                for (i = 0; i < NUM_ERC20_SELECTORS; i++) {
-                    if (memcmp((uint8_t *) PIC(ERC20_SELECTORS[i]),
+                for (i = 0; i < PLUGIN_ERC20_SELECTORS_COUNT; i++) {
+                    if (memcmp(g_erc20_selectors[i],
                                msg->selector,
                                CALLDATA_SELECTOR_SIZE) == 0) {
                         context->selectorIndex = i;
                         break;
                     }
                 }
-                if (i == NUM_ERC20_SELECTORS) {
+                if (i == PLUGIN_ERC20_SELECTORS_COUNT) {
                     PRINTF("Unknown selector %.*H\n", CALLDATA_SELECTOR_SIZE, msg->selector);
                     msg->result = ETH_PLUGIN_RESULT_ERROR;
                     break;
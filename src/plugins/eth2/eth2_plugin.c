@@ -8,9 +8,6 @@
 #include "eth2_plugin.h"
 #include "feature_get_eth2_public_key.h"
 
-static const uint8_t ETH2_DEPOSIT_SELECTOR[SELECTOR_SIZE] = {0x22, 0x89, 0x51, 0x18};
-const uint8_t *const ETH2_SELECTORS[NUM_ETH2_SELECTORS] = {ETH2_DEPOSIT_SELECTOR};
-
 #define WITHDRAWAL_KEY_PATH_1 12381
 #define WITHDRAWAL_KEY_PATH_2 3600
 #define WITHDRAWAL_KEY_PATH_4 0
@@ -19,13 +16,6 @@ const uint8_t *const ETH2_SELECTORS[NUM_ETH2_SELECTORS] = {ETH2_DEPOSIT_SELECTOR
 #define ETH2_WITHDRAWAL_CREDENTIALS_OFFSET 0xE0
 #define ETH2_SIGNATURE_OFFSET              0x120
 
-static const uint8_t deposit_contract_address[ADDRESS_LENGTH] = {
-    0x00, 0x00, 0x00, 0x00, 0x21, 0x9a, 0xb5, 0x40, 0x35, 0x6c,
-    0xbb, 0x83, 0x9c, 0xbe, 0x05, 0x30, 0x3d, 0x77, 0x05, 0xfa,
-};
-
-const uint8_t *const ETH2_ADDRESSES[NUM_ETH2_ADDRESSES] = {deposit_contract_address};
-
 // Highest index for withdrawal derivation path.
 #define INDEX_MAX 65536  // 2 ^ 16 : arbitrary value to protect from path attacks.
 
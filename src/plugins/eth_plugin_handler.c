@@ -5,29 +5,28 @@
 #include "shared_context.h"
 #include "network.h"
 #include "cmd_set_plugin.h"
-#include "erc20_plugin.h"
-#include "eth2_plugin.h"
 #include "erc721_plugin.h"
 #include "erc1155_plugin.h"
 #include "swap_with_calldata_plugin.h"
-#include "eip7002_plugin.h"
-#include "eip7251_plugin.h"
-
-// All internal alias names start with 'minus'
-
-static const internalEthPlugin_t INTERNAL_ETH_PLUGINS[] = {
-    {NULL, 0, ERC20_SELECTORS, NUM_ERC20_SELECTORS, "-erc20", erc20_plugin_call},
-#ifdef HAVE_ETH2
-    {ETH2_ADDRESSES,
-     NUM_ETH2_ADDRESSES,
-     ETH2_SELECTORS,
-     NUM_ETH2_SELECTORS,
-     "-eth2",
-     eth2_plugin_call},
-#endif
-    {EIP7002_ADDRESSES, NUM_EIP7002_ADDRESSES, NULL, 0, "-eip7002", eip7002_plugin_call},
-    {EIP7251_ADDRESSES, NUM_EIP7251_ADDRESSES, NULL, 0, "-eip7251", eip7251_plugin_call},
-};
+#include "internal_plugins.gen.h"
+#include "read.h"
+#include "syscall_stats.h"
+
+// Plugin implementation resolved at init, NULL for external plugins (called through the OS)
+static PluginCall g_plugin_impl = NULL;
+
+static PluginCall get_builtin_plugin_impl(pluginType_t type) {
+    switch (type) {
+        case PLUGIN_TYPE_SWAP_WITH_CALLDATA:
+            return swap_with_calldata_plugin_call;
+        case PLUGIN_TYPE_ERC721:
+            return erc721_plugin_call;
+        case PLUGIN_TYPE_ERC1155:
+            return erc1155_plugin_call;
+        default:
+            return NULL;
+    }
+}
 
 void eth_plugin_prepare_init(ethPluginInitContract_t *init,
                              const uint8_t *selector,
@@ -47,6 +46,16 @@ void eth_plugin_prepare_provide_parameter(ethPluginProvideParameter_t *provide_p
     provide_parameter->parameter_size = parameter_size;
 }
 
+void eth_plugin_prepare_provide_parameters(ethPluginProvideParameters_t *provide_parameters,
+                                           const uint8_t *parameters,
+                                           uint32_t parameters_offset,
+                                           uint32_t parameters_length) {
+    explicit_bzero((uint8_t *) provide_parameters, sizeof(ethPluginProvideParameters_t));
+    provide_parameters->parameters = parameters;
+    provide_parameters->parametersOffset = parameters_offset;
+    provide_parameters->parametersLength = parameters_length;
+}
+
 void eth_plugin_prepare_finalize(ethPluginFinalize_t *finalize) {
     explicit_bzero((uint8_t *) finalize, sizeof(ethPluginFinalize_t));
 }
@@ -125,54 +134,61 @@ static void eth_plugin_perform_init_default(uint8_t *contract_address,
     dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_OK;
 }
 
-static bool matching_selector(const internalEthPlugin_t *plugin, const uint8_t *selector) {
-    const uint8_t *const *selectors = PIC(plugin->selectors);
+static const internalEthPlugin_t *lookup_selector(const uint8_t *contract_address,
+                                                  const uint8_t *selector) {
+    uint32_t slot = INTERNAL_PLUGIN_HASH_SLOT(U4BE(selector, 0),
+                                              INTERNAL_PLUGIN_SELECTORS_MULT,
+                                              INTERNAL_PLUGIN_SELECTORS_BITS);
+    const internalPluginSelector_t *entry = &g_internal_plugin_selectors[slot];
 
-    if (selectors == NULL) {
-        return true;
+    if ((entry->plugin == NULL) || (memcmp(entry->selector, selector, SELECTOR_SIZE) != 0)) {
+        return NULL;
     }
-    for (int i = 0; i < plugin->num_selectors; ++i) {
-        if (memcmp(selector, PIC(selectors[i]), SELECTOR_SIZE) == 0) {
-            return true;
-        }
+    if (entry->has_address &&
+        (memcmp(entry->address, contract_address, ADDRESS_LENGTH) != 0)) {
+        return NULL;
     }
-    return false;
+    return PIC(entry->plugin);
 }
 
-static bool matching_address(const internalEthPlugin_t *plugin, const uint8_t *addr) {
-    const uint8_t *const *addresses = PIC(plugin->addresses);
+static const internalEthPlugin_t *lookup_address(const uint8_t *contract_address) {
+    // keyed on the last 4 bytes, the first ones of system contracts are mostly zeroes
+    uint32_t slot = INTERNAL_PLUGIN_HASH_SLOT(U4BE(contract_address, ADDRESS_LENGTH - 4),
+                                              INTERNAL_PLUGIN_ADDRESSES_MULT,
+                                              INTERNAL_PLUGIN_ADDRESSES_BITS);
+    const internalPluginAddress_t *entry = &g_internal_plugin_addresses[slot];
 
-    if (addresses == NULL) {
-        return true;
+    if ((entry->plugin == NULL) ||
+        (memcmp(entry->address, contract_address, ADDRESS_LENGTH) != 0)) {
+        return NULL;
     }
-    for (int i = 0; i < plugin->num_addresses; ++i) {
-        if (memcmp(addr, PIC(addresses[i]), ADDRESS_LENGTH) == 0) {
-            return true;
-        }
-    }
-    return false;
+    return PIC(entry->plugin);
 }
 
 static bool eth_plugin_perform_init_old_internal(uint8_t *contract_address,
                                                  ethPluginInitContract_t *init) {
-    // Search internal plugin list
-    for (int i = 0; i < (int) ARRAYLEN(INTERNAL_ETH_PLUGINS); ++i) {
-        if (matching_address(&INTERNAL_ETH_PLUGINS[i], contract_address) &&
-            matching_selector(&INTERNAL_ETH_PLUGINS[i], init->selector)) {
-            strlcpy(dataContext.tokenContext.pluginName,
-                    INTERNAL_ETH_PLUGINS[i].alias,
-                    PLUGIN_ID_LENGTH);
-            dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_OK;
-            return true;
-        }
-    }
+    const internalEthPlugin_t *by_selector = lookup_selector(contract_address, init->selector);
+    const internalEthPlugin_t *by_address = lookup_address(contract_address);
+    const internalEthPlugin_t *plugin;
 
-    return false;
+    if ((by_selector != NULL) && (by_address != NULL)) {
+        plugin = (by_selector->priority < by_address->priority) ? by_selector : by_address;
+    } else {
+        plugin = (by_selector != NULL) ? by_selector : by_address;
+    }
+    if (plugin == NULL) {
+        return false;
+    }
+    strlcpy(dataContext.tokenContext.pluginName, plugin->alias, PLUGIN_ID_LENGTH);
+    g_plugin_impl = (PluginCall) PIC(plugin->impl);
+    dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_OK;
+    return true;
 }
 
 eth_plugin_result_t eth_plugin_perform_init(uint8_t *contract_address,
                                             ethPluginInitContract_t *init) {
     dataContext.tokenContext.pluginStatus = ETH_PLUGIN_RESULT_UNAVAILABLE;
+    g_plugin_impl = get_builtin_plugin_impl(pluginType);
 
     PRINTF("Selector %.*H\n", 4, init->selector);
     switch (pluginType) {
@@ -228,7 +244,6 @@ eth_plugin_result_t eth_plugin_perform_init(uint8_t *contract_address,
 
 eth_plugin_result_t eth_plugin_call(int method, void *parameter) {
     char *alias;
-    uint8_t i;
 
     if (dataContext.tokenContext.pluginStatus <= ETH_PLUGIN_RESULT_UNSUCCESSFUL) {
         PRINTF("Cached plugin call but no plugin available\n");
@@ -258,6 +273,13 @@ eth_plugin_result_t eth_plugin_call(int method, void *parameter) {
             ((ethPluginProvideParameter_t *) parameter)->pluginContext =
                 (uint8_t *) &dataContext.tokenContext.pluginContext;
             break;
+        case ETH_PLUGIN_PROVIDE_PARAMETERS:
+            PRINTF("-- PLUGIN PROVIDE PARAMETERS --\n");
+            ((ethPluginProvideParameters_t *) parameter)->result = ETH_PLUGIN_RESULT_UNAVAILABLE;
+            ((ethPluginProvideParameters_t *) parameter)->txContent = &tmpContent.txContent;
+            ((ethPluginProvideParameters_t *) parameter)->pluginContext =
+                (uint8_t *) &dataContext.tokenContext.pluginContext;
+            break;
         case ETH_PLUGIN_FINALIZE:
             PRINTF("-- PLUGIN FINALIZE --\n");
             ((ethPluginFinalize_t *) parameter)->result = ETH_PLUGIN_RESULT_UNAVAILABLE;
@@ -310,29 +332,16 @@ eth_plugin_result_t eth_plugin_call(int method, void *parameter) {
             END_TRY;
             break;
         }
-        case PLUGIN_TYPE_SWAP_WITH_CALLDATA: {
-            swap_with_calldata_plugin_call(method, parameter);
-            break;
-        }
-        case PLUGIN_TYPE_ERC721: {
-            erc721_plugin_call(method, parameter);
-            break;
-        }
-        case PLUGIN_TYPE_ERC1155: {
-            erc1155_plugin_call(method, parameter);
-            break;
-        }
+        case PLUGIN_TYPE_SWAP_WITH_CALLDATA:
+        case PLUGIN_TYPE_ERC721:
+        case PLUGIN_TYPE_ERC1155:
         case PLUGIN_TYPE_OLD_INTERNAL: {
-            // Perform the call
-            for (i = 0;; i++) {
-                if (INTERNAL_ETH_PLUGINS[i].alias[0] == 0) {
-                    break;
-                }
-                if (strcmp(alias, INTERNAL_ETH_PLUGINS[i].alias) == 0) {
-                    ((PluginCall) PIC(INTERNAL_ETH_PLUGINS[i].impl))(method, parameter);
-                    break;
-                }
+            // Direct call to the implementation resolved at init
+            if (g_plugin_impl == NULL) {
+                PRINTF("Error: no plugin implementation resolved for %s\n", alias);
+                return ETH_PLUGIN_RESULT_ERROR;
             }
+            g_plugin_impl(method, parameter);
             break;
         }
         default: {
@@ -365,6 +374,17 @@ eth_plugin_result_t eth_plugin_call(int method, void *parameter) {
                     return ETH_PLUGIN_RESULT_UNAVAILABLE;
             }
             break;
+        case ETH_PLUGIN_PROVIDE_PARAMETERS:
+            switch (((ethPluginProvideParameters_t *) parameter)->result) {
+                case ETH_PLUGIN_RESULT_OK:
+                    break;
+                case ETH_PLUGIN_RESULT_ERROR:
+                    return ETH_PLUGIN_RESULT_ERROR;
+                default:
+                    // including FALLBACK, the parameters are then provided one by one
+                    return ETH_PLUGIN_RESULT_UNAVAILABLE;
+            }
+            break;
         case ETH_PLUGIN_FINALIZE:
             switch (((ethPluginFinalize_t *) parameter)->result) {
                 case ETH_PLUGIN_RESULT_OK:
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "eth_plugin_interface.h"
+#include "eth_plugin_provide_parameters.h"
 
 #define NO_EXTRA_INFO(ctx, idx) \
     (allzeroes(&(ctx.transactionContext.extraInfo[idx]), sizeof(extraInfo_t)))
@@ -14,6 +15,10 @@ void eth_plugin_prepare_provide_parameter(ethPluginProvideParameter_t *provide_p
                                           uint8_t *parameter,
                                           uint32_t parameter_offset,
                                           uint8_t parameter_size);
+void eth_plugin_prepare_provide_parameters(ethPluginProvideParameters_t *provide_parameters,
+                                           const uint8_t *parameters,
+                                           uint32_t parameters_offset,
+                                           uint32_t parameters_length);
 void eth_plugin_prepare_finalize(ethPluginFinalize_t *finalize);
 void eth_plugin_prepare_provide_info(ethPluginProvideInfo_t *provide_token);
 void eth_plugin_prepare_query_contract_id(ethQueryContractID_t *query_contract_id,
@@ -8,10 +8,24 @@
 typedef void (*PluginCall)(eth_plugin_msg_t, void*);
 
 typedef struct internalEthPlugin_t {
-    const uint8_t* const* addresses;
-    uint8_t num_addresses;
-    const uint8_t* const* selectors;
-    uint8_t num_selectors;
-    char alias[10];
+    uint8_t priority;  // the lowest one wins when several plugins match
+    char alias[10];  // always starts with a minus
     PluginCall impl;
 } internalEthPlugin_t;
+
+// Perfect hash tables generated by tools/gen_internal_plugins.py from internal_plugins.json
+
+typedef struct internalPluginSelector_t {
+    uint8_t selector[SELECTOR_SIZE];
+    bool has_address;  // only for this contract address
+    uint8_t address[ADDRESS_LENGTH];
+    const internalEthPlugin_t* plugin;  // NULL for an empty slot
+} internalPluginSelector_t;
+
+typedef struct internalPluginAddress_t {
+    uint8_t address[ADDRESS_LENGTH];
+    const internalEthPlugin_t* plugin;  // NULL for an empty slot
+} internalPluginAddress_t;
+
+#define INTERNAL_PLUGIN_HASH_SLOT(key, mult, bits) \
+    ((uint32_t) ((uint32_t) (key) * (uint32_t) (mult)) >> (32 - (bits)))
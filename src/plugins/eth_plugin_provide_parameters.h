@@ -0,0 +1,39 @@
+#pragma once
+
+/**
+ * Plugin interface extension: batched calldata parameters
+ *
+ * Written as an addition to the plugin SDK interface (eth_plugin_interface.h), so that plugins can
+ * include it as-is. Once the SDK provides these definitions, they take precedence.
+ */
+
+#include <stdint.h>
+#include "eth_plugin_interface.h"
+
+#ifndef ETH_PLUGIN_PROVIDE_PARAMETERS
+
+// Batched variant of ETH_PLUGIN_PROVIDE_PARAMETER, only sent to the plugins opting in
+#define ETH_PLUGIN_PROVIDE_PARAMETERS 0x0110
+
+typedef struct ethPluginProvideParameters_s {
+    // in
+    txContent_t *txContent;
+    uint8_t *pluginContext;
+    const uint8_t *parameters;  // consecutive 32-byte parameters
+    uint32_t parametersOffset;  // offset of the first parameter in the data field
+    uint32_t parametersLength;  // multiple of 32
+
+    // out
+    uint8_t result;
+} ethPluginProvideParameters_t;
+
+#endif  // ETH_PLUGIN_PROVIDE_PARAMETERS
+
+#ifndef ETH_PLUGIN_PROVIDE_PARAMETERS_OPT_IN
+
+// Written by a plugin in the interfaceVersion of ETH_PLUGIN_INIT_CONTRACT, once it has checked it,
+// to receive the parameters through ETH_PLUGIN_PROVIDE_PARAMETERS. The other plugins leave the
+// field untouched and get them one by one through ETH_PLUGIN_PROVIDE_PARAMETER.
+#define ETH_PLUGIN_PROVIDE_PARAMETERS_OPT_IN 0xB0
+
+#endif  // ETH_PLUGIN_PROVIDE_PARAMETERS_OPT_IN
@@ -96,3 +96,5 @@ bool check_signature_with_pubkey(uint8_t *buffer,
                                  const uint8_t keyUsageExp,
                                  const uint8_t *signature,
                                  const uint8_t sigLen);
+bool get_pki_cert_fingerprint(uint8_t *key_usage, uint8_t *fingerprint);
+void sig_cache_clear(void);
@@ -27,7 +27,11 @@
 
 #define N_storage (*(volatile internalStorage_t *) PIC(&N_storage_real))
 
-#define MAX_ASSETS 5
+// Number of token/NFT infos kept during a transaction, set with ASSETS_CACHE_SIZE
+#ifndef MAX_ASSETS
+#define MAX_ASSETS 8
+#endif
+_Static_assert(MAX_ASSETS < UINT8_MAX, "Asset indices are sent on a single byte");
 
 typedef struct internalStorage_t {
     bool dataAllowed;
@@ -69,6 +73,8 @@ typedef struct tokenContext_t {
     };
 
     uint8_t pluginStatus;
+    // whether the plugin may receive the parameters through ETH_PLUGIN_PROVIDE_PARAMETERS
+    bool pluginBatching;
 
 } tokenContext_t;
 
@@ -86,6 +92,13 @@ typedef struct transactionContext_t {
     uint8_t hash[INT256_LENGTH];
     union extraInfo_t extraInfo[MAX_ASSETS];
     bool assetSet[MAX_ASSETS];
+    // folded asset addresses, to skip most of the full comparisons on lookups
+    uint8_t assetTag[MAX_ASSETS];
+    // for the least recently used eviction
+    uint16_t assetLastUse[MAX_ASSETS];
+    uint16_t assetUseCount;
+    // whether the asset being provided replaces a valid one
+    bool assetEvicted;
     uint8_t currentAssetIndex;
 } transactionContext_t;
 
@@ -0,0 +1,150 @@
+#ifdef HAVE_SYSCALL_STATS
+
+#include <string.h>
+#include "syscall_stats.h"
+
+#define SYSCALL_STATS_NAME_ENTRY(id, name) name,
+
+static const char *const g_syscall_names[SYSCALL_STATS_COUNT] = {
+    SYSCALL_STATS_LIST(SYSCALL_STATS_NAME_ENTRY)};
+
+// Stats of the ongoing flow
+static s_syscall_stats g_syscall_stats;
+// Stats of the last finished flow
+static s_syscall_stats g_syscall_stats_last;
+
+const char *syscall_stats_name(e_syscall_id id) {
+    return (id < SYSCALL_STATS_COUNT) ? PIC(g_syscall_names[id]) : NULL;
+}
+
+static s_syscall_site *get_site(e_syscall_id id, const char *file, uint16_t line) {
+    s_syscall_site *site;
+
+    for (uint8_t i = 0; i < g_syscall_stats.sites_count; ++i) {
+        site = &g_syscall_stats.sites[i];
+        if ((site->line == line) && (site->id == id) && (site->file == file)) {
+            return site;
+        }
+    }
+    if (g_syscall_stats.sites_count == SYSCALL_STATS_MAX_SITES) {
+        g_syscall_stats.sites_overflow = true;
+        return NULL;
+    }
+    site = &g_syscall_stats.sites[g_syscall_stats.sites_count++];
+    site->file = file;
+    site->line = line;
+    site->id = id;
+    return site;
+}
+
+void syscall_stats_count(e_syscall_id id, const char *file, uint16_t line, size_t bytes) {
+    s_syscall_site *site;
+
+    g_syscall_stats.calls[id] += 1;
+    g_syscall_stats.bytes[id] += bytes;
+    if ((site = get_site(id, file, line)) != NULL) {
+        site->calls += 1;
+        site->bytes += bytes;
+    }
+}
+
+/**
+ * Dump the stats of the flow which just finished, and start counting for the next one
+ *
+ * Nothing happens if no syscall was made since the previous flow.
+ */
+void syscall_stats_end_flow(void) {
+    const s_syscall_site *site;
+    bool empty = true;
+
+    for (uint8_t i = 0; i < SYSCALL_STATS_COUNT; ++i) {
+        if (g_syscall_stats.calls[i] > 0) {
+            PRINTF("[SYSCALLS] %s: %u calls, %u bytes\n",
+                   syscall_stats_name(i),
+                   g_syscall_stats.calls[i],
+                   g_syscall_stats.bytes[i]);
+            empty = false;
+        }
+    }
+    if (empty) {
+        return;
+    }
+    for (uint8_t i = 0; i < g_syscall_stats.sites_count; ++i) {
+        site = &g_syscall_stats.sites[i];
+        PRINTF("[SYSCALLS]   %s:%u %s: %u calls, %u bytes\n",
+               site->file,
+               site->line,
+               syscall_stats_name(site->id),
+               site->calls,
+               site->bytes);
+    }
+    if (g_syscall_stats.sites_overflow) {
+        PRINTF("[SYSCALLS]   (more call sites than tracked)\n");
+    }
+    memcpy(&g_syscall_stats_last, &g_syscall_stats, sizeof(g_syscall_stats_last));
+    explicit_bzero(&g_syscall_stats, sizeof(g_syscall_stats));
+}
+
+const s_syscall_stats *syscall_stats_get_last(void) {
+    return &g_syscall_stats_last;
+}
+
+cx_err_t syscall_stats_cx_hash(const char *file,
+                               uint16_t line,
+                               cx_hash_t *hash,
+                               uint32_t mode,
+                               const uint8_t *in,
+                               size_t len,
+                               uint8_t *out,
+                               size_t out_len) {
+    syscall_stats_count(SYSCALL_CX_HASH, file, line, len);
+    return (cx_hash_no_throw)(hash, mode, in, len, out, out_len);
+}
+
+cx_err_t syscall_stats_cx_keccak_init(const char *file,
+                                      uint16_t line,
+                                      cx_sha3_t *hash,
+                                      size_t size) {
+    syscall_stats_count(SYSCALL_CX_KECCAK_INIT, file, line, 0);
+    return (cx_keccak_init_no_throw)(hash, size);
+}
+
+bool syscall_stats_cx_ecdsa_verify(const char *file,
+                                   uint16_t line,
+                                   const cx_ecfp_public_key_t *pukey,
+                                   const uint8_t *hash,
+                                   size_t hash_len,
+                                   const uint8_t *sig,
+                                   size_t sig_len) {
+    syscall_stats_count(SYSCALL_CX_ECDSA_VERIFY, file, line, hash_len);
+    return (cx_ecdsa_verify_no_throw)(pukey, hash, hash_len, sig, sig_len);
+}
+
+cx_err_t syscall_stats_bip32_derive(const char *file,
+                                    uint16_t line,
+                                    cx_curve_t curve,
+                                    const uint32_t *path,
+                                    size_t path_len,
+                                    uint8_t raw_pubkey[static 65],
+                                    uint8_t *chain_code,
+                                    cx_md_t hash_id) {
+    syscall_stats_count(SYSCALL_BIP32_DERIVE, file, line, 0);
+    return (bip32_derive_get_pubkey_256)(curve, path, path_len, raw_pubkey, chain_code, hash_id);
+}
+
+cx_err_t syscall_stats_cx_math_mult(const char *file,
+                                    uint16_t line,
+                                    uint8_t *r,
+                                    const uint8_t *a,
+                                    const uint8_t *b,
+                                    size_t len) {
+    syscall_stats_count(SYSCALL_CX_MATH_MULT, file, line, 0);
+    return (cx_math_mult_no_throw)(r, a, b, len);
+}
+
+void syscall_stats_os_lib_call(const char *file, uint16_t line, unsigned int *call_parameters) {
+    syscall_stats_count(SYSCALL_OS_LIB_CALL, file, line, 0);
+    (os_lib_call)(call_parameters);
+}
+
+#endif  // HAVE_SYSCALL_STATS
@@ -0,0 +1,103 @@
+#pragma once
+
+#ifdef HAVE_SYSCALL_STATS
+
+/**
+ * Opt-in counting of the costly syscalls, per call site
+ *
+ * To be included by every file calling one of them, the macros below then replace these calls.
+ * The SDK headers declaring them are included first, so that their declarations are not affected.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "os.h"
+#include "cx.h"
+#include "crypto_helpers.h"
+
+// Distinct call sites tracked during a flow, the others are only counted in the totals
+#define SYSCALL_STATS_MAX_SITES 32
+
+#define SYSCALL_STATS_LIST(X)              \
+    X(CX_HASH, "cx_hash")                  \
+    X(CX_KECCAK_INIT, "cx_keccak_init")    \
+    X(CX_ECDSA_VERIFY, "cx_ecdsa_verify")  \
+    X(BIP32_DERIVE, "bip32_derive_pubkey") \
+    X(CX_MATH_MULT, "cx_math_mult")        \
+    X(OS_LIB_CALL, "os_lib_call")
+
+#define SYSCALL_STATS_ENUM_ENTRY(id, name) SYSCALL_##id,
+
+typedef enum { SYSCALL_STATS_LIST(SYSCALL_STATS_ENUM_ENTRY) SYSCALL_STATS_COUNT } e_syscall_id;
+
+typedef struct {
+    const char *file;
+    uint16_t line;
+    uint8_t id;  // e_syscall_id
+    uint32_t calls;
+    uint32_t bytes;  // hashed bytes, 0 for the other syscalls
+} s_syscall_site;
+
+typedef struct {
+    uint32_t calls[SYSCALL_STATS_COUNT];
+    uint32_t bytes[SYSCALL_STATS_COUNT];
+    s_syscall_site sites[SYSCALL_STATS_MAX_SITES];
+    uint8_t sites_count;
+    bool sites_overflow;  // some call sites could not be tracked
+} s_syscall_stats;
+
+#ifdef __FILE_NAME__
+#define SYSCALL_SITE __FILE_NAME__, __LINE__
+#else
+#define SYSCALL_SITE __FILE__, __LINE__
+#endif
+
+const char *syscall_stats_name(e_syscall_id id);
+void syscall_stats_count(e_syscall_id id, const char *file, uint16_t line, size_t bytes);
+void syscall_stats_end_flow(void);
+const s_syscall_stats *syscall_stats_get_last(void);
+
+cx_err_t syscall_stats_cx_hash(const char *file,
+                               uint16_t line,
+                               cx_hash_t *hash,
+                               uint32_t mode,
+                               const uint8_t *in,
+                               size_t len,
+                               uint8_t *out,
+                               size_t out_len);
+cx_err_t syscall_stats_cx_keccak_init(const char *file,
+                                      uint16_t line,
+                                      cx_sha3_t *hash,
+                                      size_t size);
+bool syscall_stats_cx_ecdsa_verify(const char *file,
+                                   uint16_t line,
+                                   const cx_ecfp_public_key_t *pukey,
+                                   const uint8_t *hash,
+                                   size_t hash_len,
+                                   const uint8_t *sig,
+                                   size_t sig_len);
+cx_err_t syscall_stats_bip32_derive(const char *file,
+                                    uint16_t line,
+                                    cx_curve_t curve,
+                                    const uint32_t *path,
+                                    size_t path_len,
+                                    uint8_t raw_pubkey[static 65],
+                                    uint8_t *chain_code,
+                                    cx_md_t hash_id);
+cx_err_t syscall_stats_cx_math_mult(const char *file,
+                                    uint16_t line,
+                                    uint8_t *r,
+                                    const uint8_t *a,
+                                    const uint8_t *b,
+                                    size_t len);
+void syscall_stats_os_lib_call(const char *file, uint16_t line, unsigned int *call_parameters);
+
+// The real functions stay reachable with their name between parentheses
+#define cx_hash_no_throw(...)            syscall_stats_cx_hash(SYSCALL_SITE, __VA_ARGS__)
+#define cx_keccak_init_no_throw(...)     syscall_stats_cx_keccak_init(SYSCALL_SITE, __VA_ARGS__)
+#define cx_ecdsa_verify_no_throw(...)    syscall_stats_cx_ecdsa_verify(SYSCALL_SITE, __VA_ARGS__)
+#define bip32_derive_get_pubkey_256(...) syscall_stats_bip32_derive(SYSCALL_SITE, __VA_ARGS__)
+#define cx_math_mult_no_throw(...)       syscall_stats_cx_math_mult(SYSCALL_SITE, __VA_ARGS__)
+#define os_lib_call(...)                 syscall_stats_os_lib_call(SYSCALL_SITE, __VA_ARGS__)
+
+#endif  // HAVE_SYSCALL_STATS
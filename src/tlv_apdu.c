@@ -11,11 +11,56 @@ static struct {
     f_tlv_payload_handler handler_ptr;
 } g_tlv;
 
+// DER-encoded tag (up to 4 bytes) + DER-encoded length (up to 2 bytes)
+#define TLV_STREAM_MAX_HEADER_SIZE (1 + 4 + 1 + 2)
+
+static struct {
+    uint16_t size;
+    uint16_t pos;
+    // TLV header split across two chunks
+    uint8_t header[TLV_STREAM_MAX_HEADER_SIZE];
+    uint8_t header_len;
+    // TLV element split across two or more chunks
+    uint8_t *element;
+    uint16_t element_size;
+    uint16_t element_pos;
+    f_tlv_element_handler handler_ptr;
+    void *context;
+} g_tlv_stream;
+
+typedef enum {
+    TLV_HEADER_ERROR = 0,
+    TLV_HEADER_INCOMPLETE,
+    TLV_HEADER_COMPLETE,
+} e_tlv_header_ret;
+
 static void reset_state(void) {
     APP_MEM_FREE(g_tlv.payload);
     explicit_bzero(&g_tlv, sizeof(g_tlv));
 }
 
+static void reset_stream_state(void) {
+    APP_MEM_FREE(g_tlv_stream.element);
+    explicit_bzero(&g_tlv_stream, sizeof(g_tlv_stream));
+}
+
+/**
+ * Receive a TLV payload spread over multiple APDUs, staged as a whole
+ *
+ * Meant for the descriptors parsed by a DEFINE_TLV_PARSER parser (the signed descriptors, a single
+ * GCS FIELD, etc.), the handler gets the complete payload at once. Such a parser checks the tag
+ * uniqueness and records the received tags over the buffer it is given, so giving it the elements
+ * one at a time would drop these checks, even though the struct hash itself is incremental. A
+ * payload fitting in a single APDU is never staged, it is parsed in place.
+ * A payload made of independent top-level elements (e.g. a GCS fields batch) goes through
+ * \ref tlv_stream_from_apdu instead, which never stages it.
+ *
+ * @param[in] first_chunk whether this is the first chunk of the payload
+ * @param[in] lc APDU payload length
+ * @param[in] payload APDU payload
+ * @param[in] handler called with the complete payload
+ * @return whether the payload is complete, pending or if an error occurred
+ */
 e_tlv_apdu_ret tlv_from_apdu(bool first_chunk,
                              uint8_t lc,
                              const uint8_t *payload,
@@ -92,3 +137,343 @@ e_tlv_apdu_ret tlv_from_apdu(bool first_chunk,
     }
     return TLV_APDU_PENDING;
 }
+
+/**
+ * Read a DER-encoded unsigned integer
+ *
+ * @param[in] buf input buffer
+ * @param[in] size size of the input buffer
+ * @param[in,out] offset current offset within the buffer, moved past the integer
+ * @param[in] max_bytes maximum number of bytes for the long form
+ * @param[out] out decoded value
+ * @return whether it was decoded, or if more bytes are needed
+ */
+static e_tlv_header_ret read_der_uint(const uint8_t *buf,
+                                      uint16_t size,
+                                      uint16_t *offset,
+                                      uint8_t max_bytes,
+                                      uint32_t *out) {
+    uint8_t nb_bytes;
+
+    if (*offset >= size) {
+        return TLV_HEADER_INCOMPLETE;
+    }
+    if (buf[*offset] < 0x80) {
+        *out = buf[*offset];
+        *offset += 1;
+        return TLV_HEADER_COMPLETE;
+    }
+    nb_bytes = buf[*offset] & 0x7f;
+    if ((nb_bytes == 0) || (nb_bytes > max_bytes)) {
+        return TLV_HEADER_ERROR;
+    }
+    if ((*offset + 1 + nb_bytes) > size) {
+        return TLV_HEADER_INCOMPLETE;
+    }
+    *offset += 1;
+    *out = 0;
+    for (uint8_t i = 0; i < nb_bytes; ++i) {
+        *out = (*out << 8) | buf[*offset];
+        *offset += 1;
+    }
+    return TLV_HEADER_COMPLETE;
+}
+
+/**
+ * Read the header (tag & length) of a TLV element
+ *
+ * @param[in] buf input buffer
+ * @param[in] size size of the input buffer
+ * @param[out] header_size size of the header
+ * @param[out] tag tag of the element
+ * @param[out] value_size size of the value of the element
+ * @return whether it was decoded, or if more bytes are needed
+ */
+static e_tlv_header_ret read_tlv_header(const uint8_t *buf,
+                                        uint16_t size,
+                                        uint16_t *header_size,
+                                        uint32_t *tag,
+                                        uint16_t *value_size) {
+    uint16_t offset = 0;
+    uint32_t length;
+    e_tlv_header_ret ret;
+
+    if ((ret = read_der_uint(buf, size, &offset, 4, tag)) != TLV_HEADER_COMPLETE) {
+        return ret;
+    }
+    if ((ret = read_der_uint(buf, size, &offset, 2, &length)) != TLV_HEADER_COMPLETE) {
+        return ret;
+    }
+    *header_size = offset;
+    *value_size = length;
+    return TLV_HEADER_COMPLETE;
+}
+
+static bool deliver_element(const uint8_t *element,
+                            uint16_t header_size,
+                            uint32_t tag,
+                            uint16_t value_size) {
+    tlv_data_t data = {
+        .tag = tag,
+        .value = {.ptr = (uint8_t *) &element[header_size], .size = value_size, .offset = 0},
+        .raw = {.ptr = (uint8_t *) element, .size = header_size + value_size, .offset = 0},
+    };
+
+    return (*g_tlv_stream.handler_ptr)(&data, g_tlv_stream.context);
+}
+
+/**
+ * Start the reassembly of a TLV element that does not fit in the current chunk
+ *
+ * @param[in] header header of the element
+ * @param[in] header_size size of the header
+ * @param[in] value_size size of the value of the element
+ * @param[in] remaining size of the payload left, starting from this element
+ * @return whether it was successful or not
+ */
+static bool stage_element(const uint8_t *header,
+                          uint16_t header_size,
+                          uint16_t value_size,
+                          uint16_t remaining) {
+    uint32_t element_size = (uint32_t) header_size + value_size;
+
+    if (element_size > remaining) {
+        PRINTF("Error: TLV element bigger than the remaining payload!\n");
+        return false;
+    }
+    if ((g_tlv_stream.element = APP_MEM_ALLOC(element_size)) == NULL) {
+        return false;
+    }
+    memcpy(g_tlv_stream.element, header, header_size);
+    g_tlv_stream.element_size = element_size;
+    g_tlv_stream.element_pos = header_size;
+    return true;
+}
+
+/**
+ * Feed the given chunk into the element currently being reassembled
+ *
+ * @param[in] chunk chunk data
+ * @param[in] chunk_length size of the chunk
+ * @return how many bytes were consumed, or a negative value on error
+ */
+static int feed_staged_element(const uint8_t *chunk, uint16_t chunk_length) {
+    uint16_t header_size;
+    uint16_t value_size;
+    uint32_t tag;
+    uint16_t length = g_tlv_stream.element_size - g_tlv_stream.element_pos;
+    bool ret;
+
+    if (length > chunk_length) {
+        length = chunk_length;
+    }
+    memcpy(&g_tlv_stream.element[g_tlv_stream.element_pos], chunk, length);
+    g_tlv_stream.element_pos += length;
+    if (g_tlv_stream.element_pos == g_tlv_stream.element_size) {
+        if (read_tlv_header(g_tlv_stream.element,
+                            g_tlv_stream.element_size,
+                            &header_size,
+                            &tag,
+                            &value_size) != TLV_HEADER_COMPLETE) {
+            return -1;
+        }
+        ret = deliver_element(g_tlv_stream.element, header_size, tag, value_size);
+        APP_MEM_FREE(g_tlv_stream.element);
+        g_tlv_stream.element = NULL;
+        g_tlv_stream.element_size = 0;
+        g_tlv_stream.element_pos = 0;
+        if (!ret) {
+            return -1;
+        }
+    }
+    return length;
+}
+
+/**
+ * Feed the given chunk into the header currently being reassembled
+ *
+ * Bytes are consumed one at a time, until the header is complete.
+ *
+ * @param[in] chunk chunk data
+ * @param[in] chunk_length size of the chunk
+ * @return how many bytes were consumed, or a negative value on error
+ */
+static int feed_staged_header(const uint8_t *chunk, uint16_t chunk_length) {
+    uint16_t header_size;
+    uint16_t value_size;
+    uint32_t tag;
+    uint16_t consumed = 0;
+
+    while (consumed < chunk_length) {
+        if (g_tlv_stream.header_len == sizeof(g_tlv_stream.header)) {
+            return -1;
+        }
+        g_tlv_stream.header[g_tlv_stream.header_len++] = chunk[consumed++];
+        switch (read_tlv_header(g_tlv_stream.header,
+                                g_tlv_stream.header_len,
+                                &header_size,
+                                &tag,
+                                &value_size)) {
+            case TLV_HEADER_INCOMPLETE:
+                break;
+            case TLV_HEADER_COMPLETE:
+                g_tlv_stream.header_len = 0;
+                if (value_size == 0) {
+                    if (!deliver_element(g_tlv_stream.header, header_size, tag, value_size)) {
+                        return -1;
+                    }
+                } else if (!stage_element(g_tlv_stream.header,
+                                          header_size,
+                                          value_size,
+                                          g_tlv_stream.size - g_tlv_stream.pos +
+                                              (header_size - consumed))) {
+                    return -1;
+                }
+                return consumed;
+            default:
+                return -1;
+        }
+    }
+    return consumed;
+}
+
+/**
+ * Parse the given chunk, element by element
+ *
+ * Complete elements are directly handled from the APDU buffer, only the one straddling two
+ * chunks gets copied.
+ *
+ * @param[in] chunk chunk data
+ * @param[in] chunk_length size of the chunk
+ * @return whether it was successful or not
+ */
+static bool parse_stream_chunk(const uint8_t *chunk, uint16_t chunk_length) {
+    uint16_t offset = 0;
+    uint16_t header_size;
+    uint16_t value_size;
+    uint32_t tag;
+    int consumed;
+
+    while (offset < chunk_length) {
+        if (g_tlv_stream.element != NULL) {
+            consumed = feed_staged_element(&chunk[offset], chunk_length - offset);
+        } else if (g_tlv_stream.header_len > 0) {
+            consumed = feed_staged_header(&chunk[offset], chunk_length - offset);
+        } else {
+            switch (read_tlv_header(&chunk[offset],
+                                    chunk_length - offset,
+                                    &header_size,
+                                    &tag,
+                                    &value_size)) {
+                case TLV_HEADER_INCOMPLETE:
+                    consumed = chunk_length - offset;
+                    memcpy(g_tlv_stream.header, &chunk[offset], consumed);
+                    g_tlv_stream.header_len = consumed;
+                    break;
+                case TLV_HEADER_COMPLETE:
+                    if ((header_size + value_size) <= (chunk_length - offset)) {
+                        if (!deliver_element(&chunk[offset], header_size, tag, value_size)) {
+                            return false;
+                        }
+                        consumed = header_size + value_size;
+                    } else {
+                        if (!stage_element(&chunk[offset],
+                                           header_size,
+                                           value_size,
+                                           g_tlv_stream.size - g_tlv_stream.pos)) {
+                            return false;
+                        }
+                        consumed = header_size;
+                    }
+                    break;
+                default:
+                    consumed = -1;
+            }
+        }
+        if (consumed < 0) {
+            return false;
+        }
+        offset += consumed;
+        g_tlv_stream.pos += consumed;
+    }
+    return true;
+}
+
+/**
+ * Receive a TLV payload spread over multiple APDUs, without ever staging it as a whole
+ *
+ * Each top-level TLV element is given to the handler as soon as it is complete, so it only fits
+ * payloads whose elements can be handled independently, a struct which is hashed or verified as a
+ * whole still goes through \ref tlv_from_apdu.
+ *
+ * @param[in] first_chunk whether this is the first chunk of the payload
+ * @param[in] lc APDU payload length
+ * @param[in] payload APDU payload
+ * @param[in] handler called for each top-level TLV element
+ * @param[in] context given as-is to the handler
+ * @return whether the payload is complete, pending or if an error occurred
+ */
+e_tlv_apdu_ret tlv_stream_from_apdu(bool first_chunk,
+                                    uint8_t lc,
+                                    const uint8_t *payload,
+                                    f_tlv_element_handler handler,
+                                    void *context) {
+    uint8_t offset = 0;
+    uint8_t chunk_length;
+
+    if ((payload == NULL) || (handler == NULL)) {
+        reset_stream_state();
+        return TLV_APDU_ERROR;
+    }
+
+    if (first_chunk) {
+        if (g_tlv_stream.handler_ptr != NULL) {
+            PRINTF("Error: remnants from an incomplete TLV payload!\n");
+            reset_stream_state();
+            return TLV_APDU_ERROR;
+        }
+        if ((offset + sizeof(g_tlv_stream.size)) > lc) {
+            return TLV_APDU_ERROR;
+        }
+        g_tlv_stream.size = read_u16_be(payload, offset);
+        offset += sizeof(g_tlv_stream.size);
+        g_tlv_stream.pos = 0;
+        g_tlv_stream.handler_ptr = handler;
+        g_tlv_stream.context = context;
+    } else {
+        if ((handler != g_tlv_stream.handler_ptr) || (context != g_tlv_stream.context)) {
+            PRINTF("Error: given handler does not match cached one!\n");
+            reset_stream_state();
+            return TLV_APDU_ERROR;
+        }
+    }
+
+    if (g_tlv_stream.size == 0) {
+        PRINTF("Error: zero-length TLV payload is invalid!\n");
+        reset_stream_state();
+        return TLV_APDU_ERROR;
+    }
+
+    chunk_length = lc - offset;
+    if ((g_tlv_stream.pos + chunk_length) > g_tlv_stream.size) {
+        PRINTF("Error: TLV payload bigger than expected!\n");
+        reset_stream_state();
+        return TLV_APDU_ERROR;
+    }
+
+    if (!parse_stream_chunk(&payload[offset], chunk_length)) {
+        reset_stream_state();
+        return TLV_APDU_ERROR;
+    }
+
+    if (g_tlv_stream.pos == g_tlv_stream.size) {
+        if ((g_tlv_stream.element != NULL) || (g_tlv_stream.header_len > 0)) {
+            PRINTF("Error: truncated TLV element!\n");
+            reset_stream_state();
+            return TLV_APDU_ERROR;
+        }
+        reset_stream_state();
+        return TLV_APDU_SUCCESS;
+    }
+    return TLV_APDU_PENDING;
+}
@@ -3,8 +3,10 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include "buffer.h"
+#include "tlv_library.h"
 
 typedef bool (*f_tlv_payload_handler)(const buffer_t *payload);
+typedef bool (*f_tlv_element_handler)(const tlv_data_t *data, void *context);
 
 typedef enum {
     TLV_APDU_ERROR = 0,
@@ -16,3 +18,8 @@ e_tlv_apdu_ret tlv_from_apdu(bool first_chunk,
                              uint8_t lc,
                              const uint8_t *payload,
                              f_tlv_payload_handler handler);
+e_tlv_apdu_ret tlv_stream_from_apdu(bool first_chunk,
+                                    uint8_t lc,
+                                    const uint8_t *payload,
+                                    f_tlv_element_handler handler,
+                                    void *context);
@@ -25,6 +25,7 @@
 #include "uint_common.h"
 #include "common_utils.h"  // INT256_LENGTH
 #include "utils.h"
+#include "syscall_stats.h"
 
 void readu256BE(const uint8_t *const buffer, uint256_t *const target) {
     readu128BE(buffer, &UPPER_P(target));
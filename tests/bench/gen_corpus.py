@@ -0,0 +1,281 @@
+#!/usr/bin/env python3
+"""
+Generate the benchmark corpus, by recording the APDUs the Python client sends
+
+The payloads mirror common mainnet traffic (native & token transfers, a DEX swap clear-signed
+through the generic parser, popular EIP-712 messages, ...).
+"""
+
+import os
+import sys
+import json
+import argparse
+import hashlib
+from contextlib import contextmanager
+from pathlib import Path
+from typing import Generator
+
+from web3 import Web3
+from ledgered.devices import Devices, DeviceType
+from ragger.utils import RAPDU
+
+from ledger_app_clients.ethereum.apdu_trace import ApduTrace
+from ledger_app_clients.ethereum.client import EthAppClient, SignMode
+from ledger_app_clients.ethereum.eip712 import InputData
+from ledger_app_clients.ethereum.utils import CoinType, TxType, get_selector_from_data
+from ledger_app_clients.ethereum.trusted_name import TrustedName, TrustedNameType, TrustedNameSource
+from ledger_app_clients.ethereum.dynamic_networks import DynamicNetwork
+from ledger_app_clients.ethereum.proxy_info import ProxyInfo
+from ledger_app_clients.ethereum.enum_value import EnumValue
+from ledger_app_clients.ethereum.gating import Gating
+from ledger_app_clients.ethereum.tx_simu import TxSimu
+from ledger_app_clients.ethereum.gcs import (
+    Field, ParamRaw, ParamTokenAmount, Value, TypeFamily, DataPath, TxInfo
+)
+
+ROOT_DIR = Path(__file__).resolve().parents[2]
+RAGGER_DIR = ROOT_DIR / "tests" / "ragger"
+BIP32_PATH = "m/44'/60'/0'/0/0"
+# the challenge is not checked by the benchmark build
+CHALLENGE = 0x12345678
+USDT_ADDR = bytes.fromhex("dAC17F958D2ee523a2206206994597C13D831ec7")
+USDC_ADDR = bytes.fromhex("A0b86991c6218b36c1d19D4a2e9Eb0cE3606eB48")
+ONEINCH_ROUTER_ADDR = bytes.fromhex("111111125421cA6dc452d289314280a0f8842A65")
+NATIVE_ADDR = bytes.fromhex("EeeeeEeeeEeEeeEeEeEeeEEEeeeeEeeeeeeeEEeE")
+RECIPIENT_ADDR = bytes.fromhex("d8da6bf26964af9d7eed9e03e53415d37aa96045")
+
+sys.path.insert(0, str(RAGGER_DIR))
+from fields_utils import get_all_paths, get_all_tuple_paths  # noqa: E402 pylint: disable=C0413
+
+
+class RecordingBackend:
+    """Minimal backend which answers every APDU with a success"""
+
+    def __init__(self) -> None:
+        self.device = Devices.get_by_type(DeviceType.FLEX)
+        self.last_async_response = None
+
+    def exchange_raw(self, data: bytes = b"", tick_timeout: int = 0) -> RAPDU:
+        return RAPDU(0x9000, bytes())
+
+    @contextmanager
+    def exchange_async_raw(self, data: bytes = b"") -> Generator[None, None, None]:
+        self.last_async_response = self.exchange_raw(data)
+        yield
+
+
+def tx_legacy(client: EthAppClient) -> None:
+    with client.sign(BIP32_PATH, {
+        "nonce": 68,
+        "gasPrice": Web3.to_wei(20, "gwei"),
+        "gas": 21000,
+        "to": RECIPIENT_ADDR,
+        "value": Web3.to_wei(0.25, "ether"),
+        "chainId": 1,
+    }):
+        pass
+
+
+def tx_eip2930(client: EthAppClient) -> None:
+    with client.sign(BIP32_PATH, {
+        "nonce": 7,
+        "gasPrice": Web3.to_wei(15, "gwei"),
+        "gas": 48000,
+        "to": RECIPIENT_ADDR,
+        "value": Web3.to_wei(0.01, "ether"),
+        "accessList": [
+            {
+                "address": "0x" + USDT_ADDR.hex(),
+                "storageKeys": ["0x" + ("%064x" % i) for i in range(3)],
+            },
+        ],
+        "chainId": 1,
+    }):
+        pass
+
+
+def tx_erc20_transfer(client: EthAppClient) -> None:
+    data = bytes.fromhex("a9059cbb") + bytes(12) + RECIPIENT_ADDR + (250 * 10**6).to_bytes(32, "big")
+
+    client.provide_token_metadata("USDT", USDT_ADDR, 6, 1)
+    with client.sign(BIP32_PATH, {
+        "nonce": 1042,
+        "maxFeePerGas": Web3.to_wei(30, "gwei"),
+        "maxPriorityFeePerGas": Web3.to_wei(1, "gwei"),
+        "gas": 65000,
+        "to": USDT_ADDR,
+        "data": data,
+        "chainId": 1,
+    }):
+        pass
+
+
+def tx_gcs_swap(client: EthAppClient) -> None:
+    abi_file = RAGGER_DIR / "abis" / "1inch.abi.json"
+
+    with open(abi_file, encoding="utf-8") as file:
+        contract = Web3().eth.contract(abi=json.load(file), address=None)
+    data = contract.encode_abi("swap", [
+        bytes.fromhex("F313B370D28760b98A2E935E56Be92Feb2c4EC04"),
+        [
+            NATIVE_ADDR,
+            USDC_ADDR,
+            bytes.fromhex("F313B370D28760b98A2E935E56Be92Feb2c4EC04"),
+            RECIPIENT_ADDR,
+            Web3.to_wei(0.22, "ether"),
+            682119805,
+            0,
+        ],
+        bytes(),
+    ])
+    tx_params = {
+        "nonce": 235,
+        "maxFeePerGas": Web3.to_wei(100, "gwei"),
+        "maxPriorityFeePerGas": Web3.to_wei(10, "gwei"),
+        "gas": 44001,
+        "to": ONEINCH_ROUTER_ADDR,
+        "value": Web3.to_wei(0.22, "ether"),
+        "data": data,
+        "chainId": 1,
+    }
+    with client.sign(BIP32_PATH, tx_params, mode=SignMode.STORE):
+        pass
+
+    param_paths = get_all_paths(str(abi_file), "swap")
+    tuple_paths = get_all_tuple_paths(str(abi_file), "swap", "desc")
+    fields = [
+        Field(1, "Executor", ParamRaw(1, Value(1,
+                                               TypeFamily.ADDRESS,
+                                               data_path=DataPath(1, param_paths["executor"])))),
+    ]
+    for name, amount, token in (("Send", "amount", "srcToken"),
+                                ("Receive", "minReturnAmount", "dstToken")):
+        fields.append(Field(1, name, ParamTokenAmount(
+            1,
+            Value(1, TypeFamily.UINT, type_size=32, data_path=DataPath(1, tuple_paths[amount])),
+            token=Value(1, TypeFamily.ADDRESS, data_path=DataPath(1, tuple_paths[token])),
+            native_currency=[NATIVE_ADDR],
+        )))
+    inst_hash = hashlib.sha3_256()
+    for field in fields:
+        inst_hash.update(field.serialize())
+    tx_info = TxInfo(1,
+                     tx_params["chainId"],
+                     tx_params["to"],
+                     get_selector_from_data(tx_params["data"]),
+                     inst_hash.digest(),
+                     "swap",
+                     creator_name="1inch",
+                     creator_legal_name="1inch Network",
+                     creator_url="1inch.io",
+                     contract_name="Aggregation Router V6",
+                     deploy_date=1707724800)
+    client.provide_transaction_info(tx_info.serialize())
+    client.provide_token_metadata("USDC", USDC_ADDR, 6, 1)
+    for field in fields:
+        client.provide_transaction_field_desc(field.serialize())
+    with client.sign(mode=SignMode.START_FLOW):
+        pass
+
+
+def eip712_message(data_file: Path):
+    filter_file = data_file.parent / data_file.name.replace("-data.json", "-filter.json")
+
+    def record(client: EthAppClient) -> None:
+        with open(data_file, encoding="utf-8") as file:
+            data = json.load(file)
+        filters = None
+        if filter_file.exists():
+            with open(filter_file, encoding="utf-8") as file:
+                filters = json.load(file)
+        InputData.process_data(client, data, filters, use_schema_cache=False)
+    return record
+
+
+def desc_trusted_name(client: EthAppClient) -> None:
+    client.provide_trusted_name(TrustedName(2,
+                                            RECIPIENT_ADDR,
+                                            "vitalik.eth",
+                                            chain_id=1,
+                                            challenge=CHALLENGE,
+                                            tn_type=TrustedNameType.ACCOUNT,
+                                            tn_source=TrustedNameSource.ENS,
+                                            coin_type=CoinType.ETH))
+
+
+def desc_network(client: EthAppClient) -> None:
+    client.provide_network_information(DynamicNetwork("Base", "ETH", 8453))
+
+
+def desc_proxy(client: EthAppClient) -> None:
+    client.provide_proxy_info(ProxyInfo(CHALLENGE, USDC_ADDR, 1, USDT_ADDR).serialize())
+
+
+def desc_enum(client: EthAppClient) -> None:
+    for idx, name in enumerate(("Stable", "Variable")):
+        client.provide_enum_value(EnumValue(1,
+                                            1,
+                                            ONEINCH_ROUTER_ADDR,
+                                            bytes.fromhex("a415bcad"),
+                                            0,
+                                            idx + 1,
+                                            name).serialize())
+
+
+def desc_gating(client: EthAppClient) -> None:
+    client.provide_gating(Gating(TxType.TRANSACTION,
+                                 USDT_ADDR,
+                                 "Verify this transaction before signing it.",
+                                 "ledger.com/ledger-multisig",
+                                 1))
+
+
+def desc_tx_simulation(client: EthAppClient) -> None:
+    client.provide_tx_simulation(TxSimu(TxType.TRANSACTION,
+                                        2,
+                                        1,
+                                        "https://ledger.com",
+                                        from_addr=RECIPIENT_ADDR,
+                                        tx_hash=bytes.fromhex("deadbeef" * 8),
+                                        chain_id=1))
+
+
+def get_payloads() -> dict[str, dict]:
+    payloads: dict[str, dict] = {
+        "tx": {
+            "legacy_transfer": tx_legacy,
+            "eip2930_access_list": tx_eip2930,
+            "eip1559_erc20_transfer": tx_erc20_transfer,
+            "eip1559_gcs_swap": tx_gcs_swap,
+        },
+        "eip712": {},
+        "descriptors": {
+            "trusted_name": desc_trusted_name,
+            "network": desc_network,
+            "proxy": desc_proxy,
+            "enum": desc_enum,
+            "gating": desc_gating,
+            "tx_simulation": desc_tx_simulation,
+        },
+    }
+    for data_file in sorted((RAGGER_DIR / "eip712_input_files").glob("*-data.json")):
+        name = data_file.name.removesuffix("-data.json")
+        payloads["eip712"][name] = eip712_message(data_file)
+    return payloads
+
+
+def main(output_dir: Path) -> bool:
+    for suite, payloads in get_payloads().items():
+        os.makedirs(output_dir / suite, exist_ok=True)
+        for name, record in payloads.items():
+            trace = ApduTrace(f"Generated by {os.path.basename(sys.argv[0])}")
+            record(EthAppClient(RecordingBackend(), trace))  # type: ignore
+            trace.save(output_dir / suite / f"{name}.apdu")
+    return True
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("OUTPUT_DIR", type=Path)
+    args = parser.parse_args()
+    sys.exit(0 if main(args.OUTPUT_DIR) else 1)
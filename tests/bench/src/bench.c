@@ -0,0 +1,204 @@
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+
+// Way more than the chunks a 16KB arena can hold, keeps the probe sequences short
+#define ARENA_SLOTS 4096
+
+typedef struct {
+    const void *ptr;
+    size_t size;
+} s_arena_slot;
+
+#define BENCH_NAME_ENTRY(id, name) name,
+
+static const char *const g_probe_names[BENCH_PROBE_COUNT] = {BENCH_PROBES(BENCH_NAME_ENTRY)};
+static const char *const g_syscall_names[BENCH_SYSCALL_COUNT] = {
+    BENCH_SYSCALLS(BENCH_NAME_ENTRY)};
+
+// Sizes of the live allocations, the allocator does not give them back on free
+static s_arena_slot g_arena_slots[ARENA_SLOTS];
+
+s_bench_stats g_bench_stats;
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t) ts.tv_sec * 1000000000) + ts.tv_nsec;
+}
+
+/**
+ * Reset the counters, the live allocations are kept since they outlive a run
+ */
+void bench_stats_reset(void) {
+    size_t live = g_bench_stats.arena.live;
+
+    memset(&g_bench_stats, 0, sizeof(g_bench_stats));
+    g_bench_stats.arena.live = live;
+    g_bench_stats.arena.base = live;
+    g_bench_stats.arena.peak = live;
+}
+
+/**
+ * Forget the live allocations, when the arena itself is initialized again
+ */
+void bench_arena_reset(void) {
+    memset(g_arena_slots, 0, sizeof(g_arena_slots));
+    g_bench_stats.arena.live = 0;
+    bench_stats_reset();
+}
+
+void bench_probe_end(e_bench_probe probe, uint64_t start) {
+    g_bench_stats.probes[probe].calls += 1;
+    g_bench_stats.probes[probe].ns += bench_now_ns() - start;
+}
+
+void bench_syscall_count(e_bench_syscall syscall, size_t bytes) {
+    g_bench_stats.syscalls[syscall].calls += 1;
+    g_bench_stats.syscalls[syscall].bytes += bytes;
+}
+
+static size_t arena_slot_idx(const void *ptr) {
+    // the chunks are at least 8-byte aligned
+    return ((uintptr_t) ptr >> 3) % ARENA_SLOTS;
+}
+
+void bench_arena_alloc(const void *ptr, size_t size) {
+    size_t idx;
+
+    if (ptr == NULL) {
+        g_bench_stats.arena.failures += 1;
+        return;
+    }
+    for (idx = arena_slot_idx(ptr); g_arena_slots[idx].ptr != NULL;
+         idx = (idx + 1) % ARENA_SLOTS) {
+    }
+    g_arena_slots[idx].ptr = ptr;
+    g_arena_slots[idx].size = size;
+    g_bench_stats.arena.allocs += 1;
+    g_bench_stats.arena.live += size;
+    if (g_bench_stats.arena.live > g_bench_stats.arena.peak) {
+        g_bench_stats.arena.peak = g_bench_stats.arena.live;
+    }
+}
+
+void bench_arena_free(const void *ptr) {
+    size_t idx;
+    size_t next;
+    size_t home;
+
+    if (ptr == NULL) {
+        return;
+    }
+    for (idx = arena_slot_idx(ptr); g_arena_slots[idx].ptr != ptr;
+         idx = (idx + 1) % ARENA_SLOTS) {
+        if (g_arena_slots[idx].ptr == NULL) {
+            // allocated before the tracking started
+            return;
+        }
+    }
+    g_bench_stats.arena.live -= g_arena_slots[idx].size;
+    // backward-shift deletion, so that no probe sequence gets broken
+    for (next = (idx + 1) % ARENA_SLOTS; g_arena_slots[next].ptr != NULL;
+         next = (next + 1) % ARENA_SLOTS) {
+        home = arena_slot_idx(g_arena_slots[next].ptr);
+        if (((next - home + ARENA_SLOTS) % ARENA_SLOTS) >=
+            ((next - idx + ARENA_SLOTS) % ARENA_SLOTS)) {
+            g_arena_slots[idx] = g_arena_slots[next];
+            idx = next;
+        }
+    }
+    g_arena_slots[idx].ptr = NULL;
+}
+
+void bench_result_start(s_bench_result *result, const char *suite, const char *name) {
+    memset(result, 0, sizeof(*result));
+    result->suite = suite;
+    result->name = name;
+    result->min_ns = UINT64_MAX;
+}
+
+/**
+ * Account for a finished iteration, whose stats are still in \ref g_bench_stats
+ *
+ * @param[in] ns duration of the iteration
+ */
+void bench_result_add(s_bench_result *result, uint64_t ns) {
+    result->iterations += 1;
+    result->total_ns += ns;
+    if (ns < result->min_ns) {
+        result->min_ns = ns;
+    }
+    for (int i = 0; i < BENCH_PROBE_COUNT; ++i) {
+        result->probes_ns[i] += g_bench_stats.probes[i].ns;
+    }
+    result->last = g_bench_stats;
+}
+
+void bench_json_begin(FILE *out, uint32_t iterations) {
+    fprintf(out, "{\n  \"iterations\": %u,\n  \"results\": [", iterations);
+}
+
+void bench_json_result(FILE *out, const s_bench_result *result, bool first) {
+    const s_bench_stats *stats = &result->last;
+    uint32_t iterations = (result->iterations > 0) ? result->iterations : 1;
+    uint64_t mean_ns = result->total_ns / iterations;
+    bool first_item = true;
+
+    fprintf(out,
+            "%s\n    {\"suite\": \"%s\", \"name\": \"%s\"",
+            first ? "" : ",",
+            result->suite,
+            result->name);
+    fprintf(out,
+            ", \"apdus\": %u, \"bytes\": %lu, \"errors\": %u",
+            result->apdus,
+            (unsigned long) result->bytes,
+            result->errors);
+    fprintf(out,
+            ", \"time_ns\": {\"min\": %lu, \"mean\": %lu}",
+            (unsigned long) ((result->iterations > 0) ? result->min_ns : 0),
+            (unsigned long) mean_ns);
+    fprintf(out,
+            ", \"throughput\": {\"apdus_per_s\": %.0f, \"bytes_per_s\": %.0f}",
+            (mean_ns > 0) ? (result->apdus * 1e9 / mean_ns) : 0.0,
+            (mean_ns > 0) ? (result->bytes * 1e9 / mean_ns) : 0.0);
+    fprintf(out,
+            ", \"arena\": {\"peak\": %lu, \"allocs\": %u, \"failures\": %u}",
+            (unsigned long) (stats->arena.peak - stats->arena.base),
+            stats->arena.allocs,
+            stats->arena.failures);
+    fprintf(out, ", \"syscalls\": {");
+    for (int i = 0; i < BENCH_SYSCALL_COUNT; ++i) {
+        if (stats->syscalls[i].calls == 0) {
+            continue;
+        }
+        fprintf(out,
+                "%s\"%s\": {\"calls\": %u, \"bytes\": %lu}",
+                first_item ? "" : ", ",
+                g_syscall_names[i],
+                stats->syscalls[i].calls,
+                (unsigned long) stats->syscalls[i].bytes);
+        first_item = false;
+    }
+    fprintf(out, "}, \"probes\": {");
+    first_item = true;
+    for (int i = 0; i < BENCH_PROBE_COUNT; ++i) {
+        if (stats->probes[i].calls == 0) {
+            continue;
+        }
+        fprintf(out,
+                "%s\"%s\": {\"calls\": %u, \"mean_ns\": %lu}",
+                first_item ? "" : ", ",
+                g_probe_names[i],
+                stats->probes[i].calls,
+                (unsigned long) (result->probes_ns[i] / iterations));
+        first_item = false;
+    }
+    fprintf(out, "}}");
+}
+
+void bench_json_end(FILE *out) {
+    fprintf(out, "\n  ]\n}\n");
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+// Functions timed through a linker wrap, the inner calls of their own translation unit are not
+#define BENCH_PROBES(X)                             \
+    X(PROCESS_TX, "process_tx")                     \
+    X(CALLDATA_APPEND, "calldata_append")           \
+    X(DATA_PATH_GET, "data_path_get")               \
+    X(TYPE_HASH, "type_hash")                       \
+    X(FIELD_HASH, "field_hash")                     \
+    X(PATH_ADVANCE, "path_advance")                 \
+    X(SIGNATURE_CHECK, "check_signature_with_pubkey")
+
+// Syscalls counted through a linker wrap
+#define BENCH_SYSCALLS(X)                                  \
+    X(CX_HASH, "cx_hash_no_throw")                         \
+    X(CX_KECCAK_INIT, "cx_keccak_init_no_throw")           \
+    X(CX_SHA3_INIT, "cx_sha3_init_no_throw")               \
+    X(CX_SHA256_INIT, "cx_sha256_init_no_throw")           \
+    X(CX_SHA256_UPDATE, "cx_sha256_update")                \
+    X(CX_MATH_MULT, "cx_math_mult_no_throw")               \
+    X(BIP32_DERIVE, "bip32_derive_get_pubkey_256")         \
+    X(OS_LIB_CALL, "os_lib_call")
+
+#define BENCH_ENUM_ENTRY(id, name) BENCH_##id,
+
+typedef enum { BENCH_PROBES(BENCH_ENUM_ENTRY) BENCH_PROBE_COUNT } e_bench_probe;
+
+typedef enum { BENCH_SYSCALLS(BENCH_ENUM_ENTRY) BENCH_SYSCALL_COUNT } e_bench_syscall;
+
+typedef struct {
+    uint32_t calls;
+    uint64_t ns;
+} s_bench_probe;
+
+typedef struct {
+    uint32_t calls;
+    uint64_t bytes;  // hashed bytes, 0 for the other syscalls
+} s_bench_syscall;
+
+typedef struct {
+    size_t live;  // bytes currently allocated in the arena
+    size_t base;  // bytes already allocated when the counters were reset (e.g. by an arena cap)
+    size_t peak;
+    uint32_t allocs;
+    uint32_t failures;
+} s_bench_arena;
+
+typedef struct {
+    s_bench_probe probes[BENCH_PROBE_COUNT];
+    s_bench_syscall syscalls[BENCH_SYSCALL_COUNT];
+    s_bench_arena arena;
+} s_bench_stats;
+
+extern s_bench_stats g_bench_stats;
+
+uint64_t bench_now_ns(void);
+void bench_stats_reset(void);
+void bench_probe_end(e_bench_probe probe, uint64_t start);
+void bench_syscall_count(e_bench_syscall syscall, size_t bytes);
+void bench_arena_alloc(const void *ptr, size_t size);
+void bench_arena_free(const void *ptr);
+void bench_arena_reset(void);
+
+typedef struct {
+    const char *suite;
+    const char *name;
+    uint32_t iterations;
+    uint32_t apdus;
+    uint32_t errors;  // APDUs which did not succeed
+    uint64_t bytes;   // APDUs payload bytes
+    uint64_t min_ns;
+    uint64_t total_ns;
+    uint64_t probes_ns[BENCH_PROBE_COUNT];  // summed over all the iterations
+    s_bench_stats last;                     // stats of the last iteration
+} s_bench_result;
+
+void bench_result_start(s_bench_result *result, const char *suite, const char *name);
+void bench_result_add(s_bench_result *result, uint64_t ns);
+
+void bench_json_begin(FILE *out, uint32_t iterations);
+void bench_json_result(FILE *out, const s_bench_result *result, bool first);
+void bench_json_end(FILE *out);
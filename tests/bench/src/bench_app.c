@@ -0,0 +1,211 @@
+/**
+ * The app as the benchmarks drive it, APDUs go through the same dispatcher as on the device
+ */
+
+#include <stdlib.h>
+
+#include "bench_app.h"
+#include "bench.h"
+
+#include "fuzz_utils.h"
+#include "mocks.h"
+#include "apdu_constants.h"
+#include "apdu_dispatcher.h"
+#include "mem_utils.h"
+
+// Class of the certificate APDUs, which the OS handles before the app gets them on a device
+#define CLA_PKI 0xB0
+
+// Usable size of the arena, 0 for all of it
+static uint16_t g_arena_cap = 0;
+
+/**
+ * Set up the app, the arena can be capped through the ARENA_CAP environment variable
+ */
+void bench_app_init(void) {
+    const char *cap = getenv("ARENA_CAP");
+
+    init_fuzzing_environment();
+    if (cap != NULL) {
+        g_arena_cap = strtoul(cap, NULL, 0);
+    }
+}
+
+/**
+ * Cap the usable size of the arena, from the next reset
+ *
+ * @param[in] cap usable size in bytes, 0 for no cap
+ */
+void bench_app_set_arena_cap(uint16_t cap) {
+    g_arena_cap = cap;
+}
+
+/**
+ * Same as the one of main.c, which is not built, the fuzzing mock does not parse anything
+ */
+const uint8_t *parseBip32(const uint8_t *dataBuffer, uint8_t *dataLength, bip32_path_t *bip32) {
+    if (*dataLength < 1) {
+        return NULL;
+    }
+    bip32->length = *dataBuffer;
+    dataBuffer++;
+    (*dataLength)--;
+    if (*dataLength < sizeof(uint32_t) * (bip32->length)) {
+        return NULL;
+    }
+    if (bip32_path_read(dataBuffer, (size_t) *dataLength, bip32->path, (size_t) bip32->length) ==
+        false) {
+        return NULL;
+    }
+    dataBuffer += bip32->length * sizeof(uint32_t);
+    *dataLength -= bip32->length * sizeof(uint32_t);
+    return dataBuffer;
+}
+
+/**
+ * Process an APDU the same way the app main loop does, the UI is stubbed by the fuzzing SDK
+ *
+ * The certificate APDUs are acknowledged without reaching the app, like on a device.
+ *
+ * @param[in] apdu the APDU
+ * @return status word
+ */
+uint16_t bench_app_run(const s_bench_apdu *apdu) {
+    command_t cmd = {.cla = apdu->cla,
+                     .ins = apdu->ins,
+                     .p1 = apdu->p1,
+                     .p2 = apdu->p2,
+                     .lc = apdu->lc,
+                     .data = (uint8_t *) apdu->data};
+    uint32_t flags = 0;
+    uint32_t tx = 0;
+    uint16_t sw;
+
+    if (apdu->cla == CLA_PKI) {
+        // recorded along with the app APDUs, the app state must not be affected
+        return SWO_SUCCESS;
+    }
+    if (sigsetjmp(fuzz_exit_jump_ctx.jmp_buf, 1)) {
+        return SW_APP_EXITED;
+    }
+    sw = handle_apdu(&cmd, &flags, &tx);
+    if ((sw != SWO_SUCCESS) && (sw != APDU_NO_RESPONSE) &&
+        (sw != SWO_COMMAND_CODE_NOT_SUPPORTED)) {
+        reset_app_context();
+    }
+    return sw;
+}
+
+/**
+ * Bring the app back to its startup state, the persistent caches included
+ *
+ * The arena is then initialized again, so that its layout does not depend on the previous runs.
+ *
+ * @return whether the arena cap could be applied
+ */
+bool bench_app_reset(void) {
+    reset_app_session();
+    // the cap ballast must not outlive the arena
+    app_mem_set_cap(0);
+    if (g_bench_stats.arena.live != 0) {
+        fprintf(stderr, "%zu bytes still allocated after the reset\n", g_bench_stats.arena.live);
+    }
+    init_fuzzing_environment();
+    init_fuzzing_arena();
+    bench_arena_reset();
+    if (!app_mem_set_cap(g_arena_cap)) {
+        fprintf(stderr, "Could not cap the arena to %u bytes\n", g_arena_cap);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Replay a payload once, from a fresh app
+ *
+ * @param[in] payload the APDUs
+ * @param[out] sws status word of each APDU
+ * @return whether the app could be reset
+ */
+bool bench_app_replay(const s_bench_payload *payload, uint16_t *sws) {
+    if (!bench_app_reset()) {
+        return false;
+    }
+    bench_stats_reset();
+    for (size_t i = 0; i < payload->count; ++i) {
+        sws[i] = bench_app_run(&payload->apdus[i]);
+    }
+    return true;
+}
+
+/**
+ * Replay a payload several times, from a fresh app each time, and report its results
+ *
+ * Every iteration must get the status words of the first one, otherwise some state survived the
+ * reset and the iterations did not measure the same thing.
+ *
+ * @param[in] suite name of the suite it belongs to
+ * @param[in] payload the APDUs
+ * @param[in] iterations number of replays
+ * @param[in] out JSON report output
+ * @param[in] first whether it is the first result of the report
+ * @return whether all the iterations got the same status words
+ */
+bool bench_app_payload(const char *suite,
+                       const s_bench_payload *payload,
+                       uint32_t iterations,
+                       FILE *out,
+                       bool first) {
+    s_bench_result result;
+    uint64_t start;
+    uint16_t *sws = calloc(payload->count, sizeof(*sws));
+    uint16_t sw;
+    bool ret = true;
+
+    if (sws == NULL) {
+        fprintf(stderr, "%s/%s: could not allocate the status words\n", suite, payload->name);
+        return false;
+    }
+    bench_result_start(&result, suite, payload->name);
+    result.apdus = payload->count;
+    for (size_t i = 0; i < payload->count; ++i) {
+        result.bytes += payload->apdus[i].lc;
+    }
+    for (uint32_t it = 0; it < iterations; ++it) {
+        bench_app_reset();
+        bench_stats_reset();
+        start = bench_now_ns();
+        for (size_t i = 0; i < payload->count; ++i) {
+            sw = bench_app_run(&payload->apdus[i]);
+            if (it == 0) {
+                sws[i] = sw;
+                if ((sw != SWO_SUCCESS) && (sw != APDU_NO_RESPONSE)) {
+                    fprintf(stderr,
+                            "%s/%s: APDU #%zu returned 0x%04x\n",
+                            suite,
+                            payload->name,
+                            i,
+                            sw);
+                    result.errors += 1;
+                }
+            } else if (sw != sws[i]) {
+                fprintf(stderr,
+                        "%s/%s: APDU #%zu returned 0x%04x on iteration %u, 0x%04x on the first "
+                        "one\n",
+                        suite,
+                        payload->name,
+                        i,
+                        sw,
+                        it,
+                        sws[i]);
+                result.errors += 1;
+                ret = false;
+            }
+        }
+        bench_result_add(&result, bench_now_ns() - start);
+    }
+    bench_app_reset();
+    bench_json_result(out, &result, first);
+    free(sws);
+    return ret;
+}
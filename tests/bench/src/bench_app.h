@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "bench_corpus.h"
+
+// SW returned when the app exits in the middle of an APDU
+#define SW_APP_EXITED 0x6FFF
+
+void bench_app_init(void);
+void bench_app_set_arena_cap(uint16_t cap);
+uint16_t bench_app_run(const s_bench_apdu *apdu);
+bool bench_app_reset(void);
+bool bench_app_replay(const s_bench_payload *payload, uint16_t *sws);
+bool bench_app_payload(const char *suite,
+                       const s_bench_payload *payload,
+                       uint32_t iterations,
+                       FILE *out,
+                       bool first);
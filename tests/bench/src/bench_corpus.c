@@ -0,0 +1,143 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "bench_corpus.h"
+
+// header + data, hex-encoded
+#define LINE_MAX_SIZE ((5 + BENCH_APDU_DATA_MAX) * 2 + 16)
+
+static int hex_digit(char c) {
+    if ((c >= '0') && (c <= '9')) {
+        return c - '0';
+    }
+    c = (char) tolower((unsigned char) c);
+    if ((c >= 'a') && (c <= 'f')) {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+/**
+ * Parse a hex-encoded APDU
+ *
+ * @param[in] hex NUL-terminated string, with no whitespace
+ * @param[out] apdu parsed APDU
+ * @return whether it was successful
+ */
+bool bench_corpus_parse_apdu(const char *hex, s_bench_apdu *apdu) {
+    uint8_t raw[5 + BENCH_APDU_DATA_MAX];
+    size_t hex_len = strlen(hex);
+    size_t size;
+    int hi;
+    int lo;
+
+    if (((hex_len % 2) != 0) || ((hex_len / 2) > sizeof(raw)) || ((hex_len / 2) < 5)) {
+        return false;
+    }
+    size = hex_len / 2;
+    for (size_t i = 0; i < size; ++i) {
+        if (((hi = hex_digit(hex[i * 2])) < 0) || ((lo = hex_digit(hex[i * 2 + 1])) < 0)) {
+            return false;
+        }
+        raw[i] = (uint8_t) ((hi << 4) | lo);
+    }
+    if (raw[4] != (size - 5)) {
+        return false;
+    }
+    apdu->cla = raw[0];
+    apdu->ins = raw[1];
+    apdu->p1 = raw[2];
+    apdu->p2 = raw[3];
+    apdu->lc = raw[4];
+    memcpy(apdu->data, &raw[5], apdu->lc);
+    return true;
+}
+
+static char *payload_name(const char *path) {
+    const char *start = strrchr(path, '/');
+    const char *end;
+    char *name;
+
+    start = (start == NULL) ? path : (start + 1);
+    if ((end = strrchr(start, '.')) == NULL) {
+        end = start + strlen(start);
+    }
+    if ((name = malloc(end - start + 1)) != NULL) {
+        memcpy(name, start, end - start);
+        name[end - start] = '\0';
+    }
+    return name;
+}
+
+/**
+ * Load a corpus file
+ *
+ * @param[in] path file path
+ * @param[out] payload loaded APDUs, to be freed with \ref bench_corpus_free
+ * @return whether it was successful
+ */
+bool bench_corpus_load(const char *path, s_bench_payload *payload) {
+    char line[LINE_MAX_SIZE];
+    size_t capacity = 0;
+    size_t line_nb = 0;
+    s_bench_apdu *tmp;
+    FILE *file;
+    char *hex;
+    char *end;
+    bool ret = true;
+
+    memset(payload, 0, sizeof(*payload));
+    if ((file = fopen(path, "r")) == NULL) {
+        fprintf(stderr, "Could not open %s\n", path);
+        return false;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        line_nb += 1;
+        for (hex = line; isspace((unsigned char) *hex); ++hex) {
+        }
+        for (end = hex + strlen(hex); (end > hex) && isspace((unsigned char) end[-1]); --end) {
+        }
+        *end = '\0';
+        if ((*hex == '\0') || (*hex == '#')) {
+            continue;
+        }
+        if (payload->count == capacity) {
+            capacity = (capacity == 0) ? 16 : (capacity * 2);
+            if ((tmp = realloc(payload->apdus, capacity * sizeof(*tmp))) == NULL) {
+                ret = false;
+                break;
+            }
+            payload->apdus = tmp;
+        }
+        if (!bench_corpus_parse_apdu(hex, &payload->apdus[payload->count])) {
+            fprintf(stderr, "%s:%zu: invalid APDU\n", path, line_nb);
+            ret = false;
+            break;
+        }
+        payload->count += 1;
+    }
+    fclose(file);
+    if (ret && ((payload->name = payload_name(path)) == NULL)) {
+        ret = false;
+    }
+    if (!ret) {
+        bench_corpus_free(payload);
+    }
+    return ret;
+}
+
+void bench_corpus_free(s_bench_payload *payload) {
+    free(payload->name);
+    free(payload->apdus);
+    memset(payload, 0, sizeof(*payload));
+}
+
+/**
+ * Directory scan filter, keeping the corpus files
+ */
+int bench_corpus_filter(const struct dirent *entry) {
+    const char *ext = strrchr(entry->d_name, '.');
+
+    return (ext != NULL) && (strcmp(ext, ".apdu") == 0);
+}
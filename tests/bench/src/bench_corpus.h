@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <dirent.h>
+
+/**
+ * Corpus files (*.apdu) hold one APDU per line, hex-encoded with its 5-byte header
+ * (CLA INS P1 P2 LC DATA). Empty lines and the ones starting with '#' are ignored.
+ */
+
+#define BENCH_APDU_DATA_MAX 255
+
+typedef struct {
+    uint8_t cla;
+    uint8_t ins;
+    uint8_t p1;
+    uint8_t p2;
+    uint8_t lc;
+    uint8_t data[BENCH_APDU_DATA_MAX];
+} s_bench_apdu;
+
+typedef struct {
+    char *name;  // file name, without its extension
+    s_bench_apdu *apdus;
+    size_t count;
+} s_bench_payload;
+
+bool bench_corpus_parse_apdu(const char *hex, s_bench_apdu *apdu);
+bool bench_corpus_load(const char *path, s_bench_payload *payload);
+void bench_corpus_free(s_bench_payload *payload);
+int bench_corpus_filter(const struct dirent *entry);
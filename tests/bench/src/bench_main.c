@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <getopt.h>
+
+#include "bench.h"
+#include "bench_app.h"
+#include "bench_corpus.h"
+
+#include "fuzz_utils.h"
+#include "apdu_constants.h"
+#include "uint256.h"
+#include "common_utils.h"
+
+#define DEFAULT_ITERATIONS 100
+
+// Corpus subdirectories, also used as the suites names
+static const char *const g_suites[] = {"tx", "eip712", "descriptors"};
+
+static bool bench_suite(const char *corpus_dir,
+                        const char *suite,
+                        uint32_t iterations,
+                        FILE *out,
+                        bool *first) {
+    struct dirent **entries;
+    s_bench_payload payload;
+    char path[1024];
+    int count;
+    bool ret = true;
+
+    snprintf(path, sizeof(path), "%s/%s", corpus_dir, suite);
+    if ((count = scandir(path, &entries, &bench_corpus_filter, &alphasort)) < 0) {
+        // the suite is optional
+        return true;
+    }
+    for (int i = 0; i < count; ++i) {
+        snprintf(path, sizeof(path), "%s/%s/%s", corpus_dir, suite, entries[i]->d_name);
+        if (ret && ((ret = bench_corpus_load(path, &payload)) == true)) {
+            ret = bench_app_payload(suite, &payload, iterations, out, *first);
+            bench_corpus_free(&payload);
+            *first = false;
+        }
+        free(entries[i]);
+    }
+    free(entries);
+    return ret;
+}
+
+// Amounts to format, as big-endian hex strings
+static const char *const g_amounts[] = {
+    "00",
+    "01",
+    "0de0b6b3a7640000",    // 1 ETH in wei
+    "05f5e100",            // 100 USDT in base units
+    "3635c9adc5dea00000",  // 1000 ETH in wei
+    "0000000000000000000000000000000100000000000000000000000000000000",
+    "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+};
+
+static bool parse_amount(const char *hex, uint8_t *amount, uint8_t *size) {
+    size_t len = strlen(hex) / 2;
+
+    if (len > 32) {
+        return false;
+    }
+    for (size_t i = 0; i < len; ++i) {
+        if (sscanf(&hex[i * 2], "%2hhx", &amount[i]) != 1) {
+            return false;
+        }
+    }
+    *size = len;
+    return true;
+}
+
+/**
+ * Benchmark the amount formatting, which is not reached through APDUs often enough
+ */
+static bool bench_format(uint32_t iterations, FILE *out, bool first) {
+    uint8_t amounts[ARRAY_SIZE(g_amounts)][32] = {0};
+    uint8_t sizes[ARRAY_SIZE(g_amounts)];
+    uint256_t number;
+    char buf[80];
+    s_bench_result result;
+    uint64_t start;
+
+    for (size_t i = 0; i < ARRAY_SIZE(g_amounts); ++i) {
+        if (!parse_amount(g_amounts[i], amounts[i], &sizes[i])) {
+            return false;
+        }
+    }
+    bench_result_start(&result, "format", "tostring256");
+    for (uint32_t it = 0; it < iterations; ++it) {
+        bench_stats_reset();
+        start = bench_now_ns();
+        for (size_t i = 0; i < ARRAY_SIZE(g_amounts); ++i) {
+            convertUint256BE(amounts[i], sizes[i], &number);
+            if (!tostring256(&number, 10, buf, sizeof(buf)) ||
+                !tostring256(&number, 16, buf, sizeof(buf))) {
+                result.errors += (it == 0) ? 1 : 0;
+            }
+        }
+        bench_result_add(&result, bench_now_ns() - start);
+    }
+    bench_json_result(out, &result, first);
+
+    bench_result_start(&result, "format", "amountToString");
+    for (uint32_t it = 0; it < iterations; ++it) {
+        bench_stats_reset();
+        start = bench_now_ns();
+        for (size_t i = 0; i < ARRAY_SIZE(g_amounts); ++i) {
+            if (!amountToString(amounts[i], sizes[i], 18, "ETH", buf, sizeof(buf)) ||
+                !amountToString(amounts[i], sizes[i], 6, "USDT", buf, sizeof(buf))) {
+                result.errors += (it == 0) ? 1 : 0;
+            }
+        }
+        bench_result_add(&result, bench_now_ns() - start);
+    }
+    bench_json_result(out, &result, false);
+    return true;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-n ITERATIONS] [-o OUTPUT] CORPUS_DIR\n", name);
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t iterations = DEFAULT_ITERATIONS;
+    const char *output = NULL;
+    FILE *out = stdout;
+    bool first = true;
+    bool ret = true;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:o:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                iterations = strtoul(optarg, NULL, 0);
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if ((optind != (argc - 1)) || (iterations == 0)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if ((output != NULL) && ((out = fopen(output, "w")) == NULL)) {
+        fprintf(stderr, "Could not open %s\n", output);
+        return EXIT_FAILURE;
+    }
+
+    bench_app_init();
+    bench_json_begin(out, iterations);
+    for (size_t i = 0; ret && (i < ARRAY_SIZE(g_suites)); ++i) {
+        ret = bench_suite(argv[optind], g_suites[i], iterations, out, &first);
+    }
+    ret = ret && bench_format(iterations, out, first);
+    bench_json_end(out);
+
+    if (out != stdout) {
+        fclose(out);
+    }
+    return ret ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,198 @@
+/**
+ * Linker wraps (-Wl,--wrap=<symbol>) accounting for the time, syscalls and arena usage of the app
+ *
+ * Each wrap does its accounting and forwards the call to the real implementation.
+ */
+
+#include "bench.h"
+
+#include "mem_alloc.h"
+#include "cx.h"
+#include "os_lib.h"
+#include "crypto_helpers.h"
+#include "eth_ustream.h"
+#include "calldata.h"
+#include "gtp_data_path.h"
+#include "type_hash.h"
+#include "field_hash.h"
+#include "path.h"
+#include "public_keys.h"
+
+// Arena
+
+void *__real_mem_alloc(mem_ctx_t ctx, size_t nb_bytes);
+void __real_mem_free(mem_ctx_t ctx, void *ptr);
+
+void *__wrap_mem_alloc(mem_ctx_t ctx, size_t nb_bytes) {
+    void *ptr = __real_mem_alloc(ctx, nb_bytes);
+
+    bench_arena_alloc(ptr, nb_bytes);
+    return ptr;
+}
+
+void __wrap_mem_free(mem_ctx_t ctx, void *ptr) {
+    bench_arena_free(ptr);
+    __real_mem_free(ctx, ptr);
+}
+
+// Syscalls
+
+cx_err_t __real_cx_hash_no_throw(cx_hash_t *hash,
+                                 uint32_t mode,
+                                 const uint8_t *in,
+                                 size_t len,
+                                 uint8_t *out,
+                                 size_t out_len);
+cx_err_t __real_cx_keccak_init_no_throw(cx_sha3_t *hash, size_t size);
+cx_err_t __real_cx_sha3_init_no_throw(cx_sha3_t *hash, size_t size);
+cx_err_t __real_cx_sha256_init_no_throw(cx_sha256_t *hash);
+cx_err_t __real_cx_sha256_update(cx_sha256_t *ctx, const uint8_t *data, size_t len);
+cx_err_t __real_cx_math_mult_no_throw(uint8_t *r, const uint8_t *a, const uint8_t *b, size_t len);
+cx_err_t __real_bip32_derive_get_pubkey_256(cx_curve_t curve,
+                                            const uint32_t *path,
+                                            size_t path_len,
+                                            uint8_t raw_pubkey[static 65],
+                                            uint8_t *chain_code,
+                                            cx_md_t hashID);
+void __real_os_lib_call(unsigned int *call_parameters);
+
+cx_err_t __wrap_cx_hash_no_throw(cx_hash_t *hash,
+                                 uint32_t mode,
+                                 const uint8_t *in,
+                                 size_t len,
+                                 uint8_t *out,
+                                 size_t out_len) {
+    bench_syscall_count(BENCH_CX_HASH, len);
+    return __real_cx_hash_no_throw(hash, mode, in, len, out, out_len);
+}
+
+cx_err_t __wrap_cx_keccak_init_no_throw(cx_sha3_t *hash, size_t size) {
+    bench_syscall_count(BENCH_CX_KECCAK_INIT, 0);
+    return __real_cx_keccak_init_no_throw(hash, size);
+}
+
+cx_err_t __wrap_cx_sha3_init_no_throw(cx_sha3_t *hash, size_t size) {
+    bench_syscall_count(BENCH_CX_SHA3_INIT, 0);
+    return __real_cx_sha3_init_no_throw(hash, size);
+}
+
+cx_err_t __wrap_cx_sha256_init_no_throw(cx_sha256_t *hash) {
+    bench_syscall_count(BENCH_CX_SHA256_INIT, 0);
+    return __real_cx_sha256_init_no_throw(hash);
+}
+
+cx_err_t __wrap_cx_sha256_update(cx_sha256_t *ctx, const uint8_t *data, size_t len) {
+    bench_syscall_count(BENCH_CX_SHA256_UPDATE, len);
+    return __real_cx_sha256_update(ctx, data, len);
+}
+
+cx_err_t __wrap_cx_math_mult_no_throw(uint8_t *r, const uint8_t *a, const uint8_t *b, size_t len) {
+    bench_syscall_count(BENCH_CX_MATH_MULT, 0);
+    return __real_cx_math_mult_no_throw(r, a, b, len);
+}
+
+cx_err_t __wrap_bip32_derive_get_pubkey_256(cx_curve_t curve,
+                                            const uint32_t *path,
+                                            size_t path_len,
+                                            uint8_t raw_pubkey[static 65],
+                                            uint8_t *chain_code,
+                                            cx_md_t hashID) {
+    bench_syscall_count(BENCH_BIP32_DERIVE, 0);
+    return __real_bip32_derive_get_pubkey_256(curve,
+                                              path,
+                                              path_len,
+                                              raw_pubkey,
+                                              chain_code,
+                                              hashID);
+}
+
+void __wrap_os_lib_call(unsigned int *call_parameters) {
+    bench_syscall_count(BENCH_OS_LIB_CALL, 0);
+    __real_os_lib_call(call_parameters);
+}
+
+// Probes
+
+parserStatus_e __real_process_tx(txContext_t *context, const uint8_t *buffer, size_t length);
+bool __real_calldata_append(s_calldata *calldata, const uint8_t *buffer, size_t size);
+bool __real_data_path_get(const s_data_path *data_path, s_parsed_value_collection *collection);
+bool __real_type_hash(const char *struct_name, const uint8_t struct_name_length, uint8_t *hash_buf);
+bool __real_field_hash(const uint8_t *data, uint8_t data_length, bool partial);
+bool __real_path_advance(bool do_typehash);
+bool __real_check_signature_with_pubkey(uint8_t *buffer,
+                                        const uint8_t bufLen,
+                                        const uint8_t *PubKey,
+                                        const uint8_t keyLen,
+                                        const uint8_t keyUsageExp,
+                                        const uint8_t *signature,
+                                        const uint8_t sigLen);
+
+parserStatus_e __wrap_process_tx(txContext_t *context, const uint8_t *buffer, size_t length) {
+    uint64_t start = bench_now_ns();
+    parserStatus_e ret = __real_process_tx(context, buffer, length);
+
+    bench_probe_end(BENCH_PROCESS_TX, start);
+    return ret;
+}
+
+bool __wrap_calldata_append(s_calldata *calldata, const uint8_t *buffer, size_t size) {
+    uint64_t start = bench_now_ns();
+    bool ret = __real_calldata_append(calldata, buffer, size);
+
+    bench_probe_end(BENCH_CALLDATA_APPEND, start);
+    return ret;
+}
+
+bool __wrap_data_path_get(const s_data_path *data_path, s_parsed_value_collection *collection) {
+    uint64_t start = bench_now_ns();
+    bool ret = __real_data_path_get(data_path, collection);
+
+    bench_probe_end(BENCH_DATA_PATH_GET, start);
+    return ret;
+}
+
+bool __wrap_type_hash(const char *struct_name,
+                      const uint8_t struct_name_length,
+                      uint8_t *hash_buf) {
+    uint64_t start = bench_now_ns();
+    bool ret = __real_type_hash(struct_name, struct_name_length, hash_buf);
+
+    bench_probe_end(BENCH_TYPE_HASH, start);
+    return ret;
+}
+
+bool __wrap_field_hash(const uint8_t *data, uint8_t data_length, bool partial) {
+    uint64_t start = bench_now_ns();
+    bool ret = __real_field_hash(data, data_length, partial);
+
+    bench_probe_end(BENCH_FIELD_HASH, start);
+    return ret;
+}
+
+bool __wrap_path_advance(bool do_typehash) {
+    uint64_t start = bench_now_ns();
+    bool ret = __real_path_advance(do_typehash);
+
+    bench_probe_end(BENCH_PATH_ADVANCE, start);
+    return ret;
+}
+
+bool __wrap_check_signature_with_pubkey(uint8_t *buffer,
+                                        const uint8_t bufLen,
+                                        const uint8_t *PubKey,
+                                        const uint8_t keyLen,
+                                        const uint8_t keyUsageExp,
+                                        const uint8_t *signature,
+                                        const uint8_t sigLen) {
+    uint64_t start = bench_now_ns();
+    bool ret = __real_check_signature_with_pubkey(buffer,
+                                                  bufLen,
+                                                  PubKey,
+                                                  keyLen,
+                                                  keyUsageExp,
+                                                  signature,
+                                                  sigLen);
+
+    bench_probe_end(BENCH_SIGNATURE_CHECK, start);
+    return ret;
+}
@@ -0,0 +1,197 @@
+/**
+ * Replay recorded APDU traces into the app, and report their throughput
+ *
+ * The traces are recorded by the Python client (see ApduTrace), in the corpus format of the
+ * benchmark.
+ *
+ * In sweep mode, the minimum arena each trace needs is searched instead: the smallest arena cap
+ * with which all its APDUs get the same status words as with the whole arena.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <getopt.h>
+#include <sys/stat.h>
+
+#include "bench.h"
+#include "bench_app.h"
+#include "bench_corpus.h"
+
+#include "fuzz_utils.h"
+
+#define DEFAULT_ITERATIONS 10
+
+// Same as the app, see init_fuzzing_environment()
+#define ARENA_SIZE (16 * 1024)
+// Precision of the sweep, the arena chunks are 8-byte aligned
+#define SWEEP_STEP 8
+
+typedef struct {
+    uint32_t iterations;
+    bool sweep;
+    FILE *out;
+    bool first;  // no result written yet
+} s_replay_opts;
+
+/**
+ * Whether a payload gets the expected status words with the given arena cap
+ */
+static bool replay_matches(const s_bench_payload *payload,
+                           uint16_t cap,
+                           const uint16_t *expected,
+                           uint16_t *sws) {
+    bench_app_set_arena_cap(cap);
+    if (!bench_app_replay(payload, sws)) {
+        return false;
+    }
+    return memcmp(sws, expected, payload->count * sizeof(*sws)) == 0;
+}
+
+/**
+ * Search the minimum arena a payload needs, by bisection (assuming more memory never hurts)
+ */
+static bool sweep_payload(const s_bench_payload *payload, FILE *out, bool first) {
+    uint16_t *expected = calloc(payload->count, sizeof(*expected));
+    uint16_t *sws = calloc(payload->count, sizeof(*sws));
+    uint16_t low = 0;
+    uint16_t high = ARENA_SIZE;
+    uint16_t mid;
+    size_t peak;
+
+    if ((expected == NULL) || (sws == NULL)) {
+        free(expected);
+        free(sws);
+        return false;
+    }
+    bench_app_set_arena_cap(0);
+    bench_app_replay(payload, expected);
+    peak = g_bench_stats.arena.peak - g_bench_stats.arena.base;
+    // the bisection only makes sense if a replay does not depend on the previous ones
+    if (!replay_matches(payload, 0, expected, sws)) {
+        fprintf(stderr, "%s: the status words differ from one replay to the next\n", payload->name);
+        free(expected);
+        free(sws);
+        return false;
+    }
+    while ((high - low) > SWEEP_STEP) {
+        mid = ((low + high) / 2) & ~(SWEEP_STEP - 1);
+        if (replay_matches(payload, mid, expected, sws)) {
+            high = mid;
+        } else {
+            low = mid;
+        }
+    }
+    bench_app_set_arena_cap(0);
+    bench_app_reset();
+    fprintf(out,
+            "%s\n    {\"name\": \"%s\", \"apdus\": %zu, \"peak\": %zu, \"min_arena\": %u}",
+            first ? "" : ",",
+            payload->name,
+            payload->count,
+            peak,
+            high);
+    free(expected);
+    free(sws);
+    return true;
+}
+
+static bool replay_file(const char *path, s_replay_opts *opts) {
+    s_bench_payload payload;
+    bool ret = true;
+
+    if (!bench_corpus_load(path, &payload)) {
+        return false;
+    }
+    if (opts->sweep) {
+        ret = sweep_payload(&payload, opts->out, opts->first);
+    } else {
+        ret = bench_app_payload("replay", &payload, opts->iterations, opts->out, opts->first);
+    }
+    bench_corpus_free(&payload);
+    opts->first = false;
+    return ret;
+}
+
+/**
+ * Replay a trace file, or all the ones of a directory
+ */
+static bool replay_path(const char *path, s_replay_opts *opts) {
+    struct dirent **entries;
+    struct stat st;
+    char file[1024];
+    int count;
+    bool ret = true;
+
+    if (stat(path, &st) != 0) {
+        fprintf(stderr, "Could not open %s\n", path);
+        return false;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        return replay_file(path, opts);
+    }
+    if ((count = scandir(path, &entries, &bench_corpus_filter, &alphasort)) < 0) {
+        fprintf(stderr, "Could not list %s\n", path);
+        return false;
+    }
+    for (int i = 0; i < count; ++i) {
+        snprintf(file, sizeof(file), "%s/%s", path, entries[i]->d_name);
+        ret = ret && replay_file(file, opts);
+        free(entries[i]);
+    }
+    free(entries);
+    return ret;
+}
+
+static void usage(const char *name) {
+    fprintf(stderr, "Usage: %s [-n ITERATIONS | -s] [-o OUTPUT] TRACE...\n", name);
+}
+
+int main(int argc, char *argv[]) {
+    s_replay_opts opts = {.iterations = DEFAULT_ITERATIONS, .out = stdout, .first = true};
+    const char *output = NULL;
+    bool ret = true;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:so:h")) != -1) {
+        switch (opt) {
+            case 'n':
+                opts.iterations = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                opts.sweep = true;
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            default:
+                usage(argv[0]);
+                return (opt == 'h') ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    if ((optind == argc) || (opts.iterations == 0)) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if ((output != NULL) && ((opts.out = fopen(output, "w")) == NULL)) {
+        fprintf(stderr, "Could not open %s\n", output);
+        return EXIT_FAILURE;
+    }
+
+    bench_app_init();
+    if (opts.sweep) {
+        fprintf(opts.out, "{\n  \"arena_sweep\": [");
+    } else {
+        bench_json_begin(opts.out, opts.iterations);
+    }
+    for (int i = optind; ret && (i < argc); ++i) {
+        ret = replay_path(argv[i], &opts);
+    }
+    bench_json_end(opts.out);
+
+    if (opts.out != stdout) {
+        fclose(opts.out);
+    }
+    return ret ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,37 @@
+#!/usr/bin/env python3
+"""
+Turn recorded APDU traces (see tests/bench) into seeds for the fuzz_session harness
+
+Each APDU of a trace loses its CLA, and the APDUs of a trace are concatenated into one seed.
+"""
+
+import sys
+import argparse
+from pathlib import Path
+
+
+def convert(trace: Path, output_dir: Path) -> None:
+    seed = bytearray()
+    with open(trace, encoding="utf-8") as file:
+        for line in file:
+            line = line.strip()
+            if line and not line.startswith("#"):
+                seed += bytes.fromhex(line)[1:]
+    with open(output_dir / f"{trace.parent.name}_{trace.stem}", "wb") as out:
+        out.write(seed)
+
+
+def main(traces: list[Path], output_dir: Path) -> bool:
+    output_dir.mkdir(parents=True, exist_ok=True)
+    for path in traces:
+        for trace in sorted(path.rglob("*.apdu")) if path.is_dir() else [path]:
+            convert(trace, output_dir)
+    return True
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("-o", "--output-dir", type=Path, default=Path("harness/fuzz_session"))
+    parser.add_argument("TRACE", type=Path, nargs="+", help="trace file or directory of traces")
+    args = parser.parse_args()
+    sys.exit(0 if main(args.TRACE, args.output_dir) else 1)
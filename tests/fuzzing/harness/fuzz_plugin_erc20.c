@@ -8,6 +8,7 @@
 
 #include "fuzz_utils.h"
 #include "erc20_plugin.h"
+#include "internal_plugins.gen.h"
 
 // Buffer sizes for UI queries
 #define NAME_LENGTH    32
@@ -15,16 +16,6 @@
 #define TITLE_LENGTH   32
 #define MSG_LENGTH     79
 
-// ERC20 selectors
-static const uint8_t ERC20_TRANSFER_SELECTOR[SELECTOR_SIZE] = {0xa9, 0x05, 0x9c, 0xbb};
-static const uint8_t ERC20_APPROVE_SELECTOR[SELECTOR_SIZE] = {0x09, 0x5e, 0xa7, 0xb3};
-
-#define NUM_ERC20_SELECTORS_FUZZ 2
-static const uint8_t *const ERC20_SELECTORS_FUZZ[NUM_ERC20_SELECTORS_FUZZ] = {
-    ERC20_TRANSFER_SELECTOR,
-    ERC20_APPROVE_SELECTOR,
-};
-
 static int fuzz_erc20_plugin(const uint8_t *data, size_t size) {
     ethPluginInitContract_t init_contract = {0};
     ethPluginProvideParameter_t provide_param = {0};
@@ -52,8 +43,8 @@ static int fuzz_erc20_plugin(const uint8_t *data, size_t size) {
     }
 
     // Use first byte to select which ERC20 selector to test
-    uint8_t selector_idx = data[0] % NUM_ERC20_SELECTORS_FUZZ;
-    const uint8_t *selector = ERC20_SELECTORS_FUZZ[selector_idx];
+    uint8_t selector_idx = data[0] % PLUGIN_ERC20_SELECTORS_COUNT;
+    const uint8_t *selector = g_erc20_selectors[selector_idx];
 
     // Consume the selector choice byte
     data++;
@@ -0,0 +1,147 @@
+/**
+ * Whole signing sessions, chained through the real APDU dispatcher with the state kept in between
+ *
+ * The input is a sequence of APDUs, each one encoded as INS (1) | P1 (1) | P2 (1) | LC (1) | DATA,
+ * the CLA is always the app one. A recorded APDU trace (see tests/bench) is turned into a seed by
+ * dropping the CLA of each APDU.
+ *
+ * On top of the crashes, an input whose cost exceeds a budget linear in its size (i.e. with a
+ * super-linear cost) is reported as a finding, by aborting.
+ *
+ * The cost is counted in steps, one per execution of an app code region (function body, branch,
+ * loop iteration...) as counted by the profile instrumentation, so that a quadratic walk shows up
+ * as such, it does not depend on the machine load and a finding always reproduces.
+ * The budget is FUZZ_SESSION_BUDGET_STEPS + FUZZ_SESSION_BUDGET_STEPS_PER_BYTE * input size, both
+ * can be overridden through the environment variables of the same name, a base budget of 0
+ * disables the check.
+ * The peak arena usage and the highest cost per byte seen so far are printed when they grow.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "fuzz_utils.h"
+#include "mocks.h"
+#include "apdu_constants.h"
+#include "apdu_dispatcher.h"
+
+#define FUZZ_SESSION_BUDGET_STEPS          100000
+#define FUZZ_SESSION_BUDGET_STEPS_PER_BYTE 100
+
+#define APDU_HEADER_LENGTH 4
+
+typedef struct {
+    uint64_t base;
+    uint64_t per_byte;
+} s_session_budget;
+
+static s_session_budget g_budget;
+static size_t g_peak_arena;
+static uint32_t g_apdu_count;
+static uint64_t g_max_cost;  // steps per input byte, times 100
+
+static uint64_t get_budget_env(const char *name, uint64_t default_steps) {
+    const char *value = getenv(name);
+
+    return (value != NULL) ? strtoull(value, NULL, 0) : default_steps;
+}
+
+/**
+ * Send the APDUs of the input to the dispatcher, until the input or the app ends
+ */
+static void run_session(const uint8_t *data, size_t size) {
+    command_t cmd = {.cla = CLA};
+    uint32_t flags;
+    uint32_t tx;
+    uint16_t sw;
+
+    if (sigsetjmp(fuzz_exit_jump_ctx.jmp_buf, 1)) {
+        return;
+    }
+    while (size >= APDU_HEADER_LENGTH) {
+        cmd.ins = data[0];
+        cmd.p1 = data[1];
+        cmd.p2 = data[2];
+        cmd.lc = data[3];
+        data += APDU_HEADER_LENGTH;
+        size -= APDU_HEADER_LENGTH;
+        if (size < cmd.lc) {
+            return;
+        }
+        cmd.data = (uint8_t *) data;
+        data += cmd.lc;
+        size -= cmd.lc;
+
+        flags = 0;
+        tx = 0;
+        g_apdu_count += 1;
+        sw = handle_apdu(&cmd, &flags, &tx);
+        // Same as the main loop, the flow is aborted on any error
+        if ((sw != SWO_SUCCESS) && (sw != APDU_NO_RESPONSE) &&
+            (sw != SWO_COMMAND_CODE_NOT_SUPPORTED)) {
+            reset_app_context();
+        }
+    }
+}
+
+static void check_cost(uint64_t steps, size_t size) {
+    uint64_t cost = (steps * 100) / ((size > 0) ? size : 1);
+
+    if (cost > g_max_cost) {
+        g_max_cost = cost;
+        fprintf(stderr,
+                "[SESSION] new max cost: %llu.%02llu steps/byte (%zu bytes)\n",
+                (unsigned long long) (cost / 100),
+                (unsigned long long) (cost % 100),
+                size);
+    }
+    if ((g_budget.base > 0) && (steps > (g_budget.base + g_budget.per_byte * size))) {
+        fprintf(stderr,
+                "[SESSION] pathological cost: %llu steps (%u APDUs, %u allocations) for %zu "
+                "bytes\n",
+                (unsigned long long) steps,
+                g_apdu_count,
+                g_fuzz_arena.allocs,
+                size);
+        abort();
+    }
+}
+
+static void check_arena(size_t size) {
+    if (g_fuzz_arena.peak > g_peak_arena) {
+        g_peak_arena = g_fuzz_arena.peak;
+        fprintf(stderr,
+                "[SESSION] new peak arena usage: %zu bytes in %u allocations (%zu bytes)\n",
+                g_peak_arena,
+                g_fuzz_arena.allocs,
+                size);
+    }
+}
+
+int LLVMFuzzerInitialize(int *argc, char ***argv) {
+    (void) argc;
+    (void) argv;
+    g_budget.base = get_budget_env("FUZZ_SESSION_BUDGET_STEPS", FUZZ_SESSION_BUDGET_STEPS);
+    g_budget.per_byte =
+        get_budget_env("FUZZ_SESSION_BUDGET_STEPS_PER_BYTE", FUZZ_SESSION_BUDGET_STEPS_PER_BYTE);
+    return 0;
+}
+
+/* Main fuzzing handler called by libfuzzer */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    uint64_t steps;
+
+    init_fuzzing_environment();
+    g_fuzz_arena.peak = g_fuzz_arena.live;
+    g_fuzz_arena.allocs = 0;
+    g_apdu_count = 0;
+
+    steps = get_executed_regions();
+    run_session(data, size);
+    steps = get_executed_regions() - steps;
+    reset_app_session();
+    check_cost(steps, size);
+    check_arena(size);
+
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <setjmp.h>
+#include <malloc.h>
 
 #include "cx_errors.h"
 #include "cx_sha256.h"
@@ -12,6 +13,7 @@
 #include "os_task.h"
 
 #include "bip32_utils.h"
+#include "mocks.h"
 
 try_context_t fuzz_exit_jump_ctx = {0};
 try_context_t *G_exception_context = &fuzz_exit_jump_ctx;
@@ -58,6 +60,8 @@ uint16_t io_seproxyhal_send_status(uint16_t sw, uint32_t tx, bool reset, bool id
     return 0;
 }
 
+// The benchmark provides its own, see tests/bench
+#ifndef BENCH
 const uint8_t *parseBip32(const uint8_t *dataBuffer, uint8_t *dataLength, bip32_path_t *bip32) {
     UNUSED(dataBuffer);
     UNUSED(dataLength);
@@ -70,15 +74,30 @@ mem_ctx_t __wrap_mem_init(void *heap_start, size_t heap_size) {
     return heap_start;
 }
 
+s_fuzz_arena g_fuzz_arena = {0};
+
 void *__wrap_mem_alloc(mem_ctx_t ctx, size_t nb_bytes) {
+    void *ptr;
+
     (void) ctx;
-    return malloc(nb_bytes);
+    if ((ptr = malloc(nb_bytes)) != NULL) {
+        g_fuzz_arena.live += malloc_usable_size(ptr);
+        if (g_fuzz_arena.live > g_fuzz_arena.peak) {
+            g_fuzz_arena.peak = g_fuzz_arena.live;
+        }
+        g_fuzz_arena.allocs += 1;
+    }
+    return ptr;
 }
 
 void __wrap_mem_free(mem_ctx_t ctx, void *ptr) {
     (void) ctx;
+    if (ptr != NULL) {
+        g_fuzz_arena.live -= malloc_usable_size(ptr);
+    }
     free(ptr);
 }
+#endif  // BENCH
 
 cx_err_t cx_ecdomain_parameters_length(cx_curve_t cv, size_t *length) {
     (void) cv;
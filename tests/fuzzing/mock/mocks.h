@@ -1,6 +1,17 @@
 #pragma once
 
+#include <stdint.h>
+#include <stddef.h>
 #include <setjmp.h>
 #include "exceptions.h"
 
 extern try_context_t fuzz_exit_jump_ctx;
+
+// Usage of the arena, mocked with malloc so that the sanitizers see every allocation
+typedef struct {
+    size_t live;  // bytes currently allocated
+    size_t peak;
+    uint32_t allocs;
+} s_fuzz_arena;
+
+extern s_fuzz_arena g_fuzz_arena;
@@ -3,6 +3,26 @@
 #include "caller_api.h"
 #include "net_icons.gen.h"
 #include "app_mem_utils.h"
+#include "syscall_stats.h"
+#include "context_712.h"
+#include "trusted_name.h"
+#include "network_info.h"
+#include "enum_value.h"
+#include "proxy_info.h"
+#include "cmd_get_tx_simulation.h"
+#include "cmd_get_gating.h"
+#include "feature_sign_tx.h"
+#include "schema_cache.h"
+#include "public_keys.h"
+#include "get_public_key.h"
+#ifdef HAVE_NETWORK_REGISTRY
+#include "network_registry.h"
+#endif
+
+// Profile runtime, the app code is built with -fprofile-instr-generate
+extern char *__llvm_profile_begin_counters(void);
+extern char *__llvm_profile_end_counters(void);
+extern void __llvm_profile_set_filename(const char *name);
 
 // Global state required by the app features
 cx_sha3_t global_sha3 = {0};
@@ -40,14 +60,62 @@ void reset_app_context(void) {
     gcs_cleanup();
     clear_safe_account();
     ui_all_cleanup();
+#ifdef HAVE_SYSCALL_STATS
+    syscall_stats_end_flow();
+#endif
+}
+
+// Free everything a session of APDUs can leave allocated, on top of what reset_app_context() does,
+// including the caches meant to outlive a session, so that no input depends on the previous ones
+void reset_app_session(void) {
+    eip712_context_deinit();
+    reset_app_context();
+    trusted_name_cleanup();
+    enum_value_cleanup();
+    proxy_cleanup();
+    clear_gating();
+    clear_tx_simulation();
+    network_info_cleanup(NULL);
+#ifdef HAVE_NETWORK_REGISTRY
+    network_registry_delete(0);
+#endif
+    schema_cache_clear();
+    sig_cache_clear();
+    pubkey_cache_clear();
+    if (g_tx_hash_ctx != NULL) {
+        APP_MEM_FREE_AND_NULL((void **) &g_tx_hash_ctx);
+    }
+}
+
+// Sum of the execution counts of the app code regions, which only depends on the code paths taken
+uint64_t get_executed_regions(void) {
+    const uint64_t *counter = (const uint64_t *) __llvm_profile_begin_counters();
+    const uint64_t *end = (const uint64_t *) __llvm_profile_end_counters();
+    uint64_t count = 0;
+
+    while (counter < end) {
+        count += *counter;
+        counter += 1;
+    }
+    return count;
+}
+
+// Start over with an empty 16KB heap, every previous allocation is lost
+void init_fuzzing_arena(void) {
+    static uint8_t heap_buffer[16 * 1024];
+
+    mem_utils_init(heap_buffer, sizeof(heap_buffer));
 }
 
 void init_fuzzing_environment(void) {
     // Initialize memory allocator with 16KB heap (only once)
     static bool mem_initialized = false;
     if (!mem_initialized) {
-        static uint8_t heap_buffer[16 * 1024];
-        mem_utils_init(heap_buffer, sizeof(heap_buffer));
+        init_fuzzing_arena();
+        // The profile is only written out when asked for, e.g. by a coverage run
+        if (getenv("LLVM_PROFILE_FILE") == NULL) {
+            __llvm_profile_set_filename("/dev/null");
+        }
         mem_initialized = true;
     }
 
@@ -8,4 +8,7 @@
 #include "status_words.h"
 
 extern void reset_app_context(void);
+extern void reset_app_session(void);
+extern void init_fuzzing_arena(void);
 extern void init_fuzzing_environment(void);
+extern uint64_t get_executed_regions(void);
@@ -6,6 +6,8 @@ import pytest
 
 from ragger.conftest import configuration
 
+from ledger_app_clients.ethereum.apdu_trace import ApduTrace
+
 
 #######################
 # CONFIGURATION START #
@@ -25,6 +27,26 @@ def pytest_configure(config):
         configuration.OPTIONAL.MAIN_APP_DIR = "tests/ragger/.test_dependencies/"
 
 
+def pytest_addoption(parser):
+    parser.addoption("--trace-dir",
+                     type=Path,
+                     help="Record the APDUs of each test in this directory, to replay them on the "
+                          "host (see tests/bench)")
+
+
+@pytest.fixture(autouse=True)
+def apdu_trace(request):
+    trace_dir = request.config.getoption("--trace-dir")
+    if trace_dir is None:
+        yield
+        return
+    ApduTrace.active = ApduTrace(f"Recorded from {request.node.nodeid}")
+    yield
+    name = re.sub(r"[^\w.-]", "_", request.node.nodeid.removeprefix("tests/ragger/"))
+    ApduTrace.active.save(trace_dir / f"{name}.apdu")
+    ApduTrace.active = None
+
+
 @pytest.fixture(name="app_version")
 def app_version_fixture(request) -> tuple[int, int, int]:
     with open(Path(__file__).parent.parent.parent / "Makefile", encoding="utf-8") as f:
@@ -112,10 +112,11 @@ def eip712_new_common(scenario_navigator: NavigateWithScenario,
                       data: dict,
                       filters: Optional[dict] = None,
                       snapshots_dirname: Optional[str] = None,
-                      nb_warnings: int = 0) -> bytes:
+                      nb_warnings: int = 0,
+                      schema_cached: bool = False) -> bytes:
     app_client = EthAppClient(scenario_navigator.backend)
 
-    InputData.process_data(app_client, data, filters)
+    InputData.process_data(app_client, data, filters, schema_cached=schema_cached)
     do_compare = snapshots_dirname is not None
     with app_client.eip712_sign_new(BIP32_PATH):
         if nb_warnings > 0:
@@ -675,6 +676,27 @@ def test_eip712_bs_not_activated_error(scenario_navigator: NavigateWithScenario)
     assert e.value.status == StatusWord.INVALID_DATA
 
 
+def test_eip712_schema_cache(scenario_navigator: NavigateWithScenario):
+    app_client = EthAppClient(scenario_navigator.backend)
+
+    settings_toggle(scenario_navigator.backend.device, scenario_navigator.navigator, [SettingID.BLIND_SIGNING])
+    with pytest.raises(ExceptionRAPDU) as e:
+        app_client.eip712_send_struct_def_cached_schema(hashlib.sha224(b"unknown").digest())
+    assert e.value.status == StatusWord.REF_DATA_NOT_FOUND
+
+    with open(input_files()[0], encoding="utf-8") as file:
+        data = json.load(file)
+    # the first signature caches the schema
+    eip712_new_common(scenario_navigator, data, nb_warnings=1)
+
+    # get_schema_hash() sorts the fields in place
+    schema_hash = InputData.get_schema_hash(json.loads(json.dumps(data["types"])))
+    response = app_client.eip712_send_struct_def_cached_schema(schema_hash)
+    assert response.status == StatusWord.OK
+    # the second one uses it, without the struct definitions
+    eip712_new_common(scenario_navigator, data, nb_warnings=1, schema_cached=True)
+
+
 def test_eip712_proxy(scenario_navigator: NavigateWithScenario):
     app_client = EthAppClient(scenario_navigator.backend)
 
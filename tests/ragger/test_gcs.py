@@ -22,7 +22,7 @@ from client.utils import get_selector_from_data
 from client.gcs import (
     Field, ParamType, ParamRaw, Value, TypeFamily, DataPath, ParamTrustedName,
     ParamNFT, ParamDatetime, DatetimeType, ParamTokenAmount, ParamToken, ParamCalldata,
-    ParamAmount, ParamEnum, ContainerPath, TxInfo, ParamNetwork, VisibleType
+    ParamAmount, ParamEnum, ContainerPath, TxInfo, ParamNetwork, VisibleType, FieldsBatch
 )
 from client.enum_value import EnumValue
 from client.tx_simu import TxSimu
@@ -38,7 +38,8 @@ def compute_inst_hash(fields: list[Field]) -> bytes:
     return inst_hash.digest()
 
 
-def test_gcs_nft(scenario_navigator: NavigateWithScenario):
+@pytest.mark.parametrize("batched", [False, True])
+def test_gcs_nft(scenario_navigator: NavigateWithScenario, batched: bool):
     backend = scenario_navigator.backend
     app_client = EthAppClient(backend)
 
@@ -189,6 +190,7 @@ def test_gcs_nft(scenario_navigator: NavigateWithScenario):
         get_selector_from_data(tx_params["data"]),
         inst_hash,
         "batch transfer NFTs",
+        fields_count=len(fields) if batched else None,
     )
 
     app_client.provide_transaction_info(tx_info.serialize())
@@ -202,13 +204,102 @@ def test_gcs_nft(scenario_navigator: NavigateWithScenario):
                                                 challenge=challenge))
     app_client.provide_nft_metadata("OpenSea Shared Storefront", tx_params["to"], tx_params["chainId"])
 
-    for field in fields:
-        app_client.provide_transaction_field_desc(field.serialize())
+    if batched:
+        app_client.provide_transaction_fields_desc_batch(FieldsBatch(fields).serialize())
+    else:
+        for field in fields:
+            app_client.provide_transaction_field_desc(field.serialize())
 
     with app_client.sign(mode=SignMode.START_FLOW):
         scenario_navigator.review_approve()
 
 
+@pytest.mark.parametrize("count_offset", [-1, 1])
+def test_gcs_fields_count_mismatch(scenario_navigator: NavigateWithScenario, count_offset: int):
+    backend = scenario_navigator.backend
+    app_client = EthAppClient(backend)
+
+    with open(f"{ABIS_FOLDER}/erc20.json", encoding="utf-8") as file:
+        contract = Web3().eth.contract(
+            abi=json.load(file),
+            address=bytes.fromhex("c02aaa39b223fe8d0a0e5c4f27ead9083c756cc2")
+        )
+    data = contract.encode_abi("transfer", [
+        bytes.fromhex("d8da6bf26964af9d7eed9e03e53415d37aa96045"),
+        Web3.to_wei(1, "ether"),
+    ])
+    tx_params = {
+        "nonce": 80,
+        "maxFeePerGas": Web3.to_wei(4.8, "gwei"),
+        "maxPriorityFeePerGas": Web3.to_wei(2, "gwei"),
+        "gas": 44001,
+        "to": contract.address,
+        "data": data,
+        "chainId": 1
+    }
+    with app_client.sign("m/44'/60'/0'/0/0", tx_params, mode=SignMode.STORE):
+        pass
+
+    param_paths = get_all_paths(f"{ABIS_FOLDER}/erc20.json", "transfer")
+    fields = [
+        Field(
+            1,
+            "To",
+            ParamRaw(
+                1,
+                Value(
+                    1,
+                    TypeFamily.ADDRESS,
+                    data_path=DataPath(
+                        1,
+                        param_paths["_to"]
+                    ),
+                )
+            )
+        ),
+        Field(
+            1,
+            "Amount",
+            ParamRaw(
+                1,
+                Value(
+                    1,
+                    TypeFamily.UINT,
+                    type_size=32,
+                    data_path=DataPath(
+                        1,
+                        param_paths["_value"]
+                    ),
+                )
+            )
+        ),
+    ]
+
+    tx_info = TxInfo(
+        1,
+        tx_params["chainId"],
+        tx_params["to"],
+        get_selector_from_data(tx_params["data"]),
+        compute_inst_hash(fields),
+        "transfer",
+        fields_count=len(fields) + count_offset,
+    )
+    app_client.provide_transaction_info(tx_info.serialize())
+
+    if count_offset < 0:
+        # the fields hash is checked as soon as the declared count is reached
+        with pytest.raises(ExceptionRAPDU) as err:
+            app_client.provide_transaction_field_desc(fields[0].serialize())
+    else:
+        # still waiting for a field that never comes
+        for field in fields:
+            app_client.provide_transaction_field_desc(field.serialize())
+        with pytest.raises(ExceptionRAPDU) as err:
+            with app_client.sign(mode=SignMode.START_FLOW):
+                pass
+    assert err.value.status == StatusWord.INVALID_DATA
+
+
 def test_gcs_poap(scenario_navigator: NavigateWithScenario,
                   simu_params: Optional[TxSimu] = None):
     backend = scenario_navigator.backend
@@ -0,0 +1,58 @@
+import pytest
+
+from ragger.backend import BackendInterface
+
+from dynamic_networks_cfg import get_network_config
+
+from client.client import EthAppClient
+from client.status_word import StatusWord
+from client.dynamic_networks import DynamicNetwork
+
+
+STORED_CHAINS = [137, 56]
+
+
+def provide_networks(backend: BackendInterface, app_client: EthAppClient) -> None:
+    response = app_client.clear_network_registry()
+    if response.status == StatusWord.INVALID_P1_P2:
+        pytest.skip("App built without the network registry")
+    assert response.status == StatusWord.OK
+
+    for chain_id in STORED_CHAINS:
+        name, ticker, icon = get_network_config(backend.device.type, chain_id)
+        app_client.provide_network_information(DynamicNetwork(name, ticker, chain_id, icon))
+
+
+def test_network_registry_clear_one(backend: BackendInterface):
+    app_client = EthAppClient(backend)
+
+    provide_networks(backend, app_client)
+
+    assert app_client.clear_network_registry(STORED_CHAINS[0]).status == StatusWord.OK
+    # already deleted
+    assert app_client.clear_network_registry(STORED_CHAINS[0]).status == StatusWord.REF_DATA_NOT_FOUND
+    # the other one is still stored
+    assert app_client.clear_network_registry(STORED_CHAINS[1]).status == StatusWord.OK
+
+
+def test_network_registry_clear_all(backend: BackendInterface):
+    app_client = EthAppClient(backend)
+
+    provide_networks(backend, app_client)
+
+    assert app_client.clear_network_registry().status == StatusWord.OK
+    for chain_id in STORED_CHAINS:
+        assert app_client.clear_network_registry(chain_id).status == StatusWord.REF_DATA_NOT_FOUND
+    # nothing left to delete is not an error
+    assert app_client.clear_network_registry().status == StatusWord.OK
+
+
+def test_network_registry_clear_invalid(backend: BackendInterface):
+    app_client = EthAppClient(backend)
+
+    provide_networks(backend, app_client)
+
+    assert app_client.clear_network_registry(0).status == StatusWord.INVALID_DATA
+    # nothing got deleted
+    for chain_id in STORED_CHAINS:
+        assert app_client.clear_network_registry(chain_id).status == StatusWord.OK
@@ -19,7 +19,7 @@ import client.response_parser as ResponseParser
 from client.client import EthAppClient, SignMode
 from client.status_word import StatusWord
 from client.dynamic_networks import DynamicNetwork
-from client.trusted_name import TrustedName, TrustedNameType, TrustedNameSource
+from client.trusted_name import TrustedName, TrustedNames, TrustedNameEntry, TrustedNameType, TrustedNameSource, Tag
 
 
 # Values used across all tests
@@ -395,3 +395,79 @@ def test_trusted_name_mab(scenario_navigator: NavigateWithScenario) -> None:
                              "chainId": CHAIN_ID,
                          }):
         scenario_navigator.review_approve(do_comparison=False)
+
+
+def test_trusted_name_bulk(scenario_navigator: NavigateWithScenario) -> None:
+    backend = scenario_navigator.backend
+    app_client = EthAppClient(backend)
+
+    entries = []
+    for idx in range(20):
+        entries.append(TrustedNameEntry(bytes([idx]) * 20,
+                                        f"name{idx}.eth",
+                                        tn_type=TrustedNameType.ACCOUNT,
+                                        tn_source=TrustedNameSource.ENS,
+                                        chain_id=CHAIN_ID))
+    entries.append(TrustedNameEntry(ADDR,
+                                    NAME,
+                                    tn_type=TrustedNameType.ACCOUNT,
+                                    tn_source=TrustedNameSource.ENS,
+                                    chain_id=CHAIN_ID))
+    app_client.provide_trusted_name(TrustedNames(entries, challenge=common(app_client)))
+
+    # send a TX so that the trusted names are freed and this does not trigger a false-positive when checking for
+    # memory leaks
+    with app_client.sign(BIP32_PATH,
+                         {
+                             "nonce": NONCE,
+                             "gasPrice": Web3.to_wei(GAS_PRICE, "gwei"),
+                             "gas": GAS_LIMIT,
+                             "to": ADDR,
+                             "value": Web3.to_wei(AMOUNT, "ether"),
+                             "chainId": CHAIN_ID,
+                         }):
+        scenario_navigator.review_approve(do_comparison=False)
+
+
+def test_trusted_name_bulk_invalid_entry(backend: BackendInterface) -> None:
+    app_client = EthAppClient(backend)
+
+    entries = [
+        TrustedNameEntry(ADDR,
+                         NAME,
+                         tn_type=TrustedNameType.ACCOUNT,
+                         tn_source=TrustedNameSource.ENS,
+                         chain_id=CHAIN_ID),
+        TrustedNameEntry(bytes(20),
+                         "Ledger.eth",
+                         tn_type=TrustedNameType.ACCOUNT,
+                         tn_source=TrustedNameSource.ENS,
+                         chain_id=CHAIN_ID),
+    ]
+    with pytest.raises(ExceptionRAPDU) as e:
+        app_client.provide_trusted_name(TrustedNames(entries, challenge=common(app_client)))
+    assert e.value.status == StatusWord.INVALID_DATA
+
+
+class VersionedTrustedNameEntry(TrustedNameEntry):
+    """
+    Entry carrying its own struct version, which is not one of the per-name fields
+    """
+    def serialize(self) -> bytes:
+        return self.serialize_field(Tag.STRUCT_VERSION, 3) + super().serialize()
+
+
+def test_trusted_name_bulk_entry_version(backend: BackendInterface) -> None:
+    app_client = EthAppClient(backend)
+
+    # would match any type, source and chain if it was accepted as a version 3 name
+    entries = [
+        VersionedTrustedNameEntry(ADDR,
+                                  "Ledger",
+                                  tn_type=TrustedNameType.CONTRACT,
+                                  tn_source=TrustedNameSource.ENS,
+                                  chain_id=CHAIN_ID),
+    ]
+    with pytest.raises(ExceptionRAPDU) as e:
+        app_client.provide_trusted_name(TrustedNames(entries, challenge=common(app_client)))
+    assert e.value.status == StatusWord.INVALID_DATA
@@ -0,0 +1,63 @@
+/**
+ * @file ledger_pki_mocks.c
+ * @brief Host implementations of the crypto primitives used by ledger_pki.c
+ *
+ * They are defined without the SDK headers, which may declare some of them inline. The hashing
+ * contexts only hold a running FNV-1a digest, deterministic enough to tell inputs apart.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#define FNV_OFFSET_BASIS 0x811c9dc5
+#define FNV_PRIME        0x01000193
+
+uint32_t cx_sha256_init_no_throw(uint32_t *hash_ctx) {
+    *hash_ctx = FNV_OFFSET_BASIS;
+    return 0;  // CX_OK
+}
+
+void hash_nbytes(const uint8_t *bytes_ptr, size_t n, uint32_t *hash_ctx) {
+    for (size_t i = 0; i < n; ++i) {
+        *hash_ctx = (*hash_ctx ^ bytes_ptr[i]) * FNV_PRIME;
+    }
+}
+
+void hash_byte(uint8_t byte, uint32_t *hash_ctx) {
+    hash_nbytes(&byte, 1, hash_ctx);
+}
+
+bool finalize_hash(const uint32_t *hash_ctx, uint8_t *out, size_t out_len) {
+    for (size_t i = 0; i < out_len; ++i) {
+        out[i] = (uint8_t) (*hash_ctx >> ((i % 4) * 8)) ^ (uint8_t) i;
+    }
+    return true;
+}
+
+uint32_t cx_ecfp_init_public_key_no_throw(int curve,
+                                          const uint8_t *rawkey,
+                                          size_t key_len,
+                                          void *pukey) {
+    (void) curve;
+    (void) rawkey;
+    (void) key_len;
+    (void) pukey;
+    return 0;  // CX_OK
+}
+
+/**
+ * @brief Legacy path, only taken without a certificate
+ */
+bool cx_ecdsa_verify_no_throw(const void *pukey,
+                              const uint8_t *hash,
+                              size_t hash_len,
+                              const uint8_t *sig,
+                              size_t sig_len) {
+    (void) pukey;
+    (void) hash;
+    (void) hash_len;
+    (void) sig;
+    (void) sig_len;
+    return true;
+}
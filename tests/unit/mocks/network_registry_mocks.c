@@ -0,0 +1,53 @@
+/**
+ * @file network_registry_mocks.c
+ * @brief Host implementations of the crypto primitives used by network_registry.c
+ *
+ * They are defined without the SDK headers, which may declare some of them inline.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+uint32_t cx_crc32_update(uint32_t crc_state, const void *buf, size_t len) {
+    const uint8_t *bytes = buf;
+
+    crc_state = ~crc_state;
+    for (size_t i = 0; i < len; ++i) {
+        crc_state ^= bytes[i];
+        for (uint8_t bit = 0; bit < 8; ++bit) {
+            crc_state = (crc_state >> 1) ^ (0xedb88320 & (0 - (crc_state & 1)));
+        }
+    }
+    return ~crc_state;
+}
+
+uint32_t cx_crc32(const void *buf, size_t len) {
+    return cx_crc32_update(0, buf, len);
+}
+
+/**
+ * @brief Not a SHA-256, only a digest deterministic enough to compare icons
+ */
+static void fake_digest(const uint8_t *in, size_t in_len, uint8_t *digest) {
+    for (uint8_t i = 0; i < 32; ++i) {
+        digest[i] = (uint8_t) (cx_crc32(in, in_len) >> ((i % 4) * 8)) ^ i;
+    }
+}
+
+typedef struct {
+    const uint8_t *iov_base;
+    size_t iov_len;
+} s_iovec;
+
+uint32_t cx_sha256_hash_iovec(const s_iovec *iovec, size_t iovec_len, uint8_t *digest) {
+    if (iovec_len != 1) {
+        return 1;
+    }
+    fake_digest(iovec->iov_base, iovec->iov_len, digest);
+    return 0;  // CX_OK
+}
+
+uint32_t cx_sha256_hash(const uint8_t *in, size_t in_len, uint8_t *digest) {
+    fake_digest(in, in_len, digest);
+    return 0;  // CX_OK
+}
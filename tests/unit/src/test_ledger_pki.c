@@ -0,0 +1,162 @@
+/**
+ * @file test_ledger_pki.c
+ * @brief Unit tests for the cache of the descriptor signature verifications
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Includes
+#include "public_keys.h"
+
+// Headers for mocked functions
+#include "os_pki.h"
+#include "ledger_pki.h"
+
+// certificate loaded by the host
+static bool g_cert_loaded;
+static uint8_t g_cert_key_byte;
+
+static unsigned int g_pki_checks;
+
+static uint8_t g_desc_hash[CX_SHA256_SIZE] = {0xde, 0x5c};
+static const uint8_t g_desc_sig[] = {0x30, 0x44, 0x02, 0x20};
+
+// =============================================================================
+// Mock functions
+// =============================================================================
+
+/**
+ * @brief Mock implementation of os_pki_get_info
+ */
+bolos_err_t os_pki_get_info(uint8_t *key_usage,
+                            uint8_t *trusted_name,
+                            size_t *trusted_name_len,
+                            cx_ecfp_384_public_key_t *public_key) {
+    if (!g_cert_loaded) {
+        return 0x422f;
+    }
+    *key_usage = CERTIFICATE_PUBLIC_KEY_USAGE_TRUSTED_NAME;
+    memcpy(trusted_name, "test", 4);
+    *trusted_name_len = 4;
+    public_key->W_len = 65;
+    memset(public_key->W, g_cert_key_byte, public_key->W_len);
+    return 0;
+}
+
+/**
+ * @brief Mock implementation of check_signature_with_pki, counting the verifications
+ */
+check_signature_with_pki_status_t check_signature_with_pki(const buffer_t buffer,
+                                                           const uint8_t *expected_key_usage,
+                                                           const cx_curve_t *expected_curve,
+                                                           const buffer_t signature) {
+    (void) buffer;
+    (void) expected_key_usage;
+    (void) expected_curve;
+    (void) signature;
+    g_pki_checks += 1;
+    if (!g_cert_loaded) {
+        return CHECK_SIGNATURE_WITH_PKI_MISSING_CERTIFICATE;
+    }
+    return CHECK_SIGNATURE_WITH_PKI_SUCCESS;
+}
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static void load_cert(uint8_t key_byte) {
+    g_cert_loaded = true;
+    g_cert_key_byte = key_byte;
+}
+
+/**
+ * @brief Verify the signed descriptor, the way a PROVIDE_* handler does
+ */
+static void verify_descriptor(void) {
+    assert_true(check_signature_with_pubkey(g_desc_hash,
+                                            sizeof(g_desc_hash),
+                                            NULL,
+                                            0,
+                                            CERTIFICATE_PUBLIC_KEY_USAGE_TRUSTED_NAME,
+                                            g_desc_sig,
+                                            sizeof(g_desc_sig)));
+}
+
+static int setup(void **state) {
+    (void) state;
+    sig_cache_clear();
+    load_cert(0x04);
+    g_pki_checks = 0;
+    return 0;
+}
+
+// =============================================================================
+// Test cases
+// =============================================================================
+
+/**
+ * @brief An identical descriptor is only verified once
+ */
+static void test_cached(void **state) {
+    (void) state;
+
+    verify_descriptor();
+    verify_descriptor();
+    assert_int_equal(g_pki_checks, 1);
+
+    // another one is not mistaken for it
+    g_desc_hash[CX_SHA256_SIZE - 1] ^= 0x01;
+    verify_descriptor();
+    g_desc_hash[CX_SHA256_SIZE - 1] ^= 0x01;
+    assert_int_equal(g_pki_checks, 2);
+}
+
+/**
+ * @brief Loading another certificate flushes the cache, as does unloading it
+ */
+static void test_changed_certificate(void **state) {
+    (void) state;
+
+    verify_descriptor();
+    load_cert(0x05);
+    verify_descriptor();
+    assert_int_equal(g_pki_checks, 2);
+
+    g_cert_loaded = false;
+    verify_descriptor();
+    assert_int_equal(g_pki_checks, 3);
+}
+
+/**
+ * @brief Reloading the very same certificate keeps the cache
+ */
+static void test_identical_reload(void **state) {
+    (void) state;
+
+    verify_descriptor();
+    g_cert_loaded = false;
+    load_cert(0x04);
+    verify_descriptor();
+    assert_int_equal(g_pki_checks, 1);
+}
+
+// =============================================================================
+// Test runner
+// =============================================================================
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_cached, setup),
+        cmocka_unit_test_setup(test_changed_certificate, setup),
+        cmocka_unit_test_setup(test_identical_reload, setup),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
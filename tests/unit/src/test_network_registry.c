@@ -0,0 +1,277 @@
+/**
+ * @file test_network_registry.c
+ * @brief Unit tests for the dynamic networks persisted in NVM
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+// Includes
+#include "network_registry.h"
+#include "network_info.h"
+
+// Headers for mocked functions
+#include "os_nvm.h"
+#include "public_keys.h"
+
+#define CHAIN_ID_A 1337
+#define CHAIN_ID_B 4242
+
+network_info_t *g_dynamic_network_list = NULL;
+
+// certificate loaded by the host
+static bool g_cert_loaded;
+static uint8_t g_cert_key_usage;
+static uint8_t g_cert_fingerprint[CX_SHA256_SIZE];
+
+static unsigned int g_nvm_writes;
+static uint8_t *g_last_nvm_write;
+
+static const uint8_t g_desc_hash[CX_SHA256_SIZE] = {0xde, 0x5c};
+static const uint8_t g_no_icon_hash[CX_SHA256_SIZE] = {0};
+
+// =============================================================================
+// Mock functions
+// =============================================================================
+
+/**
+ * @brief Mock implementation of nvm_write, the registry lives in the read-only data on the host
+ */
+void nvm_write(void *dst_adr, void *src_adr, unsigned int src_len) {
+    uintptr_t page_size = (uintptr_t) sysconf(_SC_PAGESIZE);
+    uintptr_t start = (uintptr_t) dst_adr & ~(page_size - 1);
+    uintptr_t end = (uintptr_t) dst_adr + src_len;
+
+    assert_int_equal(mprotect((void *) start, end - start, PROT_READ | PROT_WRITE), 0);
+    if (src_adr == NULL) {
+        memset(dst_adr, 0, src_len);
+    } else {
+        memcpy(dst_adr, src_adr, src_len);
+    }
+    g_nvm_writes += 1;
+    g_last_nvm_write = dst_adr;
+}
+
+/**
+ * @brief Mock implementation of get_pki_cert_fingerprint
+ */
+bool get_pki_cert_fingerprint(uint8_t *key_usage, uint8_t *fingerprint) {
+    if (!g_cert_loaded) {
+        *key_usage = 0;
+        memset(fingerprint, 0, CX_SHA256_SIZE);
+        return false;
+    }
+    *key_usage = g_cert_key_usage;
+    memcpy(fingerprint, g_cert_fingerprint, CX_SHA256_SIZE);
+    return true;
+}
+
+/**
+ * @brief Mock implementation of find_dynamic_network_by_chain_id
+ */
+network_info_t *find_dynamic_network_by_chain_id(uint64_t chain_id) {
+    for (flist_node_t *node = (flist_node_t *) g_dynamic_network_list; node != NULL;
+         node = node->next) {
+        if (((network_info_t *) node)->chain_id == chain_id) {
+            return (network_info_t *) node;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Mock implementation of network_info_cleanup
+ */
+void network_info_cleanup(network_info_t *network) {
+    if (network == NULL) {
+        while (g_dynamic_network_list != NULL) {
+            network_info_cleanup(g_dynamic_network_list);
+        }
+        return;
+    }
+    flist_remove((flist_node_t **) &g_dynamic_network_list, (flist_node_t *) network, NULL);
+    free(network);
+}
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static void load_cert(uint8_t key_usage, uint8_t fingerprint_byte) {
+    g_cert_loaded = true;
+    g_cert_key_usage = key_usage;
+    memset(g_cert_fingerprint, fingerprint_byte, sizeof(g_cert_fingerprint));
+}
+
+/**
+ * @brief Store a network the way a verified PROVIDE_NETWORK_INFO does
+ */
+static void store_network(uint64_t chain_id, const char *name) {
+    network_info_t network = {0};
+
+    network.chain_id = chain_id;
+    strncpy(network.name, name, sizeof(network.name) - 1);
+    strncpy(network.ticker, "TKN", sizeof(network.ticker) - 1);
+    assert_true(network_registry_store(&network, g_no_icon_hash, g_desc_hash));
+}
+
+/**
+ * @brief Start the app again, with no certificate loaded and no network in RAM
+ */
+static void restart_app(void) {
+    network_info_cleanup(NULL);
+    g_cert_loaded = false;
+    network_registry_load();
+}
+
+static int setup(void **state) {
+    (void) state;
+    network_registry_delete(0);
+    network_info_cleanup(NULL);
+    load_cert(CERTIFICATE_PUBLIC_KEY_USAGE_NETWORK, 0xf1);
+    g_nvm_writes = 0;
+    return 0;
+}
+
+// =============================================================================
+// Test cases
+// =============================================================================
+
+/**
+ * @brief A stored network is restored at the next start
+ */
+static void test_round_trip(void **state) {
+    (void) state;
+    network_info_t *network;
+
+    store_network(CHAIN_ID_A, "Network A");
+    restart_app();
+
+    network = find_dynamic_network_by_chain_id(CHAIN_ID_A);
+    assert_non_null(network);
+    assert_string_equal(network->name, "Network A");
+    assert_string_equal(network->ticker, "TKN");
+    assert_null(network->icon.bitmap);
+}
+
+/**
+ * @brief The very same descriptor is not written again
+ */
+static void test_same_descriptor(void **state) {
+    (void) state;
+
+    store_network(CHAIN_ID_A, "Network A");
+    assert_int_equal(g_nvm_writes, 1);
+    store_network(CHAIN_ID_A, "Network A");
+    assert_int_equal(g_nvm_writes, 1);
+}
+
+/**
+ * @brief Deleted networks are not trusted anymore, right away and after a restart
+ */
+static void test_clear(void **state) {
+    (void) state;
+
+    store_network(CHAIN_ID_A, "Network A");
+    store_network(CHAIN_ID_B, "Network B");
+    restart_app();
+    assert_non_null(find_dynamic_network_by_chain_id(CHAIN_ID_A));
+
+    assert_true(network_registry_delete(CHAIN_ID_A));
+    assert_null(find_dynamic_network_by_chain_id(CHAIN_ID_A));
+    assert_non_null(find_dynamic_network_by_chain_id(CHAIN_ID_B));
+    assert_false(network_registry_delete(CHAIN_ID_A));
+
+    restart_app();
+    assert_null(find_dynamic_network_by_chain_id(CHAIN_ID_A));
+    assert_non_null(find_dynamic_network_by_chain_id(CHAIN_ID_B));
+
+    assert_true(network_registry_delete(0));
+    assert_null(g_dynamic_network_list);
+    restart_app();
+    assert_null(g_dynamic_network_list);
+}
+
+/**
+ * @brief A corrupted entry is dropped when loaded
+ */
+static void test_corrupted_entry(void **state) {
+    (void) state;
+
+    store_network(CHAIN_ID_A, "Network A");
+    store_network(CHAIN_ID_B, "Network B");
+    // the name follows the chain ID in the last written entry
+    g_last_nvm_write[sizeof(uint64_t)] ^= 0x20;
+    restart_app();
+
+    assert_non_null(find_dynamic_network_by_chain_id(CHAIN_ID_A));
+    assert_null(find_dynamic_network_by_chain_id(CHAIN_ID_B));
+    // and erased
+    assert_false(network_registry_delete(CHAIN_ID_B));
+}
+
+/**
+ * @brief The entries verified with another certificate are dropped once it is seen
+ */
+static void test_other_certificate(void **state) {
+    (void) state;
+
+    store_network(CHAIN_ID_A, "Network A");
+    // the provenance is unknown until the host loads a certificate
+    restart_app();
+    assert_non_null(find_dynamic_network_by_chain_id(CHAIN_ID_A));
+
+    // a certificate for another usage does not tell anything either
+    network_info_cleanup(NULL);
+    load_cert(CERTIFICATE_PUBLIC_KEY_USAGE_TRUSTED_NAME, 0xf2);
+    network_registry_load();
+    assert_non_null(find_dynamic_network_by_chain_id(CHAIN_ID_A));
+
+    network_info_cleanup(NULL);
+    load_cert(CERTIFICATE_PUBLIC_KEY_USAGE_NETWORK, 0xf2);
+    network_registry_load();
+    assert_null(find_dynamic_network_by_chain_id(CHAIN_ID_A));
+    assert_false(network_registry_delete(CHAIN_ID_A));
+}
+
+/**
+ * @brief Storing a network verified with a new certificate drops the ones of the previous one
+ */
+static void test_certificate_rotation(void **state) {
+    (void) state;
+
+    store_network(CHAIN_ID_A, "Network A");
+    restart_app();
+    load_cert(CERTIFICATE_PUBLIC_KEY_USAGE_NETWORK, 0xf2);
+    store_network(CHAIN_ID_B, "Network B");
+
+    assert_null(find_dynamic_network_by_chain_id(CHAIN_ID_A));
+    restart_app();
+    assert_null(find_dynamic_network_by_chain_id(CHAIN_ID_A));
+    assert_non_null(find_dynamic_network_by_chain_id(CHAIN_ID_B));
+}
+
+// =============================================================================
+// Test runner
+// =============================================================================
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_round_trip, setup),
+        cmocka_unit_test_setup(test_same_descriptor, setup),
+        cmocka_unit_test_setup(test_clear, setup),
+        cmocka_unit_test_setup(test_corrupted_entry, setup),
+        cmocka_unit_test_setup(test_other_certificate, setup),
+        cmocka_unit_test_setup(test_certificate_rotation, setup),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
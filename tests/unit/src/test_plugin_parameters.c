@@ -0,0 +1,239 @@
+/**
+ * @file test_plugin_parameters.c
+ * @brief Unit tests for the batched calldata parameters given to the plugins
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Includes
+#include "shared_context.h"
+#include "plugin_parameters.h"
+
+// Headers for mocked functions
+#include "eth_plugin_handler.h"
+
+dataContext_t dataContext;
+pluginType_t pluginType;
+
+static uint8_t g_apdu[255];
+
+// =============================================================================
+// Mock functions
+// =============================================================================
+
+/**
+ * @brief Mock implementation of eth_plugin_prepare_provide_parameters
+ */
+void eth_plugin_prepare_provide_parameters(ethPluginProvideParameters_t *provide_parameters,
+                                           const uint8_t *parameters,
+                                           uint32_t parameters_offset,
+                                           uint32_t parameters_length) {
+    memset(provide_parameters, 0, sizeof(*provide_parameters));
+    provide_parameters->parameters = parameters;
+    provide_parameters->parametersOffset = parameters_offset;
+    provide_parameters->parametersLength = parameters_length;
+}
+
+/**
+ * @brief Mock implementation of eth_plugin_call
+ */
+eth_plugin_result_t eth_plugin_call(int method, void *parameter) {
+    const ethPluginProvideParameters_t *provide_parameters = parameter;
+    const uint8_t *parameters = provide_parameters->parameters;
+    uint32_t offset = provide_parameters->parametersOffset;
+    uint32_t length = provide_parameters->parametersLength;
+
+    check_expected(method);
+    check_expected_ptr(parameters);
+    check_expected(offset);
+    check_expected(length);
+    return (eth_plugin_result_t) mock();
+}
+
+/**
+ * @brief Mock implementation of copy_tx_data, only consumes the data
+ */
+bool copy_tx_data(txContext_t *context, uint8_t *out, uint32_t length) {
+    assert_null(out);
+    assert_true(length <= context->commandLength);
+    context->workBuffer += length;
+    context->commandLength -= length;
+    context->currentFieldPos += length;
+    return true;
+}
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+/**
+ * @brief Set up a calldata field, with the APDU holding the given amount of it
+ */
+static void setup_context(txContext_t *context,
+                          uint32_t field_length,
+                          uint32_t field_pos,
+                          uint32_t command_length) {
+    memset(context, 0, sizeof(*context));
+    memset(&dataContext, 0, sizeof(dataContext));
+    context->currentField = 1;
+    context->processingField = true;
+    context->currentFieldLength = field_length;
+    context->currentFieldPos = field_pos;
+    context->workBuffer = g_apdu;
+    context->commandLength = command_length;
+    dataContext.tokenContext.fieldIndex =
+        (field_pos - CALLDATA_SELECTOR_SIZE) / CALLDATA_CHUNK_SIZE;
+    dataContext.tokenContext.pluginBatching = true;
+}
+
+static void expect_plugin_call(uint32_t offset, uint32_t length, eth_plugin_result_t result) {
+    expect_value(eth_plugin_call, method, ETH_PLUGIN_PROVIDE_PARAMETERS);
+    expect_value(eth_plugin_call, parameters, g_apdu);
+    expect_value(eth_plugin_call, offset, offset);
+    expect_value(eth_plugin_call, length, length);
+    will_return(eth_plugin_call, result);
+}
+
+// =============================================================================
+// Test cases
+// =============================================================================
+
+/**
+ * @brief All the complete parameters of the APDU are given at once
+ */
+static void test_batch_provided(void **state) {
+    (void) state;
+    txContext_t context;
+
+    // 1 parameter already received, 7 bytes more than 3 parameters in the APDU
+    setup_context(&context, 4 + 10 * 32, 4 + 32, 3 * 32 + 7);
+    expect_plugin_call(4 + 32, 3 * 32, ETH_PLUGIN_RESULT_OK);
+
+    assert_int_equal(provide_plugin_parameters(&context), CUSTOM_HANDLED);
+    assert_int_equal(dataContext.tokenContext.fieldIndex, 4);
+    assert_int_equal(context.currentFieldPos, 4 + 4 * 32);
+    assert_int_equal(context.commandLength, 7);
+    assert_true(context.processingField);
+    assert_true(dataContext.tokenContext.pluginBatching);
+}
+
+/**
+ * @brief The field is done once its last parameters are given
+ */
+static void test_batch_end_of_field(void **state) {
+    (void) state;
+    txContext_t context;
+
+    setup_context(&context, 4 + 3 * 32, 4, 200);
+    expect_plugin_call(4, 3 * 32, ETH_PLUGIN_RESULT_OK);
+
+    assert_int_equal(provide_plugin_parameters(&context), CUSTOM_HANDLED);
+    assert_int_equal(context.currentField, 2);
+    assert_false(context.processingField);
+}
+
+/**
+ * @brief A plugin declining the message gets the parameters one by one from then on
+ */
+static void test_probe_fallback(void **state) {
+    (void) state;
+    txContext_t context;
+
+    setup_context(&context, 4 + 10 * 32, 4, 4 * 32);
+    expect_plugin_call(4, 4 * 32, ETH_PLUGIN_RESULT_UNAVAILABLE);
+
+    assert_int_equal(provide_plugin_parameters(&context), CUSTOM_NOT_HANDLED);
+    assert_false(dataContext.tokenContext.pluginBatching);
+    // nothing consumed, left to the per-parameter path
+    assert_int_equal(context.currentFieldPos, 4);
+    assert_int_equal(context.commandLength, 4 * 32);
+    assert_int_equal(dataContext.tokenContext.fieldIndex, 0);
+}
+
+/**
+ * @brief A plugin answering with a fallback gets the parameters one by one as well
+ */
+static void test_fallback_result(void **state) {
+    (void) state;
+    txContext_t context;
+
+    setup_context(&context, 4 + 10 * 32, 4 + 32, 2 * 32);
+    expect_plugin_call(4 + 32, 2 * 32, ETH_PLUGIN_RESULT_FALLBACK);
+
+    assert_int_equal(provide_plugin_parameters(&context), CUSTOM_NOT_HANDLED);
+    assert_false(dataContext.tokenContext.pluginBatching);
+    assert_int_equal(context.currentFieldPos, 4 + 32);
+    assert_int_equal(context.commandLength, 2 * 32);
+    assert_int_equal(dataContext.tokenContext.fieldIndex, 1);
+}
+
+/**
+ * @brief A single parameter is not worth a batch, and does not count as a probe
+ */
+static void test_single_parameter(void **state) {
+    (void) state;
+    txContext_t context;
+
+    setup_context(&context, 4 + 10 * 32, 4, 32 + 31);
+
+    assert_int_equal(provide_plugin_parameters(&context), CUSTOM_NOT_HANDLED);
+    assert_true(dataContext.tokenContext.pluginBatching);
+    assert_int_equal(context.currentFieldPos, 4);
+}
+
+/**
+ * @brief A plugin error aborts the parsing
+ */
+static void test_plugin_error(void **state) {
+    (void) state;
+    txContext_t context;
+
+    setup_context(&context, 4 + 10 * 32, 4, 2 * 32);
+    expect_plugin_call(4, 2 * 32, ETH_PLUGIN_RESULT_ERROR);
+
+    assert_int_equal(provide_plugin_parameters(&context), CUSTOM_FAULT);
+}
+
+/**
+ * @brief Only the external plugins opting in at init receive batches
+ */
+static void test_opt_in(void **state) {
+    (void) state;
+    ethPluginInitContract_t init = {0};
+
+    pluginType = PLUGIN_TYPE_EXTERNAL;
+    init.interfaceVersion = ETH_PLUGIN_PROVIDE_PARAMETERS_OPT_IN;
+    assert_true(plugin_batching_enabled(&init));
+
+    // left untouched by the plugin
+    init.interfaceVersion = ETH_PLUGIN_INTERFACE_VERSION_LATEST;
+    assert_false(plugin_batching_enabled(&init));
+
+    pluginType = PLUGIN_TYPE_ERC721;
+    init.interfaceVersion = ETH_PLUGIN_PROVIDE_PARAMETERS_OPT_IN;
+    assert_false(plugin_batching_enabled(&init));
+}
+
+// =============================================================================
+// Test runner
+// =============================================================================
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_batch_provided),
+        cmocka_unit_test(test_batch_end_of_field),
+        cmocka_unit_test(test_probe_fallback),
+        cmocka_unit_test(test_fallback_result),
+        cmocka_unit_test(test_single_parameter),
+        cmocka_unit_test(test_plugin_error),
+        cmocka_unit_test(test_opt_in),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
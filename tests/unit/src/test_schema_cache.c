@@ -0,0 +1,205 @@
+/**
+ * @file test_schema_cache.c
+ * @brief Unit tests for the EIP-712 schemas kept across signing sessions
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Includes
+#include "schema_cache.h"
+#include "context_712.h"
+#include "apdu_constants.h"
+
+// Headers for mocked functions
+#include "schema_hash.h"
+#include "typed_data.h"
+
+#define SCHEMA_A 0xaa
+#define SCHEMA_B 0xbb
+#define SCHEMA_C 0xcc
+
+s_eip712_context *eip712_context = NULL;
+uint16_t apdu_response_code;
+
+static s_eip712_context g_context;
+// hash of the schema recorded next
+static uint8_t g_next_schema;
+// struct definitions loaded from the cache, "N" for names and "F" for fields
+static char g_loaded[256];
+static size_t g_loaded_length;
+
+// =============================================================================
+// Mock functions
+// =============================================================================
+
+/**
+ * @brief Mock implementation of compute_schema_hash
+ */
+bool compute_schema_hash(void) {
+    memset(eip712_context->schema_hash, g_next_schema, sizeof(eip712_context->schema_hash));
+    return true;
+}
+
+/**
+ * @brief Mock implementation of get_struct_list, no struct is ever defined
+ */
+const s_struct_712 *get_struct_list(void) {
+    return NULL;
+}
+
+static bool log_def(char kind, uint8_t length, const uint8_t *data) {
+    int ret = snprintf(&g_loaded[g_loaded_length],
+                       sizeof(g_loaded) - g_loaded_length,
+                       "%c%.*s;",
+                       kind,
+                       length,
+                       data);
+
+    assert_true((ret > 0) && ((size_t) ret < (sizeof(g_loaded) - g_loaded_length)));
+    g_loaded_length += ret;
+    return true;
+}
+
+/**
+ * @brief Mock implementation of set_struct_name
+ */
+bool set_struct_name(uint8_t length, const uint8_t *name) {
+    return log_def('N', length, name);
+}
+
+/**
+ * @brief Mock implementation of set_struct_field
+ */
+bool set_struct_field(uint8_t length, const uint8_t *data) {
+    return log_def('F', length, data);
+}
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+/**
+ * @brief Go through the struct definitions of a session, as sent by the client
+ */
+static void define_schema(uint8_t schema, const char *name, const char *field) {
+    schema_cache_record_def(0x00, (const uint8_t *) name, strlen(name));
+    schema_cache_record_def(0xff, (const uint8_t *) field, strlen(field));
+    g_next_schema = schema;
+    schema_cache_store();
+}
+
+/**
+ * @brief Load a cached schema, then end the session
+ */
+static bool load_schema(uint8_t schema) {
+    uint8_t hash[CX_SHA224_SIZE];
+    bool ret;
+
+    memset(hash, schema, sizeof(hash));
+    g_loaded_length = 0;
+    g_loaded[0] = '\0';
+    ret = schema_cache_load(hash, sizeof(hash));
+    schema_cache_discard_recording();
+    return ret;
+}
+
+static int setup(void **state) {
+    (void) state;
+    schema_cache_clear();
+    eip712_context = &g_context;
+    return 0;
+}
+
+// =============================================================================
+// Test cases
+// =============================================================================
+
+/**
+ * @brief The struct definitions come back in the order they were received
+ */
+static void test_round_trip(void **state) {
+    (void) state;
+
+    define_schema(SCHEMA_A, "Mail", "from");
+    define_schema(SCHEMA_B, "Person", "name");
+
+    assert_true(load_schema(SCHEMA_A));
+    assert_string_equal(g_loaded, "NMail;Ffrom;");
+    assert_true(load_schema(SCHEMA_B));
+    assert_string_equal(g_loaded, "NPerson;Fname;");
+    assert_false(load_schema(SCHEMA_C));
+    assert_int_equal(apdu_response_code, SWO_REFERENCED_DATA_NOT_FOUND);
+}
+
+/**
+ * @brief The least recently used schema makes room for a new one
+ */
+static void test_lru_eviction(void **state) {
+    (void) state;
+
+    define_schema(SCHEMA_A, "A", "a");
+    define_schema(SCHEMA_B, "B", "b");
+    assert_true(load_schema(SCHEMA_A));
+    define_schema(SCHEMA_C, "C", "c");
+
+    assert_true(load_schema(SCHEMA_A));
+    assert_false(load_schema(SCHEMA_B));
+    assert_true(load_schema(SCHEMA_C));
+}
+
+/**
+ * @brief The most recently used schema is still kept once the use counter would have wrapped
+ */
+static void test_use_count_wrap(void **state) {
+    (void) state;
+
+    define_schema(SCHEMA_A, "A", "a");
+    define_schema(SCHEMA_B, "B", "b");
+    for (uint32_t i = 0; i <= UINT16_MAX; ++i) {
+        assert_true(load_schema(SCHEMA_A));
+    }
+    define_schema(SCHEMA_C, "C", "c");
+
+    assert_true(load_schema(SCHEMA_A));
+    assert_false(load_schema(SCHEMA_B));
+    assert_true(load_schema(SCHEMA_C));
+}
+
+/**
+ * @brief A schema too big for its reserved entry is not cached
+ */
+static void test_too_big(void **state) {
+    (void) state;
+    uint8_t field[UINT8_MAX];
+
+    memset(field, 'f', sizeof(field));
+    for (uint8_t i = 0; i < 5; ++i) {
+        schema_cache_record_def(0xff, field, sizeof(field));
+    }
+    g_next_schema = SCHEMA_A;
+    schema_cache_store();
+
+    assert_false(load_schema(SCHEMA_A));
+}
+
+// =============================================================================
+// Test runner
+// =============================================================================
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_round_trip, setup),
+        cmocka_unit_test_setup(test_lru_eviction, setup),
+        cmocka_unit_test_setup(test_use_count_wrap, setup),
+        cmocka_unit_test_setup(test_too_big, setup),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,209 @@
+/**
+ * @file test_tlv_apdu.c
+ * @brief Unit tests for the streaming TLV reception over APDUs
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Includes
+#include "tlv_apdu.h"
+
+#define ELEMENTS_COUNT 12
+#define MAX_CHUNK_SIZE 255
+
+typedef struct {
+    uint8_t count;
+    uint32_t tags[ELEMENTS_COUNT];
+    uint16_t sizes[ELEMENTS_COUNT];
+    bool fail;
+} s_test_ctx;
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static size_t der_encode(uint8_t *out, uint16_t value) {
+    if (value < 0x80) {
+        out[0] = value;
+        return 1;
+    }
+    if (value <= UINT8_MAX) {
+        out[0] = 0x81;
+        out[1] = value;
+        return 2;
+    }
+    out[0] = 0x82;
+    out[1] = value >> 8;
+    out[2] = value & 0xff;
+    return 3;
+}
+
+static uint16_t element_value_size(uint8_t idx) {
+    return (idx * 61) % 300;
+}
+
+static uint8_t element_tag(uint8_t idx) {
+    return (idx * 23) % UINT8_MAX;
+}
+
+/**
+ * @brief Build a payload with the 2-byte size prefix, with elements of various sizes
+ */
+static size_t build_payload(uint8_t *out) {
+    size_t off = 2;
+    uint16_t value_size;
+
+    for (uint8_t idx = 0; idx < ELEMENTS_COUNT; ++idx) {
+        value_size = element_value_size(idx);
+        off += der_encode(&out[off], element_tag(idx));
+        off += der_encode(&out[off], value_size);
+        for (uint16_t i = 0; i < value_size; ++i) {
+            out[off++] = (uint8_t) (idx + i);
+        }
+    }
+    out[0] = (off - 2) >> 8;
+    out[1] = (off - 2) & 0xff;
+    return off;
+}
+
+static bool element_handler(const tlv_data_t *data, void *context) {
+    s_test_ctx *ctx = context;
+
+    if (ctx->fail || (ctx->count == ELEMENTS_COUNT)) {
+        return false;
+    }
+    for (uint16_t i = 0; i < data->value.size; ++i) {
+        if (data->value.ptr[i] != (uint8_t) (ctx->count + i)) {
+            return false;
+        }
+    }
+    if (data->raw.size <= data->value.size) {
+        return false;
+    }
+    ctx->tags[ctx->count] = data->tag;
+    ctx->sizes[ctx->count] = data->value.size;
+    ctx->count += 1;
+    return true;
+}
+
+static e_tlv_apdu_ret send_in_chunks(const uint8_t *payload,
+                                     size_t size,
+                                     uint8_t chunk_size,
+                                     s_test_ctx *ctx) {
+    e_tlv_apdu_ret ret = TLV_APDU_ERROR;
+    size_t off = 0;
+    uint8_t len;
+
+    while (off < size) {
+        len = ((size - off) < chunk_size) ? (size - off) : chunk_size;
+        ret = tlv_stream_from_apdu(off == 0, len, &payload[off], &element_handler, ctx);
+        off += len;
+        if ((off < size) && (ret != TLV_APDU_PENDING)) {
+            return TLV_APDU_ERROR;
+        }
+    }
+    return ret;
+}
+
+// =============================================================================
+// Test cases
+// =============================================================================
+
+/**
+ * @brief Every element is received intact, whatever the chunking
+ */
+static void test_stream_all_chunk_sizes(void **state) {
+    (void) state;
+    uint8_t payload[4096];
+    size_t size = build_payload(payload);
+
+    // the first chunk has to at least contain the payload size
+    for (uint16_t chunk_size = 2; chunk_size <= MAX_CHUNK_SIZE; ++chunk_size) {
+        s_test_ctx ctx = {0};
+
+        assert_int_equal(send_in_chunks(payload, size, chunk_size, &ctx), TLV_APDU_SUCCESS);
+        assert_int_equal(ctx.count, ELEMENTS_COUNT);
+        for (uint8_t idx = 0; idx < ELEMENTS_COUNT; ++idx) {
+            assert_int_equal(ctx.tags[idx], element_tag(idx));
+            assert_int_equal(ctx.sizes[idx], element_value_size(idx));
+        }
+    }
+}
+
+/**
+ * @brief A handler failure aborts the reception
+ */
+static void test_stream_handler_error(void **state) {
+    (void) state;
+    uint8_t payload[4096];
+    size_t size = build_payload(payload);
+    s_test_ctx ctx = {.fail = true};
+
+    assert_int_equal(send_in_chunks(payload, size, MAX_CHUNK_SIZE, &ctx), TLV_APDU_ERROR);
+    assert_int_equal(ctx.count, 0);
+}
+
+/**
+ * @brief An element going past the announced payload size is rejected
+ */
+static void test_stream_truncated_element(void **state) {
+    (void) state;
+    // size: 4, tag 0x01, length 0x10 but only 2 bytes of value
+    const uint8_t payload[] = {0x00, 0x04, 0x01, 0x10, 0xaa, 0xbb};
+    s_test_ctx ctx = {0};
+
+    assert_int_equal(tlv_stream_from_apdu(true, sizeof(payload), payload, &element_handler, &ctx),
+                     TLV_APDU_ERROR);
+    assert_int_equal(ctx.count, 0);
+}
+
+/**
+ * @brief A following chunk with a different handler context is rejected
+ */
+static void test_stream_context_mismatch(void **state) {
+    (void) state;
+    uint8_t payload[4096];
+    size_t size = build_payload(payload);
+    s_test_ctx ctx = {0};
+    s_test_ctx other_ctx = {0};
+
+    // the second chunk must not be the last one, so that only the context can be rejected
+    assert_true(size > (64 + 64));
+    assert_int_equal(tlv_stream_from_apdu(true, 64, payload, &element_handler, &ctx),
+                     TLV_APDU_PENDING);
+    assert_int_equal(tlv_stream_from_apdu(false, 64, &payload[64], &element_handler, &other_ctx),
+                     TLV_APDU_ERROR);
+}
+
+/**
+ * @brief A new first chunk while a payload is still pending is rejected
+ */
+static void test_stream_remnants(void **state) {
+    (void) state;
+    uint8_t payload[4096];
+    s_test_ctx ctx = {0};
+
+    build_payload(payload);
+    assert_int_equal(tlv_stream_from_apdu(true, 64, payload, &element_handler, &ctx),
+                     TLV_APDU_PENDING);
+    assert_int_equal(tlv_stream_from_apdu(true, 64, payload, &element_handler, &ctx),
+                     TLV_APDU_ERROR);
+}
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_stream_all_chunk_sizes),
+        cmocka_unit_test(test_stream_handler_error),
+        cmocka_unit_test(test_stream_truncated_element),
+        cmocka_unit_test(test_stream_context_mismatch),
+        cmocka_unit_test(test_stream_remnants),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,194 @@
+/**
+ * @file test_typed_data.c
+ * @brief Unit tests for the EIP-712 struct definitions storage
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Includes
+#include "typed_data.h"
+#include "context_712.h"
+#include "apdu_constants.h"
+
+// Headers for mocked functions
+#include "sol_typenames.h"
+
+uint16_t apdu_response_code;
+e_struct_init struct_state = NOT_INITIALIZED;
+
+// =============================================================================
+// Mock functions
+// =============================================================================
+
+/**
+ * @brief Mock implementation of get_struct_field_sol_typename
+ */
+const char *get_struct_field_sol_typename(const s_struct_712_field *field_ptr) {
+    (void) field_ptr;
+    return "uint";
+}
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+static void add_struct(const char *name) {
+    assert_true(set_struct_name(strlen(name), (const uint8_t *) name));
+}
+
+/**
+ * @brief Add a field of a custom type to the last struct
+ */
+static bool add_custom_field(const char *type_name, const char *key_name) {
+    uint8_t data[2 + 2 * UINT8_MAX];
+    uint8_t length = 0;
+
+    data[length++] = TYPE_CUSTOM;
+    data[length++] = strlen(type_name);
+    memcpy(&data[length], type_name, strlen(type_name));
+    length += strlen(type_name);
+    data[length++] = strlen(key_name);
+    memcpy(&data[length], key_name, strlen(key_name));
+    length += strlen(key_name);
+    return set_struct_field(length, data);
+}
+
+/**
+ * @brief Add a uint256 field to the last struct
+ */
+static void add_uint_field(const char *key_name) {
+    uint8_t data[3 + UINT8_MAX];
+    uint8_t length = 0;
+
+    data[length++] = TYPESIZE_MASK | TYPE_SOL_UINT;
+    data[length++] = 32;
+    data[length++] = strlen(key_name);
+    memcpy(&data[length], key_name, strlen(key_name));
+    length += strlen(key_name);
+    assert_true(set_struct_field(length, data));
+}
+
+static const s_struct_712 *find_struct(const char *name) {
+    return get_structn(name, strlen(name));
+}
+
+static int setup(void **state) {
+    (void) state;
+    typed_data_deinit();
+    struct_state = NOT_INITIALIZED;
+    return 0;
+}
+
+// =============================================================================
+// Test cases
+// =============================================================================
+
+/**
+ * @brief A field named after its own type, which is defined afterwards
+ */
+static void test_type_named_like_key(void **state) {
+    (void) state;
+    const s_struct_712 *bar;
+    const s_struct_712 *foo;
+    const s_struct_712_field *field;
+
+    add_struct("Bar");
+    assert_true(add_custom_field("Foo", "Foo"));
+    add_struct("Foo");
+    add_uint_field("x");
+
+    assert_non_null(bar = find_struct("Bar"));
+    assert_non_null(foo = find_struct("Foo"));
+    assert_non_null(field = get_struct_field_at(bar, 0));
+    assert_ptr_equal(get_struct_field_custom_struct(field), foo);
+    // stored only once
+    assert_ptr_equal(get_struct_field_keyname(field), get_struct_field_typename(field));
+    assert_ptr_equal(get_struct_field_keyname(field), get_struct_name(foo));
+}
+
+/**
+ * @brief A type defined before the field referring to it
+ */
+static void test_type_defined_first(void **state) {
+    (void) state;
+    const s_struct_712_field *field;
+
+    add_struct("Person");
+    add_uint_field("wallet");
+    add_struct("Mail");
+    assert_true(add_custom_field("Person", "from"));
+    assert_true(add_custom_field("Person", "to"));
+
+    field = get_struct_field_at(find_struct("Mail"), 0);
+    assert_ptr_equal(get_struct_field_custom_struct(field), find_struct("Person"));
+    field = get_next_struct_field(field);
+    assert_non_null(field);
+    assert_ptr_equal(get_struct_field_custom_struct(field), find_struct("Person"));
+    assert_string_equal(get_struct_field_keyname(field), "to");
+    assert_null(get_next_struct_field(field));
+}
+
+/**
+ * @brief Equal names share their storage, and prefixes are not mistaken for them
+ */
+static void test_interned_names(void **state) {
+    (void) state;
+    const s_struct_712_field *a;
+    const s_struct_712_field *b;
+
+    add_struct("A");
+    add_uint_field("value");
+    add_uint_field("val");
+    add_struct("B");
+    add_uint_field("value");
+
+    a = get_struct_field_at(find_struct("A"), 0);
+    b = get_struct_field_at(find_struct("B"), 0);
+    assert_ptr_equal(get_struct_field_keyname(a), get_struct_field_keyname(b));
+    assert_ptr_not_equal(get_struct_field_keyname(a),
+                         get_struct_field_keyname(get_next_struct_field(a)));
+    assert_string_equal(get_struct_field_keyname(get_next_struct_field(a)), "val");
+    assert_null(find_struct("Value"));
+    assert_null(find_struct("value"));
+}
+
+/**
+ * @brief The names of a rejected field are forgotten along with it
+ */
+static void test_rejected_field(void **state) {
+    (void) state;
+    const uint8_t trailing_byte[] = {TYPE_CUSTOM, 3, 'Q', 'u', 'x', 1, 'q', 0xff};
+    const s_struct_712_field *field;
+
+    add_struct("Main");
+    assert_false(set_struct_field(sizeof(trailing_byte), trailing_byte));
+    assert_int_equal(find_struct("Main")->field_count, 0);
+
+    assert_true(add_custom_field("Qux", "q"));
+    add_struct("Qux");
+    add_uint_field("n");
+    field = get_struct_field_at(find_struct("Main"), 0);
+    assert_ptr_equal(get_struct_field_custom_struct(field), find_struct("Qux"));
+    assert_string_equal(get_struct_name(find_struct("Qux")), "Qux");
+}
+
+// =============================================================================
+// Test runner
+// =============================================================================
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test_setup(test_type_named_like_key, setup),
+        cmocka_unit_test_setup(test_type_defined_first, setup),
+        cmocka_unit_test_setup(test_interned_names, setup),
+        cmocka_unit_test_setup(test_rejected_field, setup),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
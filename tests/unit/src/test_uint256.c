@@ -0,0 +1,649 @@
+/**
+ * @file test_uint256.c
+ * @brief Differential tests of the uint128/uint256 arithmetic against reference implementations
+ *
+ * Random operands, biased towards the edge cases, are split across all the cores. The uint128
+ * results are checked against the compiler 128-bit integers, the uint256 ones against a 32-bit
+ * limbs implementation, and the divisions through l == q * r + m with m < r.
+ *
+ * Environment:
+ * - UINT_TEST_ITERATIONS: operands per kernel (default 10000)
+ * - UINT_TEST_THREADS: number of threads (default or 0: all the cores)
+ * - UINT_TEST_SEED: seed of the operands (default: a fixed one, printed)
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// Includes
+#include "uint256.h"
+#include "uint128.h"
+
+#define DEFAULT_ITERATIONS 10000
+#define DEFAULT_SEED       0x5eed
+#define MAX_THREADS        256
+
+// Longest string: 256 binary digits, a sign and the NUL terminator
+#define STR_LENGTH (256 + 2)
+
+#define LIMBS 8
+
+// Reference 256-bit integer, least significant limb first
+typedef struct {
+    uint32_t w[LIMBS];
+} s_ref256;
+
+__extension__ typedef unsigned __int128 u128;
+
+typedef struct {
+    uint64_t seed;
+    uint64_t first;   // index of the first iteration of this worker
+    uint64_t stride;  // number of workers
+    uint64_t iterations;
+    bool failed;
+    char what[64];
+    uint8_t a[32];
+    uint8_t b[32];
+    uint32_t param;  // shift, base or length
+} s_worker;
+
+typedef void (*f_kernel)(s_worker *worker, uint64_t *state);
+
+// =============================================================================
+// Syscall emulation
+// =============================================================================
+
+// mul256 relies on this syscall, big-endian operands of len bytes and a result of 2 * len bytes
+uint32_t __wrap_cx_math_mult_no_throw(uint8_t *r, const uint8_t *a, const uint8_t *b, size_t len) {
+    uint32_t acc[64] = {0};
+
+    for (size_t i = 0; i < len; ++i) {
+        for (size_t j = 0; j < len; ++j) {
+            acc[(len - 1 - i) + (len - 1 - j)] += a[i] * b[j];
+        }
+    }
+    for (size_t k = 0; k < (2 * len) - 1; ++k) {
+        acc[k + 1] += acc[k] >> 8;
+        acc[k] &= 0xff;
+    }
+    for (size_t k = 0; k < 2 * len; ++k) {
+        r[(2 * len) - 1 - k] = acc[k];
+    }
+    return 0;  // CX_OK
+}
+
+// =============================================================================
+// Reference implementation
+// =============================================================================
+
+static void ref_from_bytes(const uint8_t *bytes, size_t size, s_ref256 *r) {
+    memset(r, 0, sizeof(*r));
+    for (size_t i = 0; i < size; ++i) {
+        r->w[i / 4] |= (uint32_t) bytes[size - 1 - i] << (8 * (i % 4));
+    }
+}
+
+static void ref_from256(const uint256_t *number, s_ref256 *r) {
+    uint64_t word;
+
+    for (int i = 0; i < 4; ++i) {
+        word = number->elements[1 - (i / 2)].elements[1 - (i % 2)];
+        r->w[2 * i] = (uint32_t) word;
+        r->w[(2 * i) + 1] = (uint32_t) (word >> 32);
+    }
+}
+
+static bool ref_equal(const s_ref256 *a, const s_ref256 *b) {
+    return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+static int ref_cmp(const s_ref256 *a, const s_ref256 *b) {
+    for (int i = LIMBS - 1; i >= 0; --i) {
+        if (a->w[i] != b->w[i]) {
+            return (a->w[i] > b->w[i]) ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+static bool ref_zero(const s_ref256 *a) {
+    for (int i = 0; i < LIMBS; ++i) {
+        if (a->w[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the carry
+static uint32_t ref_add(const s_ref256 *a, const s_ref256 *b, s_ref256 *r) {
+    uint64_t carry = 0;
+
+    for (int i = 0; i < LIMBS; ++i) {
+        carry += (uint64_t) a->w[i] + b->w[i];
+        r->w[i] = (uint32_t) carry;
+        carry >>= 32;
+    }
+    return carry;
+}
+
+static void ref_sub(const s_ref256 *a, const s_ref256 *b, s_ref256 *r) {
+    int64_t borrow = 0;
+
+    for (int i = 0; i < LIMBS; ++i) {
+        borrow += (int64_t) a->w[i] - b->w[i];
+        r->w[i] = (uint32_t) borrow;
+        borrow = (borrow < 0) ? -1 : 0;
+    }
+}
+
+// Full 512-bit product
+static void ref_mul(const s_ref256 *a, const s_ref256 *b, uint32_t r[2 * LIMBS]) {
+    uint64_t carry;
+
+    memset(r, 0, 2 * LIMBS * sizeof(*r));
+    for (int i = 0; i < LIMBS; ++i) {
+        carry = 0;
+        for (int j = 0; j < LIMBS; ++j) {
+            carry += ((uint64_t) a->w[i] * b->w[j]) + r[i + j];
+            r[i + j] = (uint32_t) carry;
+            carry >>= 32;
+        }
+        r[i + LIMBS] = carry;
+    }
+}
+
+static void ref_shl(const s_ref256 *a, uint32_t n, s_ref256 *r) {
+    s_ref256 tmp = {0};
+
+    for (int i = LIMBS - 1; (n < 256) && (i >= (int) (n / 32)); --i) {
+        tmp.w[i] = a->w[i - (n / 32)] << (n % 32);
+        if (((n % 32) != 0) && (i > (int) (n / 32))) {
+            tmp.w[i] |= a->w[i - (n / 32) - 1] >> (32 - (n % 32));
+        }
+    }
+    *r = tmp;
+}
+
+static void ref_shr(const s_ref256 *a, uint32_t n, s_ref256 *r) {
+    s_ref256 tmp = {0};
+
+    for (int i = 0; (n < 256) && (i < LIMBS - (int) (n / 32)); ++i) {
+        tmp.w[i] = a->w[i + (n / 32)] >> (n % 32);
+        if (((n % 32) != 0) && ((i + (n / 32) + 1) < LIMBS)) {
+            tmp.w[i] |= a->w[i + (n / 32) + 1] << (32 - (n % 32));
+        }
+    }
+    *r = tmp;
+}
+
+static uint32_t ref_bits(const s_ref256 *a) {
+    for (int i = LIMBS - 1; i >= 0; --i) {
+        if (a->w[i] != 0) {
+            return (32 * i) + (32 - __builtin_clz(a->w[i]));
+        }
+    }
+    return 0;
+}
+
+// Short division by a single limb, returns the remainder
+static uint32_t ref_divmod_small(s_ref256 *a, uint32_t divisor) {
+    uint64_t rem = 0;
+
+    for (int i = LIMBS - 1; i >= 0; --i) {
+        rem = (rem << 32) | a->w[i];
+        a->w[i] = rem / divisor;
+        rem %= divisor;
+    }
+    return rem;
+}
+
+static void ref_tostring(const s_ref256 *a, uint32_t base, char *out) {
+    s_ref256 tmp = *a;
+    size_t len = 0;
+
+    do {
+        out[len++] = "0123456789abcdef"[ref_divmod_small(&tmp, base)];
+    } while (!ref_zero(&tmp));
+    out[len] = '\0';
+    for (size_t i = 0; i < len / 2; ++i) {
+        char c = out[i];
+        out[i] = out[len - 1 - i];
+        out[len - 1 - i] = c;
+    }
+}
+
+static void ref_tostring128(u128 a, uint32_t base, char *out) {
+    size_t len = 0;
+
+    do {
+        out[len++] = "0123456789abcdef"[a % base];
+        a /= base;
+    } while (a != 0);
+    out[len] = '\0';
+    for (size_t i = 0; i < len / 2; ++i) {
+        char c = out[i];
+        out[i] = out[len - 1 - i];
+        out[len - 1 - i] = c;
+    }
+}
+
+static uint32_t ref_bits128(u128 a) {
+    if ((a >> 64) != 0) {
+        return 128 - __builtin_clzll(a >> 64);
+    }
+    return (a != 0) ? (64 - __builtin_clzll(a)) : 0;
+}
+
+static u128 ref_from128(const uint128_t *number) {
+    return ((u128) number->elements[0] << 64) | number->elements[1];
+}
+
+static u128 ref128_from_bytes(const uint8_t *bytes) {
+    u128 r = 0;
+
+    for (int i = 0; i < 16; ++i) {
+        r = (r << 8) | bytes[i];
+    }
+    return r;
+}
+
+// =============================================================================
+// Operands
+// =============================================================================
+
+static uint64_t rand64(uint64_t *state) {
+    // splitmix64
+    uint64_t z = (*state += 0x9e3779b97f4a7c15);
+
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Random big-endian operand, one time out of two an edge case
+ */
+static void rand_operand(uint64_t *state, uint8_t *out, size_t size) {
+    uint64_t kind = rand64(state) % 8;
+    uint32_t bit = rand64(state) % (size * 8);
+    size_t len;
+
+    memset(out, 0, size);
+    switch (kind) {
+        case 0:
+            break;
+        case 1:
+            memset(out, 0xff, size);
+            break;
+        case 2:  // 2^bit
+            out[size - 1 - (bit / 8)] = 1 << (bit % 8);
+            break;
+        case 3:  // 2^bit - 1
+            memset(&out[size - (bit / 8)], 0xff, bit / 8);
+            out[size - 1 - (bit / 8)] = (1 << (bit % 8)) - 1;
+            break;
+        default:  // random, with random leading zeros
+            len = (kind == 4) ? (rand64(state) % (size + 1)) : size;
+            for (size_t i = size - len; i < size; ++i) {
+                out[i] = rand64(state);
+            }
+            break;
+    }
+}
+
+static void record_failure(s_worker *worker,
+                           const char *what,
+                           const uint8_t *a,
+                           const uint8_t *b,
+                           uint32_t n) {
+    if (!worker->failed) {
+        worker->failed = true;
+        snprintf(worker->what, sizeof(worker->what), "%s", what);
+        memcpy(worker->a, a, sizeof(worker->a));
+        memcpy(worker->b, b, sizeof(worker->b));
+        worker->param = n;
+    }
+}
+
+// =============================================================================
+// Kernels
+// =============================================================================
+
+static void check_uint256(s_worker *worker, uint64_t *state) {
+    uint8_t a_bytes[32];
+    uint8_t b_bytes[32];
+    uint256_t a, b, r, q, m;
+    s_ref256 ra, rb, rr, rq, rm, expected;
+    uint32_t product[2 * LIMBS];
+    char out[STR_LENGTH];
+    char ref_out[STR_LENGTH];
+    uint32_t n;
+    uint32_t base;
+    size_t len;
+    int cmp;
+
+    rand_operand(state, a_bytes, sizeof(a_bytes));
+    rand_operand(state, b_bytes, sizeof(b_bytes));
+    n = rand64(state) % 300;
+    base = 2 + (rand64(state) % 15);
+    readu256BE(a_bytes, &a);
+    readu256BE(b_bytes, &b);
+    ref_from_bytes(a_bytes, sizeof(a_bytes), &ra);
+    ref_from_bytes(b_bytes, sizeof(b_bytes), &rb);
+
+    ref_from256(&a, &rr);
+    if (!ref_equal(&rr, &ra)) {
+        record_failure(worker, "readu256BE", a_bytes, b_bytes, n);
+    }
+    len = 1 + (rand64(state) % sizeof(a_bytes));
+    convertUint256BE(&a_bytes[sizeof(a_bytes) - len], len, &r);
+    ref_from_bytes(&a_bytes[sizeof(a_bytes) - len], len, &expected);
+    ref_from256(&r, &rr);
+    if (!ref_equal(&rr, &expected)) {
+        record_failure(worker, "convertUint256BE", a_bytes, b_bytes, len);
+    }
+
+    add256(&a, &b, &r);
+    ref_add(&ra, &rb, &expected);
+    ref_from256(&r, &rr);
+    if (!ref_equal(&rr, &expected)) {
+        record_failure(worker, "add256", a_bytes, b_bytes, n);
+    }
+
+    sub256(&a, &b, &r);
+    ref_sub(&ra, &rb, &expected);
+    ref_from256(&r, &rr);
+    if (!ref_equal(&rr, &expected)) {
+        record_failure(worker, "sub256", a_bytes, b_bytes, n);
+    }
+
+    if (!mul256(&a, &b, &r)) {
+        record_failure(worker, "mul256 failed", a_bytes, b_bytes, n);
+    }
+    ref_mul(&ra, &rb, product);
+    memcpy(expected.w, product, sizeof(expected.w));
+    ref_from256(&r, &rr);
+    if (!ref_equal(&rr, &expected)) {
+        record_failure(worker, "mul256", a_bytes, b_bytes, n);
+    }
+
+    shiftl256(&a, n, &r);
+    ref_shl(&ra, n, &expected);
+    ref_from256(&r, &rr);
+    if (!ref_equal(&rr, &expected)) {
+        record_failure(worker, "shiftl256", a_bytes, b_bytes, n);
+    }
+
+    shiftr256(&a, n, &r);
+    ref_shr(&ra, n, &expected);
+    ref_from256(&r, &rr);
+    if (!ref_equal(&rr, &expected)) {
+        record_failure(worker, "shiftr256", a_bytes, b_bytes, n);
+    }
+
+    if (bits256(&a) != ref_bits(&ra)) {
+        record_failure(worker, "bits256", a_bytes, b_bytes, n);
+    }
+
+    cmp = ref_cmp(&ra, &rb);
+    if ((equal256(&a, &b) != (cmp == 0)) || (gt256(&a, &b) != (cmp > 0)) ||
+        (gte256(&a, &b) != (cmp >= 0)) || (zero256(&a) != ref_zero(&ra))) {
+        record_failure(worker, "comparisons", a_bytes, b_bytes, n);
+    }
+
+    if (!zero256(&b)) {
+        // a == q * b + m, without overflow, and m < b
+        divmod256(&a, &b, &q, &m);
+        ref_from256(&q, &rq);
+        ref_from256(&m, &rm);
+        ref_mul(&rq, &rb, product);
+        memcpy(expected.w, product, sizeof(expected.w));
+        for (int i = LIMBS; i < 2 * LIMBS; ++i) {
+            if (product[i] != 0) {
+                record_failure(worker, "divmod256 quotient", a_bytes, b_bytes, n);
+            }
+        }
+        if ((ref_add(&expected, &rm, &expected) != 0) || !ref_equal(&expected, &ra) ||
+            (ref_cmp(&rm, &rb) >= 0)) {
+            record_failure(worker, "divmod256", a_bytes, b_bytes, n);
+        }
+    }
+
+    ref_tostring(&ra, base, ref_out);
+    if (!tostring256(&a, base, out, sizeof(out)) || (strcmp(out, ref_out) != 0)) {
+        record_failure(worker, "tostring256", a_bytes, b_bytes, base);
+    }
+    // room for the digits but not the terminator
+    if (tostring256(&a, base, out, strlen(ref_out))) {
+        record_failure(worker, "tostring256 too small", a_bytes, b_bytes, base);
+    }
+
+    if ((ra.w[LIMBS - 1] >> 31) != 0) {
+        s_ref256 zero = {0};
+
+        ref_out[0] = '-';
+        ref_sub(&zero, &ra, &expected);
+        ref_tostring(&expected, 10, &ref_out[1]);
+    } else {
+        ref_tostring(&ra, 10, ref_out);
+    }
+    if (!tostring256_signed(&a, 10, out, sizeof(out)) || (strcmp(out, ref_out) != 0)) {
+        record_failure(worker, "tostring256_signed", a_bytes, b_bytes, 10);
+    }
+}
+
+static void check_uint128(s_worker *worker, uint64_t *state) {
+    uint8_t a_bytes[32] = {0};
+    uint8_t b_bytes[32] = {0};
+    uint128_t a, b, r, q, m;
+    u128 ra, rb;
+    char out[STR_LENGTH];
+    char ref_out[STR_LENGTH];
+    uint32_t n;
+    uint32_t base;
+    size_t len;
+
+    // the operands are kept in the last 16 bytes, for the failure report
+    rand_operand(state, &a_bytes[16], 16);
+    rand_operand(state, &b_bytes[16], 16);
+    n = rand64(state) % 150;
+    base = 2 + (rand64(state) % 15);
+    readu128BE(&a_bytes[16], &a);
+    readu128BE(&b_bytes[16], &b);
+    ra = ref128_from_bytes(&a_bytes[16]);
+    rb = ref128_from_bytes(&b_bytes[16]);
+
+    if (ref_from128(&a) != ra) {
+        record_failure(worker, "readu128BE", a_bytes, b_bytes, n);
+    }
+    len = 1 + (rand64(state) % 16);
+    convertUint128BE(&a_bytes[32 - len], len, &r);
+    if (ref_from128(&r) != ((len == 16) ? ra : (ra & (((u128) 1 << (8 * len)) - 1)))) {
+        record_failure(worker, "convertUint128BE", a_bytes, b_bytes, len);
+    }
+
+    add128(&a, &b, &r);
+    if (ref_from128(&r) != (u128) (ra + rb)) {
+        record_failure(worker, "add128", a_bytes, b_bytes, n);
+    }
+    sub128(&a, &b, &r);
+    if (ref_from128(&r) != (u128) (ra - rb)) {
+        record_failure(worker, "sub128", a_bytes, b_bytes, n);
+    }
+    mul128(&a, &b, &r);
+    if (ref_from128(&r) != (u128) (ra * rb)) {
+        record_failure(worker, "mul128", a_bytes, b_bytes, n);
+    }
+    shiftl128(&a, n, &r);
+    if (ref_from128(&r) != ((n < 128) ? (u128) (ra << n) : 0)) {
+        record_failure(worker, "shiftl128", a_bytes, b_bytes, n);
+    }
+    shiftr128(&a, n, &r);
+    if (ref_from128(&r) != ((n < 128) ? (ra >> n) : 0)) {
+        record_failure(worker, "shiftr128", a_bytes, b_bytes, n);
+    }
+    if (bits128(&a) != ref_bits128(ra)) {
+        record_failure(worker, "bits128", a_bytes, b_bytes, n);
+    }
+    if ((equal128(&a, &b) != (ra == rb)) || (gt128(&a, &b) != (ra > rb)) ||
+        (gte128(&a, &b) != (ra >= rb)) || (zero128(&a) != (ra == 0))) {
+        record_failure(worker, "comparisons", a_bytes, b_bytes, n);
+    }
+    if (rb != 0) {
+        divmod128(&a, &b, &q, &m);
+        if ((ref_from128(&q) != (ra / rb)) || (ref_from128(&m) != (ra % rb))) {
+            record_failure(worker, "divmod128", a_bytes, b_bytes, n);
+        }
+    }
+
+    ref_tostring128(ra, base, ref_out);
+    if (!tostring128(&a, base, out, sizeof(out)) || (strcmp(out, ref_out) != 0)) {
+        record_failure(worker, "tostring128", a_bytes, b_bytes, base);
+    }
+    if (tostring128(&a, base, out, strlen(ref_out))) {
+        record_failure(worker, "tostring128 too small", a_bytes, b_bytes, base);
+    }
+
+    if ((ra >> 127) != 0) {
+        ref_out[0] = '-';
+        ref_tostring128(-ra, 10, &ref_out[1]);
+    } else {
+        ref_tostring128(ra, 10, ref_out);
+    }
+    if (!tostring128_signed(&a, 10, out, sizeof(out)) || (strcmp(out, ref_out) != 0)) {
+        record_failure(worker, "tostring128_signed", a_bytes, b_bytes, 10);
+    }
+}
+
+// =============================================================================
+// Runner
+// =============================================================================
+
+static f_kernel g_kernel;
+
+static uint64_t get_env(const char *name, uint64_t default_value) {
+    const char *value = getenv(name);
+
+    return (value != NULL) ? strtoull(value, NULL, 0) : default_value;
+}
+
+static void *worker_main(void *arg) {
+    s_worker *worker = arg;
+    uint64_t state;
+
+    // each iteration has its own stream, so that a seed gives the same operands on any core count
+    for (uint64_t i = worker->first; (i < worker->iterations) && !worker->failed;
+         i += worker->stride) {
+        state = worker->seed + (i * 0x100000000);
+        g_kernel(worker, &state);
+    }
+    return NULL;
+}
+
+static void print_hex(const char *name, const uint8_t *bytes, size_t size) {
+    fprintf(stderr, "  %s = 0x", name);
+    for (size_t i = 0; i < size; ++i) {
+        fprintf(stderr, "%02x", bytes[i]);
+    }
+    fprintf(stderr, "\n");
+}
+
+/**
+ * @brief Run a kernel on all the threads, the failures are checked once they are all done
+ */
+static void run_differential(f_kernel kernel) {
+    static s_worker workers[MAX_THREADS];
+    pthread_t threads[MAX_THREADS];
+    uint64_t iterations = get_env("UINT_TEST_ITERATIONS", DEFAULT_ITERATIONS);
+    uint64_t threads_count = get_env("UINT_TEST_THREADS", 0);
+    uint64_t seed = get_env("UINT_TEST_SEED", DEFAULT_SEED);
+    long cores;
+
+    if (threads_count == 0) {
+        cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads_count = (cores > 0) ? (uint64_t) cores : 1;
+    }
+    if (threads_count > MAX_THREADS) {
+        threads_count = MAX_THREADS;
+    }
+    printf("seed %lu, %lu iterations on %lu threads\n",
+           (unsigned long) seed,
+           (unsigned long) iterations,
+           (unsigned long) threads_count);
+    g_kernel = kernel;
+    for (uint64_t t = 0; t < threads_count; ++t) {
+        memset(&workers[t], 0, sizeof(workers[t]));
+        workers[t].seed = seed;
+        workers[t].first = t;
+        workers[t].stride = threads_count;
+        workers[t].iterations = iterations;
+        assert_int_equal(pthread_create(&threads[t], NULL, &worker_main, &workers[t]), 0);
+    }
+    for (uint64_t t = 0; t < threads_count; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+    for (uint64_t t = 0; t < threads_count; ++t) {
+        if (workers[t].failed) {
+            fprintf(stderr, "%s mismatch (param %u):\n", workers[t].what, workers[t].param);
+            print_hex("a", workers[t].a, sizeof(workers[t].a));
+            print_hex("b", workers[t].b, sizeof(workers[t].b));
+            fail();
+        }
+    }
+}
+
+// =============================================================================
+// Tests
+// =============================================================================
+
+static void test_known_values(void **state) {
+    (void) state;
+    uint8_t max[32];
+    uint256_t number;
+    char out[STR_LENGTH];
+
+    memset(max, 0xff, sizeof(max));
+    readu256BE(max, &number);
+    assert_true(tostring256(&number, 10, out, sizeof(out)));
+    assert_string_equal(
+        out,
+        "115792089237316195423570985008687907853269984665640564039457584007913129639935");
+    assert_true(tostring256_signed(&number, 10, out, sizeof(out)));
+    assert_string_equal(out, "-1");
+    assert_false(tostring256(&number, 1, out, sizeof(out)));
+    assert_false(tostring256(&number, 17, out, sizeof(out)));
+}
+
+static void test_uint128_differential(void **state) {
+    (void) state;
+    run_differential(&check_uint128);
+}
+
+static void test_uint256_differential(void **state) {
+    (void) state;
+    run_differential(&check_uint256);
+}
+
+// =============================================================================
+// Test runner
+// =============================================================================
+
+int main(void) {
+    const struct CMUnitTest tests[] = {
+        cmocka_unit_test(test_known_values),
+        cmocka_unit_test(test_uint128_differential),
+        cmocka_unit_test(test_uint256_differential),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
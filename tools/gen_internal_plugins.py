@@ -0,0 +1,236 @@
+#!/usr/bin/env python3
+
+import os
+import sys
+import json
+import argparse
+from typing import Callable, Optional
+
+PLUGINS_FILE = "src/plugins/internal_plugins.json"
+# deterministic seed for the multiplicative hashes search
+HASH_SEED = 0x9e3779b1
+MAX_TRIES = 4096
+
+
+class Plugin:
+    priority: int
+    alias: str
+    impl: str
+    header: str
+    guard: Optional[str]
+    selectors: list[bytes]
+    addresses: list[bytes]
+
+    def __init__(self, priority: int, desc: dict):
+        self.priority = priority
+        self.alias = desc["alias"]
+        self.impl = desc["impl"]
+        self.header = desc["header"]
+        self.guard = desc.get("guard")
+        self.selectors = [bytes.fromhex(s) for s in desc.get("selectors", [])]
+        self.addresses = [bytes.fromhex(a) for a in desc.get("addresses", [])]
+        assert len(self.alias) < 10, "alias too long: %s" % (self.alias)
+        assert all(len(s) == 4 for s in self.selectors), "bad selector for %s" % (self.alias)
+        assert all(len(a) == 20 for a in self.addresses), "bad address for %s" % (self.alias)
+        assert self.selectors or self.addresses, "%s would match everything" % (self.alias)
+        # a selector entry can only be restricted to a single contract address
+        assert not self.selectors or len(self.addresses) <= 1, \
+            "%s has selectors and several addresses" % (self.alias)
+
+    def var_name(self) -> str:
+        return "PLUGIN_%s" % (self.alias.lstrip("-").upper())
+
+    def selectors_name(self) -> str:
+        return "g_%s_selectors" % (self.alias.lstrip("-"))
+
+    def selectors_count_name(self) -> str:
+        return "%s_SELECTORS_COUNT" % (self.var_name())
+
+    def selector_index_name(self, selector: bytes) -> str:
+        return "%s_SELECTOR_IDX_%s" % (self.var_name(), selector.hex().upper())
+
+
+class Entry:
+    key: int
+    plugin: Plugin
+    selector: Optional[bytes]
+    address: Optional[bytes]
+
+    def __init__(self, plugin: Plugin, selector: Optional[bytes], address: Optional[bytes]):
+        self.plugin = plugin
+        self.selector = selector
+        self.address = address
+        if selector is not None:
+            self.key = int.from_bytes(selector, "big")
+        else:
+            # last 4 bytes, the first ones of the system contracts are mostly zeroes
+            self.key = int.from_bytes(address[16:], "big")
+
+
+def get_header() -> str:
+    return """\
+/*
+ * Generated by %s
+ */
+
+""" % (sys.argv[0])
+
+
+def get_slot(key: int, mult: int, bits: int) -> int:
+    return ((key * mult) & 0xffffffff) >> (32 - bits)
+
+
+def find_perfect_hash(entries: list[Entry]) -> tuple[int, int]:
+    keys = [e.key for e in entries]
+    assert len(set(keys)) == len(keys), "duplicate hash key"
+    bits = 1
+    while (1 << bits) < len(keys):
+        bits += 1
+    while True:
+        mult = HASH_SEED
+        for _ in range(MAX_TRIES):
+            if len(set(get_slot(k, mult, bits) for k in keys)) == len(keys):
+                return mult, bits
+            mult = ((mult + 0x6a09e668) & 0xffffffff) | 1
+        bits += 1
+
+
+def c_bytes(data: bytes) -> str:
+    return "{%s}" % (", ".join("0x%02x" % (b) for b in data))
+
+
+def guarded(plugin: Plugin, line: str) -> str:
+    if plugin.guard is None:
+        return line
+    return "#ifdef %s\n%s\n#endif" % (plugin.guard, line)
+
+
+def gen_inc(plugins: list[Plugin],
+            sel_hash: tuple[int, int],
+            addr_hash: tuple[int, int],
+            path: str) -> bool:
+    with open(path + ".h", "w") as out:
+        print(get_header() + """\
+#ifndef INTERNAL_PLUGINS_GENERATED_H_
+#define INTERNAL_PLUGINS_GENERATED_H_
+
+#include "eth_plugin_internal.h"
+
+#define INTERNAL_PLUGIN_SELECTORS_MULT 0x%08xU
+#define INTERNAL_PLUGIN_SELECTORS_BITS %u
+#define INTERNAL_PLUGIN_ADDRESSES_MULT 0x%08xU
+#define INTERNAL_PLUGIN_ADDRESSES_BITS %u
+
+extern const internalPluginSelector_t g_internal_plugin_selectors[%u];
+extern const internalPluginAddress_t g_internal_plugin_addresses[%u];
+""" % (sel_hash[0], sel_hash[1], addr_hash[0], addr_hash[1],
+       1 << sel_hash[1], 1 << addr_hash[1]), file=out)
+        # selectors of each plugin, in their declaration order
+        for plugin in plugins:
+            if not plugin.selectors:
+                continue
+            lines = "#define %s %u\n" % (plugin.selectors_count_name(), len(plugin.selectors))
+            # index of each selector, for the plugin to tell them apart whatever their order
+            for idx, selector in enumerate(plugin.selectors):
+                lines += "#define %s %u\n" % (plugin.selector_index_name(selector), idx)
+            lines += "extern const uint8_t %s[%s][SELECTOR_SIZE];" % (plugin.selectors_name(),
+                                                                      plugin.selectors_count_name())
+            print(guarded(plugin, lines), file=out)
+        print("\n#endif // INTERNAL_PLUGINS_GENERATED_H_", file=out)
+    return True
+
+
+def gen_table(out, name: str, entries: list[Entry], hash_params: tuple[int, int],
+              entry_fmt: Callable[[Entry], str]):
+    mult, bits = hash_params
+    print("\nconst %s[%u] = {" % (name, 1 << bits), file=out)
+    for entry in sorted(entries, key=lambda e: get_slot(e.key, mult, bits)):
+        line = "    [%u] = %s," % (get_slot(entry.key, mult, bits), entry_fmt(entry))
+        print(guarded(entry.plugin, line), file=out)
+    print("};", file=out)
+
+
+def selector_entry(entry: Entry) -> str:
+    fields = [".selector = %s" % (c_bytes(entry.selector))]
+    if entry.address is not None:
+        fields.append(".has_address = true")
+        fields.append(".address = %s" % (c_bytes(entry.address)))
+    fields.append(".plugin = &%s" % (entry.plugin.var_name()))
+    return "{%s}" % (", ".join(fields))
+
+
+def address_entry(entry: Entry) -> str:
+    return "{.address = %s, .plugin = &%s}" % (c_bytes(entry.address), entry.plugin.var_name())
+
+
+def gen_src(plugins: list[Plugin],
+            sel_entries: list[Entry],
+            sel_hash: tuple[int, int],
+            addr_entries: list[Entry],
+            addr_hash: tuple[int, int],
+            path: str) -> bool:
+    with open(path + ".c", "w") as out:
+        print(get_header() + "#include <stdbool.h>", file=out)
+        print("#include \"%s.h\"" % (os.path.basename(path)), file=out)
+        for plugin in plugins:
+            print("#include \"%s\"" % (plugin.header), file=out)
+        print("", file=out)
+        for plugin in plugins:
+            line = "static const internalEthPlugin_t %s = {%s};" % (
+                plugin.var_name(),
+                ".priority = %u, .alias = \"%s\", .impl = %s" % (plugin.priority,
+                                                                  plugin.alias,
+                                                                  plugin.impl))
+            print(guarded(plugin, line), file=out)
+        for plugin in plugins:
+            if not plugin.selectors:
+                continue
+            line = "const uint8_t %s[%s][SELECTOR_SIZE] = {%s};" % (
+                plugin.selectors_name(),
+                plugin.selectors_count_name(),
+                ", ".join(c_bytes(s) for s in plugin.selectors))
+            print(guarded(plugin, line), file=out)
+        gen_table(out,
+                  "internalPluginSelector_t g_internal_plugin_selectors",
+                  sel_entries,
+                  sel_hash,
+                  selector_entry)
+        gen_table(out,
+                  "internalPluginAddress_t g_internal_plugin_addresses",
+                  addr_entries,
+                  addr_hash,
+                  address_entry)
+    return True
+
+
+def main(output_dir: str) -> bool:
+    sel_entries: list[Entry] = list()
+    addr_entries: list[Entry] = list()
+
+    with open(PLUGINS_FILE) as f:
+        plugins = [Plugin(idx, desc) for idx, desc in enumerate(json.load(f))]
+
+    for plugin in plugins:
+        if plugin.selectors:
+            address = plugin.addresses[0] if plugin.addresses else None
+            sel_entries += [Entry(plugin, selector, address) for selector in plugin.selectors]
+        else:
+            addr_entries += [Entry(plugin, None, address) for address in plugin.addresses]
+
+    sel_hash = find_perfect_hash(sel_entries)
+    addr_hash = find_perfect_hash(addr_entries)
+    path = output_dir + "/internal_plugins.gen"
+    if not gen_inc(plugins, sel_hash, addr_hash, path) or \
+       not gen_src(plugins, sel_entries, sel_hash, addr_entries, addr_hash, path):
+        return False
+    return True
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("OUTPUT_DIR")
+    args = parser.parse_args()
+    # also created by the SDK, but just in case this script is called too soon
+    os.makedirs(args.OUTPUT_DIR, exist_ok=True)
+    assert os.path.isdir(args.OUTPUT_DIR)
+    quit(0 if main(args.OUTPUT_DIR) else 1)